@@ -0,0 +1,64 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ *
+ *
+ * Converts xml graph files to the binary graph format.
+ *
+ * For every graph file given on the command line a file with the same name
+ * and a ".bin" suffix is written next to it. Graph::load maps that file
+ * instead of parsing the xml as long as it is not older than the xml file.
+ *
+ * Usage of graphconvert:
+ *
+ *  ./waf --run "graphconvert data/cologne-center-graph.xml data/cologne-center-subgraphs-lfs-3-80/g1.xml"
+ */
+
+#include <iostream>
+
+#include "ns3/core-module.h"
+#include "ns3/urbanuavmobility-module.h"
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  if (argc < 2)
+  {
+      std::cout << "Usage of " << argv[0] << " :\n\n"
+      "./waf --run \"graphconvert graph1.xml [graph2.xml ...]\"\n\n";
+
+      return 0;
+  }
+
+  int failed = 0;
+  for (int i = 1; i < argc; i++)
+  {
+      if (Graph::convert (argv[i]))
+      {
+          std::cout << argv[i] << " -> " << Graph::getBinaryFile (argv[i]) << std::endl;
+      }
+      else
+      {
+          std::cout << argv[i] << ": conversion failed" << std::endl;
+          failed++;
+      }
+  }
+
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ *
+ *
+ * Cuts a graph into balanced, connected territories with GraphPartitioner
+ * and writes one subgraph per territory (g0.xml .. g<k-1>.xml), a fleet
+ * file with one team per territory and the partition metrics into the
+ * output directory, which is created if needed. The fleet file names the
+ * subgraphs relative to itself, so the directory can be moved as a whole.
+ *
+ * Usage of graphpartition:
+ *
+ *  ./waf --run "graphpartition --graph=data/cologne-center-graph.xml --territories=80
+ *        --output=data/cologne-center-subgraphs-80 --speed=10 --pause=2 --imbalance=0.03
+ *        --trials=8 --threads=8 --binary=true"
+ */
+
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "ns3/core-module.h"
+#include "ns3/urbanuavmobility-module.h"
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string graph;
+  std::string output;
+  int territories = 0;
+  double speed = 10;
+  double pause = GraphMobilityModel::PAUSE_TIME;
+  double imbalance = 0.03;
+  int trials = 8;
+  int threads = 0;
+  int seed = 0;
+  bool binary = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("graph", "Graph file to partition", graph);
+  cmd.AddValue ("territories", "Number of territories", territories);
+  cmd.AddValue ("output", "Directory of the subgraphs, fleet and metrics files", output);
+  cmd.AddValue ("speed", "UAV speed in m/s", speed);
+  cmd.AddValue ("pause", "Pause at every node in seconds", pause);
+  cmd.AddValue ("imbalance", "Allowed excess of a territory over the average, 0.03 for 3%", imbalance);
+  cmd.AddValue ("trials", "Number of partitions tried, the best is kept", trials);
+  cmd.AddValue ("threads", "Number of threads, 0 for one per core", threads);
+  cmd.AddValue ("seed", "First random stream of the trials", seed);
+  cmd.AddValue ("binary", "Also write the subgraphs in the binary graph format", binary);
+  cmd.Parse (argc,argv);
+
+  if (graph.empty () || output.empty () || territories <= 0 || speed <= 0 || trials <= 0)
+  {
+      std::cout << "Usage of " << argv[0] << " :\n\n"
+      "./waf --run \"graphpartition --graph=data/cologne-center-graph.xml --territories=80"
+      " --output=data/cologne-center-subgraphs-80\"\n\n";
+
+      return 0;
+  }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Ptr<GraphData> data = GraphData::load (graph);
+  if (data == 0)
+  {
+      std::cout << graph << ": not loaded" << std::endl;
+      return 1;
+  }
+  int64_t loadTime = clock.End ();
+
+  GraphPartitioner partitioner (data, speed, pause);
+  partitioner.setImbalance (imbalance);
+  partitioner.setTrials (trials);
+  partitioner.assignStreams (seed);
+  if (threads > 0)
+  {
+      partitioner.setThreads (threads);
+  }
+
+  if (!partitioner.partition (territories))
+  {
+      std::cout << graph << ": cannot be cut into " << territories << " territories" << std::endl;
+      return 1;
+  }
+
+  mkdir (output.c_str (), 0755);
+  if (!partitioner.write (output, binary))
+  {
+      std::cout << output << ": write failed" << std::endl;
+      return 1;
+  }
+
+  std::cout << "graph load:" << loadTime << "ms;" << partitioner.getMetrics () << std::endl;
+  return 0;
+}
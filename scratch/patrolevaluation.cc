@@ -0,0 +1,175 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ *
+ *
+ * Compares selection strategies on one or more graphs without running the
+ * simulator. Every graph is patrolled once per strategy and seed, and the
+ * runs of one seed use the same random stream for every strategy.
+ *
+ * Usage of patrolevaluation:
+ *
+ *  ./waf --run "patrolevaluation --graphs=g1.xml,g2.xml --strategies=random,leastvisited
+ *        --seeds=10 --duration=3600 --speed=10 --pause=2 --threads=8"
+ *
+ * Every run prints one line: graph;strategy;seed;Graph::stats()
+ *
+ * With --estimate=true the patrols are not walked: IdlenessEstimator
+ * predicts their idleness instead, which screens a whole partition in
+ * milliseconds. Seeds do not apply, and every graph and strategy prints
+ * graph;strategy;average idleness:..;worst idleness:..;iterations:..;time:..
+ * The worst idleness of a least visited patrol is --rounds rounds of all
+ * streets, 4.5 by default.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/urbanuavmobility-module.h"
+
+using namespace ns3;
+
+std::vector<std::string> split (std::string values)
+{
+  std::vector<std::string> result;
+  std::stringstream stream (values);
+  std::string value;
+  while (std::getline (stream, value, ','))
+    {
+      if (!value.empty ())
+        {
+          result.push_back (value);
+        }
+    }
+  return result;
+}
+
+int main (int argc, char *argv[])
+{
+  std::string graphs;
+  std::string strategies = "random,leastvisited";
+  int seeds = 1;
+  double duration = 3600;
+  double speed = 10;
+  double pause = GraphMobilityModel::PAUSE_TIME;
+  int threads = 0;
+  bool estimate = false;
+  double rounds = 4.5;
+
+  CommandLine cmd;
+  cmd.AddValue ("graphs", "Comma separated graph files", graphs);
+  cmd.AddValue ("strategies", "Comma separated selection strategies", strategies);
+  cmd.AddValue ("seeds", "Number of random streams per graph and strategy", seeds);
+  cmd.AddValue ("duration", "Patrol duration in seconds", duration);
+  cmd.AddValue ("speed", "UAV speed in m/s", speed);
+  cmd.AddValue ("pause", "Pause at every node in seconds", pause);
+  cmd.AddValue ("threads", "Number of threads, 0 for one per core", threads);
+  cmd.AddValue ("estimate", "Predict the idleness instead of patrolling", estimate);
+  cmd.AddValue ("rounds", "Worst idleness of least visited patrols in rounds of all streets, with --estimate", rounds);
+  cmd.Parse (argc,argv);
+
+  if (graphs.empty () || seeds <= 0 || duration <= 0 || speed <= 0)
+  {
+      std::cout << "Usage of " << argv[0] << " :\n\n"
+      "./waf --run \"patrolevaluation --graphs=g1.xml,g2.xml --strategies=random,leastvisited"
+      " --seeds=10 --duration=3600 --speed=10 --pause=2\"\n\n";
+
+      return 0;
+  }
+
+  std::vector<std::string> graphFiles = split (graphs);
+  std::vector<std::string> strategyNames = split (strategies);
+
+  if (estimate)
+  {
+      std::vector<IdlenessEstimate> estimates;
+      for (int g = 0; g < (int) graphFiles.size (); g++)
+      {
+          for (int s = 0; s < (int) strategyNames.size (); s++)
+          {
+              IdlenessEstimate next;
+              next.graphFile = graphFiles[g];
+              next.strategy = strategyNames[s];
+              estimates.push_back (next);
+          }
+      }
+
+      IdlenessEstimator estimator (speed, pause, duration);
+      if (threads > 0)
+      {
+          estimator.setThreads (threads);
+      }
+      estimator.setLeastVisitedRounds (rounds);
+
+      SystemWallClockMs clock;
+      clock.Start ();
+      estimator.estimate (estimates);
+      int64_t elapsed = clock.End ();
+
+      for (int i = 0; i < (int) estimates.size (); i++)
+      {
+          std::cout << estimates[i].graphFile << ";" << estimates[i].strategy << ";"
+                    << "average idleness:" << estimates[i].averageIdleness << ";"
+                    << "worst idleness:" << estimates[i].worstIdleness << ";"
+                    << "iterations:" << estimates[i].iterations << ";"
+                    << "time:" << estimates[i].time << ";" << std::endl;
+      }
+      std::cout << estimates.size () << " estimates in " << elapsed << "ms" << std::endl;
+
+      return 0;
+  }
+
+  std::vector<PatrolRun> runs;
+  for (int g = 0; g < (int) graphFiles.size (); g++)
+  {
+      for (int s = 0; s < (int) strategyNames.size (); s++)
+      {
+          for (int seed = 0; seed < seeds; seed++)
+          {
+              PatrolRun run;
+              run.graphFile = graphFiles[g];
+              run.strategy = strategyNames[s];
+              run.stream = seed;
+              runs.push_back (run);
+          }
+      }
+  }
+
+  PatrolEvaluator evaluator (speed, pause, duration);
+  if (threads > 0)
+  {
+      evaluator.setThreads (threads);
+  }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  evaluator.evaluate (runs);
+  int64_t elapsed = clock.End ();
+
+  for (int i = 0; i < (int) runs.size (); i++)
+  {
+      std::cout << runs[i].graphFile << ";" << runs[i].strategy << ";" << runs[i].stream << ";"
+                << runs[i].result << std::endl;
+  }
+  std::cout << runs.size () << " patrols in " << elapsed << "ms" << std::endl;
+
+  return 0;
+}
@@ -141,6 +141,7 @@ int main (int argc, char *argv[])
   Ptr<UavEnergyModel> energyModel = CreateObject<UavEnergyModel>(uav,voltage,capacity);
   Ptr<UavManhattanMobilityModel> mobilityModel = CreateObject<UavManhattanMobilityModel>((char*)graphFile.c_str(),energyModel,speed,"random");
   uav->AggregateObject(mobilityModel);
+  mobilityModel->AssignStreams(0);
 
   Simulator::Stop (Seconds (duration));
 
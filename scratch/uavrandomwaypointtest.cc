@@ -118,7 +118,6 @@ int main (int argc, char *argv[])
 
       return 0;
   }
-  srand(time(NULL));
 
 
   // Create Ns2MobilityHelper with the specified trace log file as parameter
@@ -152,6 +151,7 @@ int main (int argc, char *argv[])
   model->SetAttribute("PositionAllocator",PointerValue(taPositionAlloc));
 
   uav->AggregateObject(model);
+  model->AssignStreams(0);
 
   
   // Configure callback for logging
@@ -123,7 +123,6 @@ int main (int argc, char *argv[])
 
       return 0;
   }
-  srand(time(NULL));
 
   // Create Ns2MobilityHelper with the specified trace log file as parameter
   Ns2MobilityHelper ns2 = Ns2MobilityHelper (traceFile);
@@ -145,6 +144,7 @@ int main (int argc, char *argv[])
   Ptr<UavEnergyModel> energyModel = CreateObject<UavEnergyModel>(uav,voltage,capacity);
   Ptr<UavSrcmMobilityModel> mobilityModel = CreateObject<UavSrcmMobilityModel>((char*)graphFile.c_str(),energyModel,range,speed);
   uav->AggregateObject(mobilityModel);
+  mobilityModel->AssignStreams(0);
 
   Simulator::Stop (Seconds (duration));
 
@@ -67,17 +67,18 @@ struct SimulationProperties {
   double descendSpeed;
   double communicationRange;
   string selectionStrategy;
+  bool sharedVisits;
+  bool routedReturn;
+  string territoryGraph;
+  int lendingDepth;
 };
 
 int checkSimulationArguments(int,char*[],SimulationProperties* properties);
 map<std::string,std::string> parse(std::string);
 void createTraffic(SimulationProperties* properties);
 void createUavs(SimulationProperties* properties);
-void parseFleet(SimulationProperties* properties);
-void parseTeam(xmlNodePtr node,SimulationProperties* properties);
+void createFleet(SimulationProperties* properties);
 Ptr<Channel> getCommunicationChannel(SimulationProperties* properties);
-Ptr<Base> createBase(SimulationProperties* properties,double,double,string,Ptr<Channel>);
-Ptr<Uav> createUav(SimulationProperties* properties,string,string,Ptr<Channel>);
 void createUav(Ptr<Node>,SimulationProperties* properties,string);
 void printResults();
 
@@ -87,7 +88,6 @@ vector<int> uavNums;
 // Example to use ns2 traces file in ns3
 int main (int argc, char *argv[])
 {
-  srand(time(0));
   SimulationProperties properties;
 
   // Enable logging from the ns2 helper
@@ -98,7 +98,7 @@ int main (int argc, char *argv[])
 
     createTraffic(&properties);
 //    createUavs(&properties);
-    parseFleet(&properties);
+    createFleet(&properties);
 
     Simulator::Stop (Seconds (properties.duration));
 
@@ -171,6 +171,10 @@ int checkSimulationArguments(int argc,char* argv[],SimulationProperties* propert
   UavMobilityModel::ALT_OBS = atoi ( (const char*) settings["observationAltitude"].c_str() );  
 
   properties->selectionStrategy = settings["selectionStrategy"];
+  properties->sharedVisits = settings["sharedVisits"].compare("true") == 0;
+  properties->routedReturn = settings["routedReturn"].compare("true") == 0;
+  properties->territoryGraph = settings["territoryGraph"];
+  properties->lendingDepth = settings["lendingDepth"].empty() ? 1 : atoi ( (const char*) settings["lendingDepth"].c_str() );
 
 
   if (properties->traceFile.empty () || properties->fleetFile.empty ()) {    
@@ -230,73 +234,31 @@ map<std::string,std::string> parse(std::string settingsFile){
 
 }
 
-void parseFleet(SimulationProperties* properties){
-     xmlDocPtr doc;
-	xmlNodePtr cur;
-
-	doc = xmlParseFile((const char*) properties->fleetFile.c_str());
-
-	if (doc == NULL ) {
-		cout << "Fleet file Not parsed" << endl;
-		return ;
-	}
-
-	cur = xmlDocGetRootElement(doc);
-
-	if (cur == NULL) {
-		cout << "Empty document" << endl;
-		xmlFreeDoc(doc);
-	}
-
-	if (xmlStrcmp(cur->name, (const xmlChar *) "fleet") != 0) {
-		cout << "document of the wrong type, root node != fleet" << endl;
-		xmlFreeDoc(doc);
-	}
-	else {
-		xmlNodePtr node = cur->xmlChildrenNode;
-
-		while (node != NULL){
-
-			if (xmlStrcmp(node->name, (const xmlChar *) "team") == 0) {
-                    parseTeam(node,properties);
-			}
-
-			node = node->next;
-		}
-
-		xmlFreeDoc(doc);
-	}
-}
-
-void parseTeam(xmlNodePtr root,SimulationProperties* properties){
-     Ptr<Channel> channel = getCommunicationChannel(properties);
-     Ptr<Base> base;
-     Ptr<Uav> uav;
-     string uavIp;
-
-     xmlNodePtr node = root->xmlChildrenNode;
-	while (node != NULL){
-		if (xmlStrcmp(node->name, (const xmlChar *) "base") == 0) {
-			double baseX = atof ((const char*) xmlGetProp(node,(const xmlChar*) "x"));
-			double baseY = atof ((const char*) xmlGetProp(node,(const xmlChar*) "y"));
-			string baseIp = string ((const char*) xmlGetProp(node,(const xmlChar*) "ip"));
-
-               base = createBase(properties,baseX,baseY,baseIp,channel);
-               baseNums.push_back(base->GetId());
-		}
-
-          if (xmlStrcmp(node->name, (const xmlChar *) "uav") == 0) {
-			string graph = string ((const char*) xmlGetProp(node,(const xmlChar*) "graph"));
-			uavIp = string ((const char*) xmlGetProp(node,(const xmlChar*) "ip"));
+void createFleet(SimulationProperties* properties){
+     FleetHelper fleet;
+     fleet.SetUavParameters(properties->maxSpeed,properties->ascendSpeed,properties->descendSpeed,properties->selectionStrategy);
+     fleet.SetEnergyParameters(properties->voltage,properties->capacity);
+     fleet.SetCommunicationRange(properties->communicationRange);
+     fleet.SetSharedVisits(properties->sharedVisits);
+     fleet.SetRoutedReturn(properties->routedReturn);
+     if (!properties->territoryGraph.empty()){
+          fleet.SetTerritories(properties->territoryGraph,properties->lendingDepth);
+     }
 
-               uav = createUav(properties,graph,uavIp,channel);
-               uavNums.push_back(uav->GetId());
-		}
+     if (!fleet.Install(properties->fleetFile)){
+          return;
+     }
+     fleet.AssignStreams(0);
 
-		node = node->next;
-	}
+     for(int i=0; i < (int) fleet.GetBases().size(); i++){
+          baseNums.push_back(fleet.GetBases()[i]->GetId());
+     }
+     for(int i=0; i < (int) fleet.GetUavs().size(); i++){
+          uavNums.push_back(fleet.GetUavs()[i]->GetId());
+     }
 
-     //Simulator::Schedule(Seconds(100), &Base::send, base, uavIp );
+     std::cout << fleet.GetTimings() << std::endl;
+     std::cout << GraphData::getCacheStats() << std::endl;
 }
 
 void createTraffic(SimulationProperties* properties){
@@ -306,12 +268,6 @@ void createTraffic(SimulationProperties* properties){
     ns2.Install ();
 }
 
-Ptr<Base> createBase(SimulationProperties* properties,double x,double y,string ip,Ptr<Channel> channel){
-     Ptr<Base> base = CreateObject<Base>(x,y);
-     base->setup(channel,ip);     
-     return base;
-}
-
 Ptr<Channel> getCommunicationChannel(SimulationProperties* properties){
 
     YansWifiChannelHelper channelHelper = YansWifiChannelHelper::Default ();
@@ -322,17 +278,6 @@ Ptr<Channel> getCommunicationChannel(SimulationProperties* properties){
     return wifiChannel;
 }
 
-Ptr<Uav> createUav(SimulationProperties* properties,string graph,string ip,Ptr<Channel> channel){
-    UavContainer uavs;
-    uavs.Create(1);
-
-    createUav(uavs.Get(0),properties,graph);
-    uavs.Get(0)->setup(channel,ip);
-    uavs.Get(0)->startServer();
-    uavs.Get(0)->launch();
-    return uavs.Get(0);
-}
-
 void createUavs(SimulationProperties* properties){
 
     Ptr<Channel> channel = getCommunicationChannel(properties);
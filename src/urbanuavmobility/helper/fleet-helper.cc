@@ -0,0 +1,364 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#include "fleet-helper.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/double.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/uav-container.h"
+#include "ns3/uav-energy-model.h"
+#include "ns3/uav-mobility-model.h"
+#include "ns3/GraphData.h"
+#include "ns3/WorkerPool.h"
+#include <iostream>
+#include <sstream>
+#include <set>
+#include <cstdlib>
+#include <unistd.h>
+
+namespace ns3{
+
+FleetHelper::FleetHelper(){
+     maxSpeed = 10;
+     ascendSpeed = 2;
+     descendSpeed = 2;
+     selectionStrategy = "random";
+     voltage = 11.1;
+     capacity = 1000;
+     communicationRange = 100;
+
+     long cores = sysconf(_SC_NPROCESSORS_ONLN);
+     threads = cores > 0 ? (uint32_t) cores : 1;
+     sharedVisits = false;
+     routedReturn = false;
+     lendingDepth = 1;
+
+     parseTime = 0;
+     graphsTime = 0;
+     nodesTime = 0;
+     graphsCount = 0;
+}
+
+void FleetHelper::SetUavParameters(double maxSpeed,double ascendSpeed,double descendSpeed,string selectionStrategy){
+     this->maxSpeed = maxSpeed;
+     this->ascendSpeed = ascendSpeed;
+     this->descendSpeed = descendSpeed;
+     this->selectionStrategy = selectionStrategy;
+}
+
+void FleetHelper::SetEnergyParameters(double voltage,int capacity){
+     this->voltage = voltage;
+     this->capacity = capacity;
+}
+
+void FleetHelper::SetCommunicationRange(double range){
+     communicationRange = range;
+}
+
+void FleetHelper::SetThreads(uint32_t n){
+     threads = n > 0 ? n : 1;
+}
+
+void FleetHelper::SetSharedVisits(bool shared){
+     sharedVisits = shared;
+}
+
+/* See UavMobilityModel::setRoutedReturn. */
+void FleetHelper::SetRoutedReturn(bool routed){
+     routedReturn = routed;
+}
+
+/*
+ * Walks graphFile, the graph the fleet's subgraphs were cut from, with the
+ * subgraph of each UAV as its territory. lendingDepth is passed to
+ * TerritoryMap::setLendingDepth.
+ */
+void FleetHelper::SetTerritories(string graphFile,int lendingDepth){
+     territoryGraph = graphFile;
+     this->lendingDepth = lendingDepth;
+}
+
+bool FleetHelper::Install(string fleetFile){
+     vector<FleetTeam> teams;
+     SystemWallClockMs clock;
+
+     clock.Start();
+     bool parsed = Parse(fleetFile,teams);
+     parseTime = clock.End();
+     if (!parsed){
+          return false;
+     }
+
+     clock.Start();
+     LoadGraphs(teams);
+     bool territoriesCreated = CreateTerritories(teams);
+     graphsTime = clock.End();
+     if (!territoriesCreated){
+          return false;
+     }
+
+     clock.Start();
+     for(int i=0; i < (int) teams.size(); i++){
+          Ptr<Channel> channel = CreateChannel();
+
+          if (teams[i].hasBase){
+               bases.push_back(CreateBase(teams[i],channel));
+          }
+
+          for(int j=0; j < (int) teams[i].uavs.size(); j++){
+               string graphFile = territoryGraph.empty() ? teams[i].uavs[j].graph : territoryGraph;
+               Ptr<VisitBlackboard> blackboard = sharedVisits ? GetBlackboard(graphFile) : 0;
+               uavs.push_back(CreateUav(teams[i].uavs[j],channel,blackboard));
+          }
+     }
+     nodesTime = clock.End();
+
+     return true;
+}
+
+/*
+ * Assigns consecutive streams to the jitter and the mobility model of each
+ * UAV. Each UAV uses the same number of streams whatever its strategy, so
+ * a UAV draws from the same streams when only the strategy changes between
+ * runs. Returns the number of streams used.
+ */
+int64_t FleetHelper::AssignStreams(int64_t stream){
+     int64_t current = stream;
+     for(int i=0; i < (int) uavs.size(); i++){
+          current += uavs[i]->AssignStreams(current);
+
+          Ptr<MobilityModel> mobilityModel = uavs[i]->GetObject<MobilityModel>();
+          if (mobilityModel != NULL){
+               current += mobilityModel->AssignStreams(current);
+          }
+     }
+     return current - stream;
+}
+
+string FleetHelper::GetTimings() const{
+     stringstream timings;
+     timings << "fleet parse:" << parseTime << "ms;";
+     timings << "graphs load:" << graphsTime << "ms (" << graphsCount << " graphs);";
+     timings << "nodes creation:" << nodesTime << "ms;";
+     timings << "total:" << (parseTime + graphsTime + nodesTime) << "ms;";
+     return timings.str();
+}
+
+/*
+ * Graph paths that are not absolute are relative to the fleet file, so a
+ * partition directory can be moved as a whole.
+ */
+bool FleetHelper::Parse(string file,vector<FleetTeam>& teams){
+     xmlDocPtr doc;
+	xmlNodePtr cur;
+
+	doc = xmlParseFile(file.c_str());
+
+	if (doc == NULL ) {
+		cout << "Fleet file Not parsed" << endl;
+		return false;
+	}
+
+	cur = xmlDocGetRootElement(doc);
+
+	if (cur == NULL) {
+		cout << "Empty document" << endl;
+		xmlFreeDoc(doc);
+		return false;
+	}
+
+	if (xmlStrcmp(cur->name, (const xmlChar *) "fleet") != 0) {
+		cout << "document of the wrong type, root node != fleet" << endl;
+		xmlFreeDoc(doc);
+		return false;
+	}
+
+	size_t slash = file.rfind('/');
+	string directory = slash == string::npos ? "" : file.substr(0,slash + 1);
+
+	xmlNodePtr node = cur->xmlChildrenNode;
+	while (node != NULL){
+		if (xmlStrcmp(node->name, (const xmlChar *) "team") == 0) {
+               FleetTeam team;
+               ParseTeam(node,team);
+               for(uint32_t i=0; i < team.uavs.size(); i++){
+                    string& graph = team.uavs[i].graph;
+                    if (!graph.empty() && graph[0] != '/' && directory.size() > 0){
+                         graph = directory + graph;
+                    }
+               }
+               teams.push_back(team);
+		}
+		node = node->next;
+	}
+
+	xmlFreeDoc(doc);
+     return true;
+}
+
+static string getProperty(xmlNodePtr node,const char* name){
+     xmlChar* value = xmlGetProp(node,(const xmlChar*) name);
+     if (value == NULL){
+          return "";
+     }
+
+     string property((const char*) value);
+     xmlFree(value);
+     return property;
+}
+
+void FleetHelper::ParseTeam(xmlNodePtr root,FleetTeam& team){
+     team.hasBase = false;
+     team.baseX = 0;
+     team.baseY = 0;
+
+     xmlNodePtr node = root->xmlChildrenNode;
+	while (node != NULL){
+		if (xmlStrcmp(node->name, (const xmlChar *) "base") == 0) {
+               team.hasBase = true;
+			team.baseX = atof(getProperty(node,"x").c_str());
+			team.baseY = atof(getProperty(node,"y").c_str());
+			team.baseIp = getProperty(node,"ip");
+		}
+
+          if (xmlStrcmp(node->name, (const xmlChar *) "uav") == 0) {
+               FleetUav uav;
+			uav.graph = getProperty(node,"graph");
+			uav.territory = 0;
+			uav.ip = getProperty(node,"ip");
+               team.uavs.push_back(uav);
+		}
+
+		node = node->next;
+	}
+}
+
+/*
+ * Loads every distinct graph of the fleet into the GraphData cache, one
+ * file per task of a WorkerPool.
+ */
+void FleetHelper::LoadGraphs(const vector<FleetTeam>& teams){
+     set<string> distinct;
+     pendingGraphs.clear();
+     for(int i=0; i < (int) teams.size(); i++){
+          for(int j=0; j < (int) teams[i].uavs.size(); j++){
+               if (distinct.insert(teams[i].uavs[j].graph).second){
+                    pendingGraphs.push_back(teams[i].uavs[j].graph);
+               }
+          }
+     }
+     if (!territoryGraph.empty() && distinct.insert(territoryGraph).second){
+          pendingGraphs.push_back(territoryGraph);
+     }
+     graphsCount = (uint32_t) pendingGraphs.size();
+
+     WorkerPool pool(threads);
+     pool.run(graphsCount,MakeCallback(&FleetHelper::LoadPendingGraph,this));
+}
+
+/*
+ * Matches the graph of every UAV onto the territory graph, in fleet file
+ * order. Fails if the territory graph did not load.
+ */
+bool FleetHelper::CreateTerritories(vector<FleetTeam>& teams){
+     if (territoryGraph.empty()){
+          return true;
+     }
+
+     Ptr<GraphData> data = GraphData::load(territoryGraph);
+     if (data == 0){
+          cout << "Territory graph not loaded" << endl;
+          return false;
+     }
+
+     territories = Create<TerritoryMap>(data);
+     territories->setLendingDepth(lendingDepth);
+     for(int i=0; i < (int) teams.size(); i++){
+          for(int j=0; j < (int) teams[i].uavs.size(); j++){
+               Ptr<GraphData> subgraph = GraphData::load(teams[i].uavs[j].graph);
+               if (subgraph == 0){
+                    subgraph = Create<GraphData>();
+               }
+               teams[i].uavs[j].territory = territories->addTerritory(subgraph);
+          }
+     }
+     return true;
+}
+
+void FleetHelper::LoadPendingGraph(uint32_t i){
+     GraphData::load(pendingGraphs[i]);
+}
+
+Ptr<Channel> FleetHelper::CreateChannel() const{
+    YansWifiChannelHelper channelHelper = YansWifiChannelHelper::Default ();
+    Ptr<YansWifiChannel> wifiChannel  = channelHelper.Create();
+    Ptr<RangePropagationLossModel> loss = CreateObject<RangePropagationLossModel>();
+    loss->SetAttribute("MaxRange",DoubleValue(communicationRange));
+    wifiChannel->SetPropagationLossModel(loss);
+    return wifiChannel;
+}
+
+Ptr<Base> FleetHelper::CreateBase(const FleetTeam& team,Ptr<Channel> channel) const{
+     Ptr<Base> base = CreateObject<Base>(team.baseX,team.baseY);
+     base->setup(channel,team.baseIp);
+     return base;
+}
+
+/* The blackboard of the UAVs patrolling graphFile, 0 if it did not load. */
+Ptr<VisitBlackboard> FleetHelper::GetBlackboard(string graphFile){
+     Ptr<GraphData> data = GraphData::load(graphFile);
+     if (data == 0){
+          return 0;
+     }
+
+     Ptr<VisitBlackboard>& blackboard = blackboards[PeekPointer(data)];
+     if (blackboard == 0){
+          blackboard = Create<VisitBlackboard>(data);
+     }
+     return blackboard;
+}
+
+Ptr<Uav> FleetHelper::CreateUav(const FleetUav& fleetUav,Ptr<Channel> channel,Ptr<VisitBlackboard> blackboard) const{
+     UavContainer container;
+     container.Create(1);
+     Ptr<Uav> uav = container.Get(0);
+
+     Ptr<UavEnergyModel> energyModel = CreateObject<UavEnergyModel>(uav,voltage,capacity);
+     string graphFile = territories != 0 ? territoryGraph : fleetUav.graph;
+     Ptr<UavMobilityModel> mobilityModel = CreateObject<UavMobilityModel>((char*) graphFile.c_str(),maxSpeed,ascendSpeed,descendSpeed,energyModel,selectionStrategy);
+     mobilityModel->setRoutedReturn(routedReturn);
+     uav->AggregateObject(mobilityModel);
+     if (territories != 0){
+          mobilityModel->joinTerritory(territories,fleetUav.territory);
+     }
+
+     if (blackboard != 0){
+          mobilityModel->shareVisits(blackboard);
+          uav->setBroadcasting(false);
+     }
+     else {
+          uav->setup(channel,fleetUav.ip);
+          uav->startServer();
+     }
+     uav->launch();
+     return uav;
+}
+
+}
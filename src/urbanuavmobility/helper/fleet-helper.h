@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#ifndef FLEET_HELPER_H_
+#define FLEET_HELPER_H_
+
+#include "ns3/ptr.h"
+#include "ns3/channel.h"
+#include "ns3/uav.h"
+#include "ns3/base.h"
+#include "ns3/VisitBlackboard.h"
+#include "ns3/TerritoryMap.h"
+#include <libxml/parser.h>
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace ns3{
+
+/**
+ * \brief Builds the teams of a fleet file.
+ *
+ * A fleet file lists teams, each with an optional base and the UAVs that
+ * patrol from it:
+ *
+ *   <fleet>
+ *   <team>
+ *   <base x='11290.5' y='12027.8' ip='10.0.184.1' />
+ *   <uav graph='g184.xml' ip='10.0.184.2' />
+ *   </team>
+ *   </fleet>
+ *
+ * Graph paths that are not absolute are relative to the fleet file.
+ *
+ * Install() reads the file, loads every distinct graph it references on a
+ * pool of threads (the graphs land in the GraphData cache, so the mobility
+ * models created afterwards find them loaded) and then creates the bases
+ * and UAVs on the calling thread, as ns-3 objects must be. Every team gets
+ * its own communication channel. AssignStreams() then gives every UAV its
+ * own random streams, in fleet file order.
+ *
+ * With SetSharedVisits(true) the UAVs get no network stack and send no
+ * edges broadcasts; the UAVs patrolling the same graph share their visits
+ * through one VisitBlackboard instead, for studies of the strategies alone.
+ *
+ * With SetTerritories() every UAV walks the full graph the partition was
+ * cut from, restricted to the edges of its own gN.xml by a TerritoryMap,
+ * so the edges of a UAV away at its base are lent to its neighbours.
+ */
+class FleetHelper {
+private:
+     struct FleetUav {
+          string graph;
+          string ip;
+          uint32_t territory;
+     };
+
+     struct FleetTeam {
+          bool hasBase;
+          double baseX;
+          double baseY;
+          string baseIp;
+          vector<FleetUav> uavs;
+     };
+
+     double maxSpeed;
+     double ascendSpeed;
+     double descendSpeed;
+     string selectionStrategy;
+     double voltage;
+     int capacity;
+     double communicationRange;
+     uint32_t threads;
+     bool sharedVisits;
+     bool routedReturn;
+     string territoryGraph;  // empty when every UAV walks its own graph
+     int lendingDepth;
+
+     vector<Ptr<Base> > bases;
+     vector<Ptr<Uav> > uavs;
+     map<const GraphData*,Ptr<VisitBlackboard> > blackboards;
+     Ptr<TerritoryMap> territories;
+     int64_t parseTime;  // milliseconds
+     int64_t graphsTime; // milliseconds
+     int64_t nodesTime;  // milliseconds
+     uint32_t graphsCount;
+
+     vector<string> pendingGraphs; // graph files shared by the loading threads
+
+     bool Parse(string file,vector<FleetTeam>& teams);
+     void ParseTeam(xmlNodePtr root,FleetTeam& team);
+     void LoadGraphs(const vector<FleetTeam>& teams);
+     bool CreateTerritories(vector<FleetTeam>& teams);
+     void LoadPendingGraph(uint32_t i);
+     Ptr<Channel> CreateChannel() const;
+     Ptr<Base> CreateBase(const FleetTeam& team,Ptr<Channel> channel) const;
+     Ptr<Uav> CreateUav(const FleetUav& fleetUav,Ptr<Channel> channel,Ptr<VisitBlackboard> blackboard) const;
+     Ptr<VisitBlackboard> GetBlackboard(string graphFile);
+
+public:
+     FleetHelper();
+     void SetUavParameters(double maxSpeed,double ascendSpeed,double descendSpeed,string selectionStrategy);
+     void SetEnergyParameters(double voltage,int capacity);
+     void SetCommunicationRange(double range);
+     void SetThreads(uint32_t n);
+     void SetSharedVisits(bool shared);
+     void SetRoutedReturn(bool routed);
+     void SetTerritories(string graphFile,int lendingDepth);
+
+     bool Install(string fleetFile);
+     int64_t AssignStreams(int64_t stream);
+     const vector<Ptr<Base> >& GetBases() const { return bases; }
+     const vector<Ptr<Uav> >& GetUavs() const { return uavs; }
+     Ptr<TerritoryMap> GetTerritories() const { return territories; }
+     string GetTimings() const;
+};
+
+}
+
+#endif /* FLEET_HELPER_H_ */
@@ -0,0 +1,277 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#include "ContractionHierarchy.h"
+#include <cmath>
+#include <algorithm>
+#include <functional>
+
+using namespace std;
+
+namespace ns3{
+
+ContractionHierarchy::ContractionHierarchy(){
+     clear();
+}
+
+void ContractionHierarchy::clear(){
+     nodeCount = 0;
+     ranks.clear();
+     upOffsets.assign(1,0);
+     upNodes.clear();
+     upWeights.clear();
+     upMiddles.clear();
+     downOffsets.assign(1,0);
+     downNodes.clear();
+     downWeights.clear();
+     downMiddles.clear();
+     shortcutCount = 0;
+     built = false;
+     witnessSearch = 0;
+}
+
+/*
+ * Nodes are contracted in order of edge difference (shortcuts added less
+ * arcs removed) plus the number of neighbours already contracted, which
+ * spreads the contraction evenly over the graph. Priorities change as the
+ * graph shrinks, so a node is only contracted if its priority, computed
+ * again, is still the smallest.
+ */
+void ContractionHierarchy::build(const GraphTopology& topology){
+     clear();
+     nodeCount = topology.getNodeCount();
+     outArcs.assign(nodeCount,vector<Arc>());
+     inArcs.assign(nodeCount,vector<Arc>());
+     contracted.assign(nodeCount,false);
+     witnessDistances.assign(nodeCount,0);
+     witnessReached.assign(nodeCount,0);
+     deletedNeighbours.assign(nodeCount,0);
+
+     for(uint32_t e=0; e < topology.getEdgeCount(); e++){
+          uint32_t from = topology.getEdgeSource(e);
+          uint32_t to = topology.getEdgeTarget(e);
+          if (from != to){
+               double dx = topology.getX(to) - topology.getX(from);
+               double dy = topology.getY(to) - topology.getY(from);
+               addArc(from,to,sqrt(dx*dx + dy*dy),GraphTopology::NONE);
+          }
+     }
+
+     vector<pair<int,uint32_t> > queue;
+     for(uint32_t node=0; node < nodeCount; node++){
+          queue.push_back(make_pair(getPriority(node),node));
+     }
+     make_heap(queue.begin(),queue.end(),greater<pair<int,uint32_t> >());
+
+     vector<vector<Arc> > ups(nodeCount);
+     vector<vector<Arc> > downs(nodeCount);
+     ranks.assign(nodeCount,0);
+     uint32_t rank = 0;
+     while (!queue.empty()){
+          pop_heap(queue.begin(),queue.end(),greater<pair<int,uint32_t> >());
+          uint32_t node = queue.back().second;
+          queue.pop_back();
+
+          int priority = getPriority(node);
+          if (!queue.empty() && priority > queue.front().first){
+               queue.push_back(make_pair(priority,node));
+               push_heap(queue.begin(),queue.end(),greater<pair<int,uint32_t> >());
+               continue;
+          }
+
+          contract(node,true);
+          for(uint32_t i=0; i < outArcs[node].size(); i++){
+               if (!contracted[outArcs[node][i].node]){
+                    ups[node].push_back(outArcs[node][i]);
+                    deletedNeighbours[outArcs[node][i].node]++;
+               }
+          }
+          for(uint32_t i=0; i < inArcs[node].size(); i++){
+               if (!contracted[inArcs[node][i].node]){
+                    downs[node].push_back(inArcs[node][i]);
+                    deletedNeighbours[inArcs[node][i].node]++;
+               }
+          }
+          contracted[node] = true;
+          ranks[node] = rank++;
+     }
+
+     upOffsets.assign(nodeCount + 1,0);
+     downOffsets.assign(nodeCount + 1,0);
+     for(uint32_t node=0; node < nodeCount; node++){
+          for(uint32_t i=0; i < ups[node].size(); i++){
+               upNodes.push_back(ups[node][i].node);
+               upWeights.push_back(ups[node][i].weight);
+               upMiddles.push_back(ups[node][i].middle);
+               shortcutCount += ups[node][i].middle != GraphTopology::NONE ? 1 : 0;
+          }
+          for(uint32_t i=0; i < downs[node].size(); i++){
+               downNodes.push_back(downs[node][i].node);
+               downWeights.push_back(downs[node][i].weight);
+               downMiddles.push_back(downs[node][i].middle);
+               shortcutCount += downs[node][i].middle != GraphTopology::NONE ? 1 : 0;
+          }
+          upOffsets[node+1] = (uint32_t) upNodes.size();
+          downOffsets[node+1] = (uint32_t) downNodes.size();
+     }
+
+     vector<vector<Arc> >().swap(outArcs);
+     vector<vector<Arc> >().swap(inArcs);
+     vector<bool>().swap(contracted);
+     vector<double>().swap(witnessDistances);
+     vector<uint32_t>().swap(witnessReached);
+     vector<pair<double,uint32_t> >().swap(witnessFrontier);
+     vector<int>().swap(deletedNeighbours);
+     built = true;
+}
+
+/* Adds an arc, or shortens the arc already there between the same nodes. */
+void ContractionHierarchy::addArc(uint32_t from,uint32_t to,double weight,uint32_t middle){
+     for(uint32_t i=0; i < outArcs[from].size(); i++){
+          if (outArcs[from][i].node != to){
+               continue;
+          }
+          if (weight < outArcs[from][i].weight){
+               outArcs[from][i].weight = weight;
+               outArcs[from][i].middle = middle;
+               for(uint32_t j=0; j < inArcs[to].size(); j++){
+                    if (inArcs[to][j].node == from){
+                         inArcs[to][j].weight = weight;
+                         inArcs[to][j].middle = middle;
+                    }
+               }
+          }
+          return;
+     }
+
+     Arc out = {to,weight,middle};
+     Arc in = {from,weight,middle};
+     outArcs[from].push_back(out);
+     inArcs[to].push_back(in);
+}
+
+/*
+ * Dijkstra from from over the nodes still in the graph but skipped, up to
+ * maxDistance. The search gives up after a few hundred nodes, which only
+ * costs an unneeded shortcut now and then.
+ */
+void ContractionHierarchy::findWitnesses(uint32_t from,uint32_t skipped,double maxDistance){
+     if (++witnessSearch == 0){
+          witnessReached.assign(witnessReached.size(),0);
+          witnessSearch = 1;
+     }
+
+     witnessFrontier.clear();
+     witnessDistances[from] = 0;
+     witnessReached[from] = witnessSearch;
+     witnessFrontier.push_back(make_pair(0.0,from));
+
+     int settled = 0;
+     while (!witnessFrontier.empty()){
+          pop_heap(witnessFrontier.begin(),witnessFrontier.end(),greater<pair<double,uint32_t> >());
+          double d = witnessFrontier.back().first;
+          uint32_t node = witnessFrontier.back().second;
+          witnessFrontier.pop_back();
+          if (d > witnessDistances[node]){
+               continue;
+          }
+          if (d > maxDistance || ++settled > WITNESS_SETTLE_LIMIT){
+               return;
+          }
+
+          for(uint32_t i=0; i < outArcs[node].size(); i++){
+               uint32_t next = outArcs[node][i].node;
+               if (contracted[next] || next == skipped){
+                    continue;
+               }
+               double nextDistance = d + outArcs[node][i].weight;
+               if (witnessReached[next] != witnessSearch || nextDistance < witnessDistances[next]){
+                    witnessReached[next] = witnessSearch;
+                    witnessDistances[next] = nextDistance;
+                    witnessFrontier.push_back(make_pair(nextDistance,next));
+                    push_heap(witnessFrontier.begin(),witnessFrontier.end(),greater<pair<double,uint32_t> >());
+               }
+          }
+     }
+}
+
+/*
+ * Counts the shortcuts contracting node needs and adds them if apply is
+ * set. Shortcuts never start or end at node, so its own rows stay as they
+ * are while they are read.
+ */
+int ContractionHierarchy::contract(uint32_t node,bool apply){
+     int shortcuts = 0;
+     for(uint32_t i=0; i < inArcs[node].size(); i++){
+          Arc in = inArcs[node][i];
+          if (contracted[in.node]){
+               continue;
+          }
+
+          double maxDistance = -1;
+          for(uint32_t j=0; j < outArcs[node].size(); j++){
+               const Arc& out = outArcs[node][j];
+               if (!contracted[out.node] && out.node != in.node && in.weight + out.weight > maxDistance){
+                    maxDistance = in.weight + out.weight;
+               }
+          }
+          if (maxDistance < 0){
+               continue;
+          }
+
+          findWitnesses(in.node,node,maxDistance);
+          for(uint32_t j=0; j < outArcs[node].size(); j++){
+               Arc out = outArcs[node][j];
+               if (contracted[out.node] || out.node == in.node){
+                    continue;
+               }
+               double through = in.weight + out.weight;
+               if (witnessReached[out.node] == witnessSearch && witnessDistances[out.node] <= through){
+                    continue;
+               }
+
+               shortcuts++;
+               if (apply){
+                    addArc(in.node,out.node,through,node);
+               }
+          }
+     }
+     return shortcuts;
+}
+
+int ContractionHierarchy::getPriority(uint32_t node){
+     int arcs = 0;
+     for(uint32_t i=0; i < outArcs[node].size(); i++){
+          arcs += contracted[outArcs[node][i].node] ? 0 : 1;
+     }
+     for(uint32_t i=0; i < inArcs[node].size(); i++){
+          arcs += contracted[inArcs[node][i].node] ? 0 : 1;
+     }
+     return contract(node,false) - arcs + deletedNeighbours[node];
+}
+
+size_t ContractionHierarchy::getBytes() const{
+     return ranks.capacity() * sizeof(uint32_t) +
+          (upOffsets.capacity() + upNodes.capacity() + upMiddles.capacity()) * sizeof(uint32_t) +
+          upWeights.capacity() * sizeof(double) +
+          (downOffsets.capacity() + downNodes.capacity() + downMiddles.capacity()) * sizeof(uint32_t) +
+          downWeights.capacity() * sizeof(double);
+}
+
+}
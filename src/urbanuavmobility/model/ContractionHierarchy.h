@@ -0,0 +1,112 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#ifndef CONTRACTIONHIERARCHY_H_
+#define CONTRACTIONHIERARCHY_H_
+
+#include "GraphTopology.h"
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+#include <utility>
+
+using namespace std;
+
+namespace ns3{
+
+/**
+ * \brief Contraction hierarchy of a graph, for fast shortest path queries.
+ *
+ * build() removes the nodes one by one, least important first, and adds a
+ * shortcut between two neighbours of a removed node wherever the only
+ * shortest path between them went through it. A node's rank is its place
+ * in that order. Every path then has a shortest equivalent that climbs to
+ * higher ranks and comes back down. Router searches upward from both ends
+ * and only settles a few hundred nodes even on a city graph.
+ *
+ * The arcs are kept in two rows per node, in the compressed form of
+ * GraphTopology:
+ * - up rows: arcs to higher ranked nodes;
+ * - down rows: arcs from higher ranked nodes.
+ * The middle of a shortcut is the node it bypasses, NONE for an edge of
+ * the graph, so routes can be unpacked back to graph nodes.
+ */
+class ContractionHierarchy {
+private:
+     struct Arc {
+          uint32_t node;
+          double weight;
+          uint32_t middle;
+     };
+
+     uint32_t nodeCount;
+     vector<uint32_t> ranks;
+     vector<uint32_t> upOffsets;
+     vector<uint32_t> upNodes;     // targets
+     vector<double> upWeights;     // meters
+     vector<uint32_t> upMiddles;
+     vector<uint32_t> downOffsets;
+     vector<uint32_t> downNodes;   // sources
+     vector<double> downWeights;   // meters
+     vector<uint32_t> downMiddles;
+     uint32_t shortcutCount;
+     bool built;
+
+     // contraction state, released at the end of build()
+     vector<vector<Arc> > outArcs;
+     vector<vector<Arc> > inArcs;
+     vector<bool> contracted;
+     vector<double> witnessDistances;
+     vector<uint32_t> witnessReached;
+     uint32_t witnessSearch;
+     vector<pair<double,uint32_t> > witnessFrontier;
+     vector<int> deletedNeighbours;
+
+     void addArc(uint32_t from,uint32_t to,double weight,uint32_t middle);
+     void findWitnesses(uint32_t from,uint32_t skipped,double maxDistance);
+     int contract(uint32_t node,bool apply);
+     int getPriority(uint32_t node);
+
+public:
+     static const int WITNESS_SETTLE_LIMIT = 200;
+
+     ContractionHierarchy();
+     void build(const GraphTopology& topology);
+     bool isBuilt() const { return built; }
+     void clear();
+
+     uint32_t getNodeCount() const { return nodeCount; }
+     uint32_t getRank(uint32_t node) const { return ranks[node]; }
+     uint32_t getShortcutCount() const { return shortcutCount; }
+     uint32_t getFirstUp(uint32_t node) const { return upOffsets[node]; }
+     uint32_t getLastUp(uint32_t node) const { return upOffsets[node+1]; }
+     uint32_t getUpNode(uint32_t arc) const { return upNodes[arc]; }
+     double getUpWeight(uint32_t arc) const { return upWeights[arc]; }
+     uint32_t getUpMiddle(uint32_t arc) const { return upMiddles[arc]; }
+     uint32_t getFirstDown(uint32_t node) const { return downOffsets[node]; }
+     uint32_t getLastDown(uint32_t node) const { return downOffsets[node+1]; }
+     uint32_t getDownNode(uint32_t arc) const { return downNodes[arc]; }
+     double getDownWeight(uint32_t arc) const { return downWeights[arc]; }
+     uint32_t getDownMiddle(uint32_t arc) const { return downMiddles[arc]; }
+     size_t getBytes() const;
+};
+
+}
+
+#endif /* CONTRACTIONHIERARCHY_H_ */
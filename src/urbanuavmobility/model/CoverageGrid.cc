@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#include "CoverageGrid.h"
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+namespace ns3{
+
+
+CoverageGrid::CoverageGrid() {
+     minX = 0;
+     minY = 0;
+     width = 1;
+     length = 1;
+     cols = 0;
+     rows = 0;
+}
+
+CoverageGrid::CoverageGrid(Region area,float width,float length) {
+     minX = area.getTopLeft().x;
+     minY = area.getTopLeft().y;
+     this->width = width > 0 ? width : 1;
+     this->length = length > 0 ? length : 1;
+     cols = (int) floor((area.getBottomRight().x - minX) / this->width) + 1;
+     rows = (int) floor((area.getBottomRight().y - minY) / this->length) + 1;
+
+     int words = (cols * rows + 63) / 64;
+     road.assign(words,0);
+     visited.assign(words,0);
+}
+
+bool CoverageGrid::test(const vector<uint64_t>& bits,int cell) const{
+     return (bits[cell >> 6] >> (cell & 63)) & 1;
+}
+
+void CoverageGrid::set(vector<uint64_t>& bits,int cell){
+     bits[cell >> 6] |= ((uint64_t) 1) << (cell & 63);
+}
+
+bool CoverageGrid::findCell(double x,double y,int& col,int& row) const{
+     col = (int) floor((x - minX) / width);
+     row = (int) floor((y - minY) / length);
+     return col >= 0 && col < cols && row >= 0 && row < rows;
+}
+
+int CoverageGrid::getColor(int col,int row) const{
+     int cell = row * cols + col;
+     bool onRoad = test(road,cell);
+     if (test(visited,cell)){
+          return onRoad ? 2 : 3;
+     }
+     return onRoad ? 1 : 0;
+}
+
+Region CoverageGrid::getRegion(int col,int row) const{
+     Region region(minX + col * width,minY + row * length,
+                   minX + (col + 1) * width,minY + (row + 1) * length);
+     region.mark(getColor(col,row));
+     return region;
+}
+
+double CoverageGrid::boundaryStep(double from,double delta,int cell,int step,double origin,double size,int count) const{
+     if (step == 0 || cell + step < 0 || cell + step >= count){
+          return numeric_limits<double>::infinity();
+     }
+     double boundary = origin + (step > 0 ? cell + 1 : cell) * size;
+     return (boundary - from) / delta;
+}
+
+void CoverageGrid::markRoad(double x0,double y0,double x1,double y1){
+     if (cols == 0 || rows == 0){
+          return;
+     }
+
+     // clamped, since the area bounds are only float precise
+     int i,j,endI,endJ;
+     findCell(x0,y0,i,j);
+     findCell(x1,y1,endI,endJ);
+     i = std::max(0,std::min(cols - 1,i));
+     j = std::max(0,std::min(rows - 1,j));
+     endI = std::max(0,std::min(cols - 1,endI));
+     endJ = std::max(0,std::min(rows - 1,endJ));
+
+     double dx = x1 - x0;
+     double dy = y1 - y0;
+     int stepI = dx > 0 ? 1 : (dx < 0 ? -1 : 0);
+     int stepJ = dy > 0 ? 1 : (dy < 0 ? -1 : 0);
+     double tx = boundaryStep(x0,dx,i,stepI,minX,width,cols);
+     double ty = boundaryStep(y0,dy,j,stepJ,minY,length,rows);
+
+     // supercover walk: every cell the segment touches, including both
+     // neighbours when it passes exactly through a cell corner
+     set(road,j * cols + i);
+     while ((i != endI || j != endJ) && std::min(tx,ty) <= 1){
+          if (tx < ty){
+               i += stepI;
+               tx = boundaryStep(x0,dx,i,stepI,minX,width,cols);
+          }
+          else if (ty < tx){
+               j += stepJ;
+               ty = boundaryStep(y0,dy,j,stepJ,minY,length,rows);
+          }
+          else {
+               set(road,j * cols + i + stepI);
+               set(road,(j + stepJ) * cols + i);
+               i += stepI;
+               j += stepJ;
+               tx = boundaryStep(x0,dx,i,stepI,minX,width,cols);
+               ty = boundaryStep(y0,dy,j,stepJ,minY,length,rows);
+          }
+          set(road,j * cols + i);
+     }
+}
+
+void CoverageGrid::visit(Vector point){
+     int col,row;
+     if (findCell(point.x,point.y,col,row)){
+          set(visited,row * cols + col);
+     }
+     else {
+          outside.insert(make_pair(col,row));
+     }
+}
+
+int CoverageGrid::count(int color) const{
+     int total = 0;
+     for(int w=0; w < (int) road.size(); w++){
+          uint64_t bits = 0;
+          switch (color){
+               case 0: bits = ~road[w] & ~visited[w]; break;
+               case 1: bits = road[w] & ~visited[w]; break;
+               case 2: bits = road[w] & visited[w]; break;
+               case 3: bits = ~road[w] & visited[w]; break;
+          }
+
+          // ignore the padding bits of the last word
+          if (w == (int) road.size() - 1 && (cols * rows) % 64 != 0){
+               bits &= (((uint64_t) 1) << ((cols * rows) % 64)) - 1;
+          }
+          total += __builtin_popcountll(bits);
+     }
+     if (color == 3){
+          total += (int) outside.size();
+     }
+     return total;
+}
+
+vector<Region> CoverageGrid::getCells(int color) const{
+     vector<Region> cells;
+     for(int row=0; row < rows; row++){
+          for(int col=0; col < cols; col++){
+               if (getColor(col,row) == color){
+                    cells.push_back(getRegion(col,row));
+               }
+          }
+     }
+     if (color == 3){
+          for(std::set<pair<int,int> >::const_iterator cell = outside.begin(); cell != outside.end(); cell++){
+               Region region(minX + cell->first * width,minY + cell->second * length,
+                             minX + (cell->first + 1) * width,minY + (cell->second + 1) * length);
+               region.mark(3);
+               cells.push_back(region);
+          }
+     }
+     return cells;
+}
+
+}
@@ -0,0 +1,81 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#ifndef COVERAGEGRID_H_
+#define COVERAGEGRID_H_
+
+#include <stdint.h>
+#include <set>
+#include <utility>
+#include <vector>
+#include "ns3/vector.h"
+#include "Util.h"
+
+using namespace std;
+
+namespace ns3{
+
+/**
+ * \ingroup mobility
+ * \brief Coverage grid over a rectangular area.
+ *
+ * Cells are found by arithmetic on the cell size and their state is kept in
+ * two bitmaps, one for cells on the road network and one for cells visited
+ * by a trajectory. Colours follow the Region convention: 0 empty, 1 road,
+ * 2 visited road and 3 visited off the road.
+ *
+ * The area is only as large as the road network, so a trajectory can leave
+ * it; the cells it visits outside, on the same lattice, are kept apart and
+ * counted and listed as visited off the road.
+ */
+class CoverageGrid {
+private:
+     double minX;
+     double minY;
+     double width;
+     double length;
+     int cols;
+     int rows;
+     vector<uint64_t> road;
+     vector<uint64_t> visited;
+     std::set<pair<int,int> > outside; // visited cells beyond the area, by column and row
+
+     bool test(const vector<uint64_t>& bits,int cell) const;
+     void set(vector<uint64_t>& bits,int cell);
+     double boundaryStep(double from,double delta,int cell,int step,double origin,double size,int count) const;
+
+public:
+     CoverageGrid();
+     CoverageGrid(Region area,float width,float length);
+     int getCols() const { return cols; }
+     int getRows() const { return rows; }
+     int getCellCount() const { return cols * rows; }
+     size_t getBytes() const { return (road.capacity() + visited.capacity()) * sizeof(uint64_t) + outside.size() * sizeof(pair<int,int>); }
+     bool findCell(double x,double y,int& col,int& row) const;
+     int getColor(int col,int row) const;
+     Region getRegion(int col,int row) const;
+     void markRoad(double x0,double y0,double x1,double y1);
+     void visit(Vector point);
+     int count(int color) const;
+     vector<Region> getCells(int color) const;
+};
+
+}
+
+#endif /* COVERAGEGRID_H_ */
@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#include "DistanceField.h"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+using namespace std;
+
+namespace ns3{
+
+DistanceField::DistanceField(){
+     target = GraphTopology::NONE;
+}
+
+static double getLength(const GraphTopology& topology,uint32_t edge){
+     uint32_t from = topology.getEdgeSource(edge);
+     uint32_t to = topology.getEdgeTarget(edge);
+     double dx = topology.getX(to) - topology.getX(from);
+     double dy = topology.getY(to) - topology.getY(from);
+     return sqrt(dx*dx + dy*dy);
+}
+
+/*
+ * The topology only keeps outgoing edges, so the incoming edges of every
+ * node are first gathered into rows of their own, in the same form.
+ */
+void DistanceField::build(const GraphTopology& topology,uint32_t target){
+     uint32_t nodeCount = topology.getNodeCount();
+     uint32_t edgeCount = topology.getEdgeCount();
+     this->target = target;
+     distances.assign(nodeCount,numeric_limits<double>::infinity());
+     nexts.assign(nodeCount,GraphTopology::NONE);
+     inOffsets.clear();
+     inEdges.clear();
+     if (target >= nodeCount){
+          return;
+     }
+
+     inOffsets.assign(nodeCount + 1,0);
+     inEdges.resize(edgeCount);
+     for(uint32_t e=0; e < edgeCount; e++){
+          inOffsets[topology.getEdgeTarget(e) + 1]++;
+     }
+     for(uint32_t n=0; n < nodeCount; n++){
+          inOffsets[n+1] += inOffsets[n];
+     }
+     vector<uint32_t> filled(inOffsets.begin(),inOffsets.end() - 1);
+     for(uint32_t e=0; e < edgeCount; e++){
+          inEdges[filled[topology.getEdgeTarget(e)]++] = e;
+     }
+
+     distances[target] = 0;
+     frontier.clear();
+     frontier.push_back(make_pair(0.0,target));
+     settle(topology);
+}
+
+/*
+ * Dijkstra over the incoming edges from the nodes in the frontier, which
+ * already have their distances, until no node gets closer.
+ */
+void DistanceField::settle(const GraphTopology& topology){
+     make_heap(frontier.begin(),frontier.end(),greater<pair<double,uint32_t> >());
+     while (!frontier.empty()){
+          pop_heap(frontier.begin(),frontier.end(),greater<pair<double,uint32_t> >());
+          double d = frontier.back().first;
+          uint32_t node = frontier.back().second;
+          frontier.pop_back();
+          if (d > distances[node]){
+               continue;
+          }
+
+          for(uint32_t i = inOffsets[node]; i < inOffsets[node+1]; i++){
+               uint32_t edge = inEdges[i];
+               if (!topology.isOpen(edge)){
+                    continue;
+               }
+               uint32_t previous = topology.getEdgeSource(edge);
+               double previousDistance = d + getLength(topology,edge);
+               if (previousDistance < distances[previous]){
+                    distances[previous] = previousDistance;
+                    nexts[previous] = node;
+                    frontier.push_back(make_pair(previousDistance,previous));
+                    push_heap(frontier.begin(),frontier.end(),greater<pair<double,uint32_t> >());
+               }
+          }
+     }
+}
+
+/*
+ * Follows the closing of edge. If its source went through it, the nodes
+ * whose path goes through that source lose their distances and take the
+ * best open edge out of that set, and the search spreads from there.
+ */
+void DistanceField::close(const GraphTopology& topology,uint32_t edge){
+     uint32_t from = topology.getEdgeSource(edge);
+     if (inOffsets.empty() || nexts[from] != topology.getEdgeTarget(edge)){
+          return;
+     }
+
+     vector<bool> cut(distances.size(),false);
+     vector<uint32_t> subtree(1,from);
+     cut[from] = true;
+     for(uint32_t i=0; i < subtree.size(); i++){
+          uint32_t node = subtree[i];
+          for(uint32_t k = inOffsets[node]; k < inOffsets[node+1]; k++){
+               uint32_t previous = topology.getEdgeSource(inEdges[k]);
+               if (!cut[previous] && nexts[previous] == node){
+                    cut[previous] = true;
+                    subtree.push_back(previous);
+               }
+          }
+     }
+
+     for(uint32_t i=0; i < subtree.size(); i++){
+          distances[subtree[i]] = numeric_limits<double>::infinity();
+          nexts[subtree[i]] = GraphTopology::NONE;
+     }
+
+     frontier.clear();
+     for(uint32_t i=0; i < subtree.size(); i++){
+          uint32_t node = subtree[i];
+          for(uint32_t e = topology.getFirstEdge(node); e < topology.getLastEdge(node); e++){
+               uint32_t next = topology.getEdgeTarget(e);
+               if (!topology.isOpen(e) || cut[next] || distances[next] == numeric_limits<double>::infinity()){
+                    continue;
+               }
+               double d = distances[next] + getLength(topology,e);
+               if (d < distances[node]){
+                    distances[node] = d;
+                    nexts[node] = next;
+               }
+          }
+          if (nexts[node] != GraphTopology::NONE){
+               frontier.push_back(make_pair(distances[node],node));
+          }
+     }
+     settle(topology);
+}
+
+/* Follows the opening of edge, which can only bring nodes closer. */
+void DistanceField::open(const GraphTopology& topology,uint32_t edge){
+     uint32_t from = topology.getEdgeSource(edge);
+     uint32_t to = topology.getEdgeTarget(edge);
+     if (inOffsets.empty() || !topology.isOpen(edge) || distances[to] == numeric_limits<double>::infinity()){
+          return;
+     }
+
+     double d = distances[to] + getLength(topology,edge);
+     if (d < distances[from]){
+          distances[from] = d;
+          nexts[from] = to;
+          frontier.clear();
+          frontier.push_back(make_pair(d,from));
+          settle(topology);
+     }
+}
+
+/*
+ * Follows GraphTopology::insertEdge(): the incoming edges are moved to the
+ * new handles and edge is added to the row of its target, then opened.
+ */
+void DistanceField::insert(const GraphTopology& topology,uint32_t edge){
+     if (inOffsets.empty()){
+          return;
+     }
+
+     for(uint32_t i=0; i < inEdges.size(); i++){
+          if (inEdges[i] >= edge){
+               inEdges[i]++;
+          }
+     }
+     uint32_t to = topology.getEdgeTarget(edge);
+     inEdges.insert(inEdges.begin() + inOffsets[to + 1],edge);
+     for(uint32_t n = to + 1; n < inOffsets.size(); n++){
+          inOffsets[n]++;
+     }
+     open(topology,edge);
+}
+
+size_t DistanceField::getBytes() const{
+     return distances.capacity() * sizeof(double) +
+          (nexts.capacity() + inOffsets.capacity() + inEdges.capacity()) * sizeof(uint32_t);
+}
+
+}
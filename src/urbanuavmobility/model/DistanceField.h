@@ -0,0 +1,73 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#ifndef DISTANCEFIELD_H_
+#define DISTANCEFIELD_H_
+
+#include "GraphTopology.h"
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+#include <utility>
+
+using namespace std;
+
+namespace ns3{
+
+/**
+ * \brief Shortest distances along the graph from every node to one target.
+ *
+ * build() runs Dijkstra from the target over the edges reversed, once, so
+ * the length of the shortest path from any node to the target and the
+ * first node on that path are then single array lookups. Following
+ * getNext() from a node walks the shortest path to the target. Closed
+ * edges are not used.
+ *
+ * When an edge is closed only the nodes whose shortest path used it are
+ * searched again, from their neighbours outside that set; when an edge is
+ * opened or inserted only the nodes it brings closer are. The incoming
+ * edges are kept between updates for that.
+ */
+class DistanceField {
+private:
+     uint32_t target;
+     vector<double> distances; // indexed by node handle, meters, INFINITY when the target cannot be reached
+     vector<uint32_t> nexts;   // indexed by node handle, NONE at the target and where it cannot be reached
+     vector<uint32_t> inOffsets; // incoming edges of every node, in the form of GraphTopology
+     vector<uint32_t> inEdges;
+     vector<pair<double,uint32_t> > frontier;
+
+     void settle(const GraphTopology& topology);
+
+public:
+     DistanceField();
+     void build(const GraphTopology& topology,uint32_t target);
+     void close(const GraphTopology& topology,uint32_t edge);
+     void open(const GraphTopology& topology,uint32_t edge);
+     void insert(const GraphTopology& topology,uint32_t edge);
+     uint32_t getTarget() const { return target; }
+     bool isReachable(uint32_t node) const { return node < nexts.size() && (node == target || nexts[node] != GraphTopology::NONE); }
+     double getDistance(uint32_t node) const { return distances[node]; }
+     uint32_t getNext(uint32_t node) const { return nexts[node]; }
+     size_t getBytes() const;
+};
+
+}
+
+#endif /* DISTANCEFIELD_H_ */
@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#include "EdgeQueue.h"
+
+using namespace std;
+
+namespace ns3{
+
+EdgeQueue::EdgeQueue() {
+}
+
+/* Puts edges 0 .. edgeCount-1 in the queue, all with the same key. */
+void EdgeQueue::build(uint32_t edgeCount,double key){
+     heap.resize(edgeCount);
+     position.resize(edgeCount);
+     keys.assign(edgeCount,key);
+     for(uint32_t e=0; e < edgeCount; e++){
+          heap[e] = e;
+          position[e] = e;
+     }
+}
+
+void EdgeQueue::update(uint32_t edge,double key){
+     double old = keys[edge];
+     keys[edge] = key;
+     if (key < old){
+          siftUp(position[edge]);
+     }
+     else if (key > old){
+          siftDown(position[edge]);
+     }
+}
+
+/*
+ * Adds an edge at handle edge, the edges from it on moving up by one. The
+ * order of the others is kept, so the heap only needs the new edge sifted.
+ */
+void EdgeQueue::insert(uint32_t edge,double key){
+     for(uint32_t i=0; i < heap.size(); i++){
+          if (heap[i] >= edge){
+               heap[i]++;
+          }
+     }
+     position.insert(position.begin() + edge,heap.size());
+     keys.insert(keys.begin() + edge,key);
+     heap.push_back(edge);
+     siftUp(heap.size() - 1);
+}
+
+size_t EdgeQueue::getBytes() const{
+     return heap.capacity() * sizeof(uint32_t) + position.capacity() * sizeof(uint32_t) + keys.capacity() * sizeof(double);
+}
+
+bool EdgeQueue::less(uint32_t a,uint32_t b) const{
+     return keys[a] < keys[b] || (keys[a] == keys[b] && a < b);
+}
+
+void EdgeQueue::swap(uint32_t i,uint32_t j){
+     uint32_t edge = heap[i];
+     heap[i] = heap[j];
+     heap[j] = edge;
+     position[heap[i]] = i;
+     position[heap[j]] = j;
+}
+
+void EdgeQueue::siftUp(uint32_t i){
+     while (i > 0){
+          uint32_t parent = (i - 1) / 2;
+          if (!less(heap[i],heap[parent])){
+               return;
+          }
+          swap(i,parent);
+          i = parent;
+     }
+}
+
+void EdgeQueue::siftDown(uint32_t i){
+     uint32_t n = heap.size();
+     while (true){
+          uint32_t smallest = i;
+          uint32_t left = 2 * i + 1;
+          uint32_t right = left + 1;
+          if (left < n && less(heap[left],heap[smallest])){
+               smallest = left;
+          }
+          if (right < n && less(heap[right],heap[smallest])){
+               smallest = right;
+          }
+          if (smallest == i){
+               return;
+          }
+          swap(i,smallest);
+          i = smallest;
+     }
+}
+
+}
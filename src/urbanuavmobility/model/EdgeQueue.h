@@ -0,0 +1,63 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#ifndef EDGEQUEUE_H_
+#define EDGEQUEUE_H_
+
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+namespace ns3{
+
+/**
+ * \brief Indexed binary min-heap of edge handles.
+ *
+ * Every edge of a graph is in the queue with a key; update() moves an edge
+ * to its new key in O(log E) and top() is the edge with the smallest key,
+ * the lowest handle among equal keys. insert() follows an edge inserted
+ * into the topology in O(E), as the handles above it move up.
+ */
+class EdgeQueue {
+private:
+     vector<uint32_t> heap;     // edge handles in heap order
+     vector<uint32_t> position; // indexed by edge handle, slot in heap
+     vector<double> keys;       // indexed by edge handle
+
+     bool less(uint32_t a,uint32_t b) const;
+     void swap(uint32_t i,uint32_t j);
+     void siftUp(uint32_t i);
+     void siftDown(uint32_t i);
+
+public:
+     EdgeQueue();
+     void build(uint32_t edgeCount,double key);
+     void update(uint32_t edge,double key);
+     void insert(uint32_t edge,double key);
+     bool isEmpty() const { return heap.empty(); }
+     uint32_t top() const { return heap[0]; }
+     double topKey() const { return keys[heap[0]]; }
+     double getKey(uint32_t edge) const { return keys[edge]; }
+     size_t getBytes() const;
+};
+
+}
+
+#endif /* EDGEQUEUE_H_ */
@@ -20,8 +20,8 @@
 #include "Graph.h"
 #include <iostream>
 #include <cstdlib>
-#include <time.h>
 #include <sstream>
+#include <algorithm>
 
 using namespace std;
 
@@ -29,227 +29,467 @@ namespace ns3{
 
 
 Graph::Graph() {
-     rootNode = NULL;
-	stepWalkNode = NULL;
-     selectionStrategy = "random";
+     data = Create<GraphData>();
+     topology = &data->getTopology();
+     rootNode = GraphTopology::NONE;
+     returnField = NULL;
+     hierarchy = NULL;
+     changesSeen = 0;
+	stepWalkNode = GraphTopology::NONE;
+     blackboardSubscriber = 0;
+     territory = 0;
+     policy = RANDOM_SELECTION;
+     lookaheadDepth = getLookaheadDepth("");
+     random = CreateObject<UniformRandomVariable>();
 }
 
 Graph::Graph(string strategy) {
-     rootNode = NULL;
-	stepWalkNode = NULL;
-     selectionStrategy = strategy;
+     data = Create<GraphData>();
+     topology = &data->getTopology();
+     rootNode = GraphTopology::NONE;
+     returnField = NULL;
+     hierarchy = NULL;
+     changesSeen = 0;
+	stepWalkNode = GraphTopology::NONE;
+     blackboardSubscriber = 0;
+     territory = 0;
+     policy = getSelectionPolicy(strategy);
+     lookaheadDepth = getLookaheadDepth(strategy);
+     random = CreateObject<UniformRandomVariable>();
 }
 
-SelectionStrategy* Graph::getSelectionStrategy(string nodeId){
-     srand(time(NULL));
-     if(selectionStrategy.compare("leastvisited") == 0){
-          return new LeastVisitedEdgesSelection(nodeId,this);
-     }
+string Graph::getBinaryFile(string file){
+     return GraphData::getBinaryFile(file);
+}
 
-     return new RandomSelection();
+bool Graph::convert(char* file){
+     return GraphData::convert(file);
 }
 
 void Graph::load(char* file){
-	xmlDocPtr doc;
-	xmlNodePtr cur;
+     Ptr<GraphData> loaded = GraphData::load(file);
+     if (loaded == 0){
+          return;
+     }
 
-	doc = xmlParseFile(file);
+     load(loaded);
+}
 
-	if (doc == NULL ) {
-		cout << "Not parsed" << endl;
-		return;
-	}
+/*
+ * Walks loaded from now on, with no visits yet. A root that is not a node
+ * of loaded is replaced by its base.
+ */
+void Graph::load(Ptr<GraphData> loaded){
+     data = loaded;
+     changesSeen = data->getChangeCount();
+     topology = &data->getTopology();
+     edgesStats.assign(topology->getEdgeCount(),EdgeStats());
+     stepWalkNode = GraphTopology::NONE;
+     returnField = NULL;
+     hierarchy = NULL;
+     blackboard = 0;
+     territories = 0;
+     if (policy == GLOBAL_LEAST_VISITED_SELECTION)
+          globalSelection.reset(*topology);
+     if (policy == LOOKAHEAD_SELECTION)
+          lookaheadSelection.reset(*topology,lookaheadDepth);
+     if (policy == TOUR_SELECTION)
+          tourSelection.reset(data->getTour());
+
+     if (rootNode == GraphTopology::NONE || rootNode >= topology->getNodeCount())
+          rootNode = topology->getBase();
+}
 
-	cur = xmlDocGetRootElement(doc);
+/*
+ * Fixes the stream the selection strategy draws from, so walks can be
+ * repeated and compared across strategies. Returns the number of streams
+ * used.
+ */
+int64_t Graph::assignStreams(int64_t stream){
+     random->SetStream(stream);
+     return 1;
+}
 
+/*
+ * Shares visits with the other Graphs of board, which must have been made
+ * for the data of this Graph. Visits already on the board are taken and
+ * visits of this Graph not on it yet are published.
+ */
+bool Graph::shareVisits(Ptr<VisitBlackboard> board){
+     if (board == 0 || board->getData() != PeekPointer(data)){
+          return false;
+     }
 
-	if (cur == NULL) {
-		cout << "Empty document" << endl;
-		xmlFreeDoc(doc);
-		return;
-	}
+     collectChanges();
+     board->update();
+     blackboard = board;
+     blackboardSubscriber = board->subscribe();
+     for(uint32_t e=0; e < edgesStats.size(); e++){
+          if (board->getCount(e) > edgesStats[e].count){
+               recordVisit(e,board->getLastVisit(e),board->getCount(e));
+          }
+          else if (edgesStats[e].count > board->getCount(e)){
+               board->publish(e,edgesStats[e].count,edgesStats[e].lastVisit);
+          }
+     }
+     return true;
+}
 
+/* Takes the visits other Graphs published with a larger count. */
+void Graph::collectVisits(){
+     if (blackboard == 0){
+          return;
+     }
 
+     blackboardEdges.clear();
+     blackboard->collect(blackboardSubscriber,blackboardEdges);
+     for(uint32_t i=0; i < blackboardEdges.size(); i++){
+          uint32_t e = blackboardEdges[i];
+          if (blackboard->getCount(e) > edgesStats[e].count){
+               recordVisit(e,blackboard->getLastVisit(e),blackboard->getCount(e));
+          }
+     }
+}
 
-	if (xmlStrcmp(cur->name, (const xmlChar *) "graph") != 0) {
-		cout << "document of the wrong type, root node != graph" << endl;
-		xmlFreeDoc(doc);
-		return;
-	}
-	else {
-		xmlNodePtr node = cur->xmlChildrenNode;
+/*
+ * Restricts the walk to the edges territory owns in map, which must have
+ * been made for the data of this Graph, and starts it from the root of the
+ * territory. The territory's choice replaces the selection policy of the
+ * Graph, which only decides when no owned edge can be reached.
+ */
+bool Graph::setTerritory(Ptr<TerritoryMap> map,uint32_t territory){
+     if (map == 0 || map->getData() != PeekPointer(data) || territory >= map->getTerritoryCount()){
+          return false;
+     }
+
+     collectChanges();
+     map->update();
+     territories = map;
+     this->territory = territory;
+     territorySelection.reset(*topology);
+     if (map->getRoot(territory) != GraphTopology::NONE){
+          rootNode = map->getRoot(territory);
+          returnField = NULL;
+     }
+     return true;
+}
 
-		while (node != NULL){
+/* Lends the territory to its neighbours while the UAV is away from it. */
+void Graph::setTerritoryPresence(bool present){
+     if (territories != 0){
+          territories->setPresent(territory,present);
+     }
+}
 
-			if (xmlStrcmp(node->name, (const xmlChar *) "nodes") == 0) {
-				parseNodes(node);
-			}
+/*
+ * Follows the changes made to the data since the last call. After an
+ * added edge the visit statistics and the state of the strategies move to
+ * the new handles, keeping what they learnt of the other edges; after any
+ * change the routes being followed are dropped, so the next step plans
+ * around closed streets.
+ */
+void Graph::collectChanges(){
+     uint32_t count = data->getChangeCount();
+     if (changesSeen == count){
+          return;
+     }
 
-			if (xmlStrcmp(node->name, (const xmlChar *) "edges") == 0) {
-				parseEdges(node);
-			}
+     if (blackboard != 0)
+          blackboard->update();
+     if (territories != 0)
+          territories->update();
+
+     // the selections see the topology as it is now, so the handles logged
+     // before an addition are moved up with it
+     vector<uint32_t> changed;
+     vector<uint32_t> added;
+     for(; changesSeen < count; changesSeen++){
+          const GraphChange& change = data->getChange(changesSeen);
+          if (change.type == EDGE_ADDED){
+               edgesStats.insert(edgesStats.begin() + change.edge,EdgeStats());
+               for(uint32_t i=0; i < changed.size(); i++){
+                    if (changed[i] >= change.edge)
+                         changed[i]++;
+               }
+               for(uint32_t i=0; i < added.size(); i++){
+                    if (added[i] >= change.edge)
+                         added[i]++;
+               }
+               added.push_back(change.edge);
+          }
+          else {
+               changed.push_back(change.edge);
+          }
+     }
 
-			node = node->next;
-		}
+     sort(added.begin(),added.end());
+     if (policy == GLOBAL_LEAST_VISITED_SELECTION){
+          for(uint32_t i=0; i < added.size(); i++){
+               globalSelection.insert(added[i]);
+          }
+     }
+     if (policy == LOOKAHEAD_SELECTION){
+          lookaheadSelection.insert(added);
+          for(uint32_t i=0; i < changed.size(); i++){
+               lookaheadSelection.update(changed[i],edgesStats[changed[i]]);
+          }
+     }
 
-		xmlFreeDoc(doc);
-	}
+     globalSelection.clearRoute();
+     territorySelection.clearRoute();
+     if (policy == TOUR_SELECTION)
+          tourSelection.reset(data->getTour());
+}
+
+uint32_t Graph::getEdge(string from,string to){
+     return topology->findEdge(topology->find(from),topology->find(to));
+}
 
+void Graph::print(){
+	for(uint32_t i=0; i < topology->getNodeCount(); i++){
+		getNode(i).print();
+	}
 }
 
-void Graph::parseNodes(xmlNodePtr root){
-	cout << "parsing nodes" << endl;
-	xmlNodePtr node = root->xmlChildrenNode;
-	while (node != NULL){
-		if (xmlStrcmp(node->name, (const xmlChar *) "node") == 0) {
-			parseNode(node);
+void Graph::walk(int steps,Visitor* visitor){
+	switch(policy){
+	case LEAST_VISITED_SELECTION:
+		walk<LeastVisitedEdgesSelection>(steps,visitor);
+		break;
+	case GLOBAL_LEAST_VISITED_SELECTION:
+	case LOOKAHEAD_SELECTION:
+	case TOUR_SELECTION: {
+		uint32_t current = rootNode;
+		for(int i=0; i < steps; i++){
+			GraphNode node(topology,current);
+			visitor->accept(&node);
+			current = next(current);
 		}
-		node = node->next;
+		break;
 	}
+	default:
+		walk<RandomSelection>(steps,visitor);
+	}
+}
 
-     if (rootNode == NULL)
-     	rootNode = nodes.begin()->second;
+void Graph::stepWalk(Visitor* visitor){
+	if(stepWalkNode == GraphTopology::NONE){
+		stepWalkNode = rootNode;
+	}
+	else {
+		stepWalkNode = next(stepWalkNode);
+	}
+
+	GraphNode node(topology,stepWalkNode);
+	node.print();
+	visitor->accept(&node);
 }
 
-void Graph::parseEdges(xmlNodePtr root){
-	cout << "parsing edges" << endl;
-	xmlNodePtr edge = root->xmlChildrenNode;
+uint32_t Graph::next(uint32_t node){
+	collectChanges();
+	collectVisits();
 
-	while (edge != NULL){
-		if (xmlStrcmp(edge->name, (const xmlChar *) "edge") == 0) {
-			parseEdge(edge);
+	if(territories != 0 && topology->getOpenDegree(node) > 0){
+		uint32_t chosen = territorySelection.select(*topology,edgesStats,*random,node,*territories,territory);
+		if(chosen != GraphTopology::NONE){
+			return chosen;
 		}
-		edge = edge->next;
 	}
-}
 
-void Graph::parseNode(xmlNodePtr node){
-	string id ((const char*) xmlGetProp(node,(const xmlChar*) "id"));
-	double x = atof((const char*) xmlGetProp(node,(const xmlChar*) "x"));
-	double y = atof((const char*)  xmlGetProp(node,(const xmlChar*) "y"));
-
-	//nodes[id] = new GraphNode(id,x,y,new RandomSelection());
-     nodes[id] = new GraphNode(id,x,y,getSelectionStrategy(id));
+	switch(policy){
+	case LEAST_VISITED_SELECTION:
+		return next<LeastVisitedEdgesSelection>(node);
+	case GLOBAL_LEAST_VISITED_SELECTION:
+		if(topology->getOpenDegree(node) == 0){
+			return node;
+		}
+		return globalSelection.select(*topology,edgesStats,*random,node);
+	case LOOKAHEAD_SELECTION:
+		if(topology->getOpenDegree(node) == 0){
+			return node;
+		}
+		return lookaheadSelection.select(*topology,edgesStats,*random,node);
+	case TOUR_SELECTION: {
+		uint32_t chosen = tourSelection.select(node);
+		if(chosen != GraphTopology::NONE){
+			return chosen;
+		}
+		return next<RandomSelection>(node);
+	}
+	default:
+		return next<RandomSelection>(node);
+	}
+}
 
-     if (xmlGetProp(node,(const xmlChar*) "type") == NULL) return;
+void Graph::setRoot(GraphNode node){
+	if (node.isValid()){
+		rootNode = node.getIndex();
+		returnField = NULL;
+	}
+}
 
-     string type ((const char*) xmlGetProp(node,(const xmlChar*) "type"));
-     if ( type.compare("base") == 0 ){
-          rootNode = nodes[id];
-     }
+/*
+ * Distances along the graph from every node back to the root, shared with
+ * the other Graphs of the same data returning to the same root.
+ */
+const DistanceField& Graph::getReturnField(){
+	if (returnField == NULL){
+		returnField = &data->getDistanceField(rootNode);
+	}
+	return *returnField;
 }
 
-void Graph::parseEdge(xmlNodePtr node){
+/*
+ * Routes over the contraction hierarchy of the data from now on, built on
+ * the first call for the data and shared with the other Graphs of it.
+ */
+void Graph::prepareRoutes(){
+	hierarchy = &data->getContractionHierarchy();
+}
 
-	string from((const char*) xmlGetProp(node,(const xmlChar*) "from"));
-	string to((const char*) xmlGetProp(node,(const xmlChar*) "to"));
+/*
+ * Shortest path from one node to another: the nodes in path, from and to
+ * included, and its length in meters, INFINITY if to cannot be reached.
+ * Once streets are added the hierarchy misses them, and A* is used until
+ * the data rebuilds it.
+ */
+double Graph::route(uint32_t from,uint32_t to,vector<uint32_t>& path){
+	collectChanges();
+	if (hierarchy != NULL && data->isHierarchyCurrent()){
+		double length = router.route(*hierarchy,from,to,path);
+		if (topology->getClosedCount() == 0){
+			return length;
+		}
 
-	if(nodes.count(from) > 0 && nodes.count(to) > 0){
-		nodes[from]->addNode(nodes[to]);
-          edgesVisitCount[getEdgeId(from,to)] = 0;
+		// closing edges only makes paths longer, so a shortest path
+		// without closed edges is still the shortest
+		bool open = true;
+		for(uint32_t i=0; i + 1 < path.size() && open; i++){
+			uint32_t edge = topology->findEdge(path[i],path[i+1]);
+			open = edge != GraphTopology::NONE && topology->isOpen(edge);
+		}
+		if (open){
+			return length;
+		}
 	}
-
+	return router.route(*topology,from,to,path);
 }
 
-string Graph::getEdgeId(string from,string to){
-     stringstream id;
-     id << from << "->" << to;
-     return id.str();
+GraphNode Graph::getRoot(){
+	return GraphNode(topology,rootNode);
 }
 
-void Graph::print(){
-	map<string,GraphNode*>::iterator iter;
-	for(iter = nodes.begin(); iter != nodes.end(); iter++){
-		iter->second->print();
-	}
+GraphNode Graph::getNode(uint32_t node){
+	return GraphNode(topology,node);
 }
 
-void Graph::walk(int steps,Visitor* visitor){
-	rootNode->walk(steps,0,visitor);
+const GraphTopology& Graph::getTopology(){
+	return *topology;
 }
 
-void Graph::stepWalk(Visitor* visitor){
-	if(stepWalkNode == NULL){
-		stepWalkNode = rootNode;
+GraphNode Graph::findNearest(double x,double y){
+	uint32_t node = data->getNodeGrid().nearest(x,y);
+	if (node == GraphTopology::NONE){
+		return GraphNode(topology,rootNode);
 	}
-	else {
-		stepWalkNode = stepWalkNode->next();
+
+	// the root wins ties, as it did with the linear scan
+	if (getNode(rootNode).distance(x,y) <= getNode(node).distance(x,y)){
+		node = rootNode;
 	}
-	stepWalkNode->print();
-	visitor->accept(stepWalkNode);
+
+	return GraphNode(topology,node);
 }
 
-void Graph::setRoot(GraphNode* node){
-	if (node != NULL){
-		rootNode = node;
+vector<GraphNode> Graph::findNearest(double x,double y,int k){
+	vector<uint32_t> found = data->getNodeGrid().nearest(x,y,k);
+	vector<GraphNode> nodes;
+	for(int i=0; i < (int) found.size(); i++){
+		nodes.push_back(GraphNode(topology,found[i]));
 	}
+	return nodes;
 }
 
-GraphNode* Graph::getRoot(){
-	return rootNode;
+vector<GraphNode> Graph::findWithin(double x,double y,double radius){
+	vector<uint32_t> found = data->getNodeGrid().within(x,y,radius);
+	vector<GraphNode> nodes;
+	for(int i=0; i < (int) found.size(); i++){
+		nodes.push_back(GraphNode(topology,found[i]));
+	}
+	return nodes;
 }
 
-GraphNode* Graph::findNearest(double x,double y){
-	GraphNode* node = rootNode;
+void Graph::recordVisit(uint32_t edge,double time,int count){
+     EdgeStats& stats = edgesStats[edge];
+     stats.count = count;
 
-	map<string,GraphNode*>::iterator iter;
-	for(iter = nodes.begin(); iter != nodes.end(); iter++){
-		if (iter->second->distance(x,y) < node->distance(x,y)){
-			node = iter->second;
-		}
-	}
+     if (stats.visits == 0){
+          stats.firstVisit = time;
+     }
+     if (time - stats.lastVisit > stats.worstIdleness){
+          stats.worstIdleness = time - stats.lastVisit;
+     }
+     stats.lastVisit = time;
+     stats.visits++;
 
-	return node;
+     if (policy == GLOBAL_LEAST_VISITED_SELECTION)
+          globalSelection.update(edge,stats);
+     if (policy == LOOKAHEAD_SELECTION)
+          lookaheadSelection.update(edge,stats);
 }
 
-void Graph::markEdge(string from,string to, double time){
-     string edgeId = getEdgeId(from,to);
-     if (edgesVisitCount.count(edgeId) != 0){
-          edgesVisitCount[edgeId]++;
-          edgesVisitTime[edgeId].push_back(time);     
+void Graph::markEdge(uint32_t from,uint32_t to, double time){
+     collectChanges();
+     uint32_t edge = topology->findEdge(from,to);
+     if (edge != GraphTopology::NONE){
+          recordVisit(edge,time,edgesStats[edge].count + 1);
+          if (blackboard != 0)
+               blackboard->publish(edge,edgesStats[edge].count,time);
      }
 
-     string edgeIdReverse = getEdgeId(to,from);
-     if (edgesVisitCount.count(edgeIdReverse) != 0){
-          edgesVisitCount[edgeIdReverse]++;     
-          edgesVisitTime[edgeIdReverse].push_back(time);
+     uint32_t edgeReverse = edge != GraphTopology::NONE ? topology->getReverseEdge(edge) : topology->findEdge(to,from);
+     if (edgeReverse != GraphTopology::NONE){
+          recordVisit(edgeReverse,time,edgesStats[edgeReverse].count + 1);
+          if (blackboard != 0)
+               blackboard->publish(edgeReverse,edgesStats[edgeReverse].count,time);
      }
 }
 
+void Graph::markEdge(string from,string to, double time){
+     markEdge(topology->find(from),topology->find(to),time);
+}
+
 void Graph::markEdge(string from,string to, double time, int count){
-     string edgeId = getEdgeId(from,to);
-     if (edgesVisitCount.count(edgeId) != 0){
-          edgesVisitCount[edgeId] = count;
-          edgesVisitTime[edgeId].push_back(time);     
+     collectChanges();
+     uint32_t edge = getEdge(from,to);
+     if (edge != GraphTopology::NONE){
+          recordVisit(edge,time,count);
      }
 
-     string edgeIdReverse = getEdgeId(to,from);
-     if (edgesVisitCount.count(edgeIdReverse) != 0){
-          edgesVisitCount[edgeIdReverse] = count;     
-          edgesVisitTime[edgeIdReverse].push_back(time);
+     uint32_t edgeReverse = getEdge(to,from);
+     if (edgeReverse != GraphTopology::NONE){
+          recordVisit(edgeReverse,time,count);
      }
 }
 
 
 int Graph::getEdgeVisitCount(string from,string to){
-     return edgesVisitCount[getEdgeId(from,to)];
+     collectChanges();
+     uint32_t edge = getEdge(from,to);
+     if (edge == GraphTopology::NONE){
+          return 0;
+     }
+     return edgesStats[edge].count;
 }
 
 double Graph::getAverageIdleness(){
      double totalIdleTime = 0;     
      double totalVisits = 0;
-     double lastIdleTime;
-
-     for(map<string,vector<double> >::iterator iter = edgesVisitTime.begin(); iter != edgesVisitTime.end(); iter++){
-          vector<double>& edgeVisitTimes = iter->second;
-
-          lastIdleTime = 0;
-          for(int i=0; i < (int) edgeVisitTimes.size(); i++){
-               totalIdleTime += edgeVisitTimes[i] - lastIdleTime;
-               lastIdleTime = edgeVisitTimes[i];
-          }
 
-          totalVisits += edgeVisitTimes.size();
+     // the gaps between the visits of an edge add up to its last visit time
+     for(int i=0; i < (int) edgesStats.size(); i++){
+          totalIdleTime += edgesStats[i].lastVisit;
+          totalVisits += edgesStats[i].visits;
      }
 
      if(totalVisits == 0) return 0;
@@ -257,22 +497,11 @@ double Graph::getAverageIdleness(){
 }
 
 double Graph::getWorstIdleness(){
-     double idleTime;
-     double lastIdleTime;
      double worstIdleTime = 0;
 
-     for(map<string,vector<double> >::iterator iter = edgesVisitTime.begin(); iter != edgesVisitTime.end(); iter++){
-          vector<double>& edgeVisitTimes = iter->second;
-
-          lastIdleTime = 0;
-          for(int i=0; i < (int) edgeVisitTimes.size(); i++){
-               idleTime = edgeVisitTimes[i] - lastIdleTime;
-
-               if (idleTime > worstIdleTime){
-                    worstIdleTime = idleTime;
-               }
-
-               lastIdleTime = edgeVisitTimes[i];
+     for(int i=0; i < (int) edgesStats.size(); i++){
+          if (edgesStats[i].worstIdleness > worstIdleTime){
+               worstIdleTime = edgesStats[i].worstIdleness;
           }
      }
 
@@ -282,14 +511,16 @@ double Graph::getWorstIdleness(){
 string Graph::getEdgeCoverageTimings(){
      stringstream result;
 
-     for(map<string,vector<double> >::iterator iter = edgesVisitTime.begin(); iter != edgesVisitTime.end(); iter++){
-          vector<double>& edgeVisitTimes = iter->second;
-          result << "(" << iter->first << "," ;
-          if( ((int) edgeVisitTimes.size()) > 0){
-               result << edgeVisitTimes[0];
+     const vector<uint32_t>& edgesOrder = data->getEdgesOrder();
+     for(int i=0; i < (int) edgesOrder.size(); i++){
+          uint32_t edge = edgesOrder[i];
+          if (edgesStats[edge].visits == 0){
+               continue;
           }
 
-          result << "),";
+          result << "(" << topology->getId(topology->getEdgeSource(edge)) << "->"
+                 << topology->getId(topology->getEdgeTarget(edge)) << ","
+                 << edgesStats[edge].firstVisit << "),";
      }
 
      return result.str();
@@ -297,44 +528,48 @@ string Graph::getEdgeCoverageTimings(){
 
 
 string Graph::stats(){
+     collectChanges();
      stringstream stats;
 
      int totalVisitCount = 0;
      int unvisitedEdges = 0;
-     for(map<string,int>::iterator iter = edgesVisitCount.begin(); iter != edgesVisitCount.end(); iter++){
-          totalVisitCount += iter->second;
-          if (iter->second == 0){
+     int totalEdges = (int) edgesStats.size();
+     for(int i=0; i < totalEdges; i++){
+          totalVisitCount += edgesStats[i].count;
+          if (edgesStats[i].count == 0){
                unvisitedEdges++;
           }
      }
 
-     float visitsPerEdges = ((float) totalVisitCount) / edgesVisitCount.size();
+     float visitsPerEdges = ((float) totalVisitCount) / totalEdges;
      stats << "total visits:" << totalVisitCount << ";" ;
      stats << "visits per edges:" << visitsPerEdges << ";" ;
      stats << "unvisited edges:" << unvisitedEdges << ";" ;
-     stats << "total edges:" << edgesVisitCount.size() << ";" ;
-     stats << "coverage:" << ((float) (edgesVisitCount.size() - unvisitedEdges) / edgesVisitCount.size()) * 100 << ";";
+     stats << "total edges:" << totalEdges << ";" ;
+     stats << "coverage:" << ((float) (totalEdges - unvisitedEdges) / totalEdges) * 100 << ";";
      stats << "average idleness:" << getAverageIdleness() << ";";
      stats << "worst idleness:" << getWorstIdleness() << ";";
      stats << "edge coverage timings:" << getEdgeCoverageTimings() << ";";
+     if (policy == LOOKAHEAD_SELECTION){
+          stats << "lookahead depth:" << lookaheadSelection.getDepth() << ";";
+          stats << "decisions:" << lookaheadSelection.getDecisions() << ";";
+          stats << "average decision latency:" << lookaheadSelection.getAverageLatency() << "us;";
+          stats << "worst decision latency:" << lookaheadSelection.getWorstLatency() << "us;";
+     }
+     if (policy == TOUR_SELECTION){
+          stats << "tour length:" << data->getTour().getLength() << ";";
+          stats << "tour nodes:" << data->getTour().getSize() << ";";
+     }
      return stats.str();
 }
 
 bool Graph::lineEdgesIntersect(Vector p1,Vector p2){
-	for(map<string,GraphNode*>::iterator iter = nodes.begin(); iter != nodes.end(); iter++){
-		GraphNode* node = iter->second;
-          if (node->lineEdgesIntersect(p1,p2)){
-               return true;
-          }
-	}
-
-	return false;
+	return data->getEdgeGrid().intersects(p1,p2);
 }
 
 bool Graph::pointExists(float x,float y){
-	for(map<string,GraphNode*>::iterator iter = nodes.begin(); iter != nodes.end(); iter++){
-		GraphNode* node = iter->second;
-          if (node->pointExists(x,y)){
+	for(uint32_t i=0; i < topology->getNodeCount(); i++){
+          if (getNode(i).pointExists(x,y)){
                return true;
           }
 	}
@@ -343,41 +578,23 @@ bool Graph::pointExists(float x,float y){
 }
 
 Region Graph::spanningArea(){
-	vector<float> x;
-	vector<float> y;
-	for(map<string,GraphNode*>::iterator iter = nodes.begin(); iter != nodes.end(); iter++){
-		x.push_back(iter->second->getX());
-		y.push_back(iter->second->getY());
-	}
-
-	return Region(Util::min(x),Util::min(y),Util::max(x),Util::max(y));
+	return data->spanningArea();
 }
 
-vector<Region> Graph::decompose(float w,float l){
-     vector<Region> markedCells;
-	vector<Region> cells = spanningArea().decompose(w,l);
-
-	for(int j=0; j < (int) cells.size(); j++){
-		for(map<string,GraphNode*>::iterator iter = nodes.begin(); iter != nodes.end(); iter++){
-               GraphNode* node = iter->second;
-               if(cells[j].getColor() == 0 &&
-                     node->cellExists(cells[j]) ) {
-
-                    cells[j].mark(1);
-//                    markedCells.push_back(cells[j]);
-               }
-		}
-	}
-
-//	return markedCells;
-     return cells;
+CoverageGrid Graph::decompose(float w,float l){
+     return data->decompose(w,l);
 }
 
 string Graph::getEdgesVisitCount(){
+     collectChanges();
      stringstream stats;
 
-     for(map<string,int>::iterator iter = edgesVisitCount.begin(); iter != edgesVisitCount.end(); iter++){
-          stats << iter->first << ":" << iter->second << ";" ;
+     const vector<uint32_t>& edgesOrder = data->getEdgesOrder();
+     for(int i=0; i < (int) edgesOrder.size(); i++){
+          uint32_t edge = edgesOrder[i];
+          stats << topology->getId(topology->getEdgeSource(edge)) << "->"
+                << topology->getId(topology->getEdgeTarget(edge)) << ":"
+                << edgesStats[edge].count << ";" ;
      }
 
      return stats.str();
@@ -386,7 +603,6 @@ string Graph::getEdgesVisitCount(){
 
 
 Graph::~Graph() {
-	// TODO Auto-generated destructor stub
 }
 
 }
@@ -21,8 +21,14 @@
 #define GRAPH_H_
 
 #include "GraphNode.h"
+#include "GraphTopology.h"
+#include "GraphData.h"
+#include "SelectionStrategy.h"
+#include "VisitBlackboard.h"
+#include "Router.h"
+#include "CoverageGrid.h"
 #include "Visitor.h"
-#include <libxml/parser.h>
+#include "ns3/ptr.h"
 #include <map>
 #include <vector>
 #include <string>
@@ -32,51 +38,119 @@ using namespace std;
 
 namespace ns3{
 
+/**
+ * \brief Graph walked by one UAV.
+ *
+ * The topology and its indexes live in a GraphData shared by every Graph
+ * loaded from the same file; a Graph only adds the walk state and the
+ * visit statistics of its own UAV.
+ *
+ * A Graph can also walk data that was never a file, such as a subgraph()
+ * of the one it walks, given to load().
+ *
+ * Streets closed, opened or added on the data while the UAV patrols are
+ * followed before its next step or route: the walk keeps to open edges,
+ * and the route it was following is planned again.
+ */
 class Graph {
 private:
-	map<string,GraphNode*> nodes;
-     map<string,int> edgesVisitCount;
-     map<string,vector<double> > edgesVisitTime; // seconds
-	GraphNode* rootNode;
-     string selectionStrategy;
-
-	void parseNodes(xmlNodePtr);
-	void parseEdges(xmlNodePtr);
-	void parseNode(xmlNodePtr);
-	void parseEdge(xmlNodePtr);
+     Ptr<GraphData> data;          // shared with every Graph loaded from the same file
+     const GraphTopology* topology;
+     vector<EdgeStats> edgesStats; // indexed by edge handle
+	uint32_t rootNode;
+     const DistanceField* returnField; // to the root, NULL until first used
+     SelectionPolicy policy;
+     Ptr<UniformRandomVariable> random; // drives the selection strategy
+     GlobalLeastVisitedSelection globalSelection; // only reset for GLOBAL_LEAST_VISITED_SELECTION
+     LookaheadSelection lookaheadSelection;       // only reset for LOOKAHEAD_SELECTION
+     TourSelection tourSelection;                 // only reset for TOUR_SELECTION
+     int lookaheadDepth;
+     Ptr<VisitBlackboard> blackboard;    // visits shared with other Graphs, 0 when not shared
+     uint32_t blackboardSubscriber;
+     vector<uint32_t> blackboardEdges;
+     Ptr<TerritoryMap> territories;     // 0 when the whole graph is walked
+     uint32_t territory;
+     TerritorySelection territorySelection;
+     Router router;
+     const ContractionHierarchy* hierarchy; // NULL until prepareRoutes(), routes then use A*
+     uint32_t changesSeen;                  // changes of the data followed so far
 
-     string getEdgeId(string from,string to);
+     uint32_t getEdge(string from,string to);
+     void recordVisit(uint32_t edge,double time,int count);
+     void collectVisits();
+     void collectChanges();
 
      double getAverageIdleness();
      double getWorstIdleness();
      string getEdgeCoverageTimings();
 
-     SelectionStrategy* getSelectionStrategy(string nodeId);     
+     template <class Strategy> uint32_t next(uint32_t node);
+     template <class Strategy> void walk(int steps,Visitor* visitor);
 
-	GraphNode* stepWalkNode;
+	uint32_t stepWalkNode;
 
 public:
 	Graph();
 	Graph(string);
 	void load(char* file);
+	void load(Ptr<GraphData> loaded);
+	int64_t assignStreams(int64_t stream);
+	bool shareVisits(Ptr<VisitBlackboard> board);
+	bool setTerritory(Ptr<TerritoryMap> map,uint32_t territory);
+	void setTerritoryPresence(bool present);
+	static string getBinaryFile(string file);
+	static bool convert(char* file);
 	void print();
 	void walk(int steps, Visitor* visitor);
 	void stepWalk(Visitor* visitor);
-	void setRoot(GraphNode* node);
-	GraphNode* getRoot();
-	GraphNode* findNearest(double x,double y);
+	uint32_t next(uint32_t node);
+	void setRoot(GraphNode node);
+	GraphNode getRoot();
+	const DistanceField& getReturnField();
+	void prepareRoutes();
+	double route(uint32_t from,uint32_t to,vector<uint32_t>& path);
+	GraphNode getNode(uint32_t node);
+	const GraphTopology& getTopology();
+	GraphNode findNearest(double x,double y);
+	vector<GraphNode> findNearest(double x,double y,int k);
+	vector<GraphNode> findWithin(double x,double y,double radius);
      void markEdge(string from,string to,double time);
      void markEdge(string from,string to,double time,int count);
+     void markEdge(uint32_t from,uint32_t to,double time);
      int getEdgeVisitCount(string from,string to);
+     int getEdgeVisitCount(uint32_t edge) { return edgesStats[edge].count; }
      bool lineEdgesIntersect(Vector p1,Vector p2);
      bool pointExists(float x,float y);
      Region spanningArea();
-     vector<Region> decompose(float w,float l);     
+     CoverageGrid decompose(float w,float l);
+     Ptr<GraphData> subgraph(const vector<uint32_t>& nodes) const { return data->subgraph(nodes); }
+     Ptr<GraphData> subgraph(Region area) const { return data->subgraph(area); }
+     Ptr<GraphData> subgraph(const vector<Vector>& polygon) const { return data->subgraph(polygon); }
      string stats();
      string getEdgesVisitCount();
 	virtual ~Graph();
 };
 
+template <class Strategy>
+inline uint32_t Graph::next(uint32_t node){
+	collectChanges();
+	if(topology->getOpenDegree(node) == 0){
+		return node;
+	}
+
+	return Strategy::select(*topology,edgesStats,*random,node);
+}
+
+template <class Strategy>
+inline void Graph::walk(int steps,Visitor* visitor){
+	uint32_t current = rootNode;
+	for(int i=0; i < steps; i++){
+		GraphNode node(topology,current);
+		visitor->accept(&node);
+		current = next<Strategy>(current);
+	}
+}
+
 }
 
 #endif /* GRAPH_H_ */
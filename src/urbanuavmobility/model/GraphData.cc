@@ -0,0 +1,603 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#include "GraphData.h"
+#include "ns3/system-mutex.h"
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <algorithm>
+#include <sys/stat.h>
+
+using namespace std;
+
+namespace ns3{
+
+struct GraphCacheEntry {
+     Ptr<GraphData> data;
+     time_t modified;
+     off_t size;
+};
+
+static map<string,GraphCacheEntry> cache;
+static uint32_t cacheHits = 0;
+static uint32_t cacheMisses = 0;
+static SystemMutex cacheMutex; // graphs may be loaded from several threads
+
+/*
+ * The xml file identifies the graph; a converted graph shipped without
+ * its xml file is identified by the binary file instead.
+ */
+static bool getFileInfo(string file,struct stat& info){
+     return stat(file.c_str(),&info) == 0 ||
+          stat(GraphData::getBinaryFile(file).c_str(),&info) == 0;
+}
+
+GraphData::GraphData() {
+     index();
+}
+
+/*
+ * Returns the cached graph of the file if the file has not changed since it
+ * was loaded, otherwise loads it and replaces the cache entry. Graphs still
+ * using a replaced entry keep it. Returns 0 if the file cannot be loaded.
+ */
+Ptr<GraphData> GraphData::load(string file){
+     struct stat info;
+     bool exists = getFileInfo(file,info);
+
+     {
+          CriticalSection lock(cacheMutex);
+          map<string,GraphCacheEntry>::iterator entry = cache.find(file);
+          if (entry != cache.end() && exists &&
+                    entry->second.modified == info.st_mtime && entry->second.size == info.st_size){
+               cacheHits++;
+               return entry->second.data;
+          }
+          cacheMisses++;
+     }
+
+     Ptr<GraphData> data = Ptr<GraphData>(new GraphData(),false);
+
+     // a converted graph next to the xml file is mapped instead of parsed
+     if (!(isBinaryUpToDate(file) && data->topology.open(getBinaryFile(file).c_str())) &&
+               !data->loadXml(file.c_str())){
+          return 0;
+     }
+
+     data->index();
+     data->file = file;
+
+     if (exists){
+          CriticalSection lock(cacheMutex);
+          GraphCacheEntry loaded;
+          loaded.data = data;
+          loaded.modified = info.st_mtime;
+          loaded.size = info.st_size;
+          cache[file] = loaded;
+     }
+     return data;
+}
+
+void GraphData::clearCache(){
+     CriticalSection lock(cacheMutex);
+     cache.clear();
+     cacheHits = 0;
+     cacheMisses = 0;
+}
+
+string GraphData::getCacheStats(){
+     CriticalSection lock(cacheMutex);
+     size_t bytes = 0;
+     for(map<string,GraphCacheEntry>::iterator entry = cache.begin(); entry != cache.end(); entry++){
+          bytes += entry->second.data->getBytes();
+     }
+
+     stringstream stats;
+     stats << "graph cache hits:" << cacheHits << ";";
+     stats << "misses:" << cacheMisses << ";";
+     stats << "graphs:" << cache.size() << ";";
+     stats << "bytes:" << bytes << ";";
+     return stats.str();
+}
+
+size_t GraphData::getBytes() const{
+     size_t bytes = topology.getBytes() + nodeGrid.getBytes() + edgeGrid.getBytes() +
+          (edgesOrder.capacity() + parentNodes.capacity()) * sizeof(uint32_t);
+     for(map<pair<float,float>,CoverageGrid>::const_iterator cells = decompositions.begin(); cells != decompositions.end(); cells++){
+          bytes += cells->second.getBytes();
+     }
+     for(map<uint32_t,DistanceField>::const_iterator field = distanceFields.begin(); field != distanceFields.end(); field++){
+          bytes += field->second.getBytes();
+     }
+     bytes += hierarchy.getBytes();
+     bytes += tour.getBytes();
+     bytes += changes.capacity() * sizeof(GraphChange);
+     return bytes;
+}
+
+void GraphData::index(){
+     nodeGrid.build(&topology);
+     edgeGrid.build(&topology);
+     edgesOrder.clear();
+     decompositions.clear();
+     distanceFields.clear();
+     hierarchy.clear();
+     hierarchyStale = false;
+     tour.clear();
+     tourReady = false;
+     changes.clear();
+}
+
+string GraphData::getBinaryFile(string file){
+     return file + ".bin";
+}
+
+/* Whether derived exists and was written after file, if file exists. */
+static bool isNewer(string derived,string file){
+     struct stat derivedInfo;
+     struct stat info;
+     if (stat(derived.c_str(),&derivedInfo) != 0){
+          return false;
+     }
+     if (stat(file.c_str(),&info) != 0){
+          return true;
+     }
+     return derivedInfo.st_mtime >= info.st_mtime;
+}
+
+bool GraphData::isBinaryUpToDate(string file){
+     return isNewer(getBinaryFile(file),file);
+}
+
+string GraphData::getTourFile(string file){
+     return file + ".tour";
+}
+
+bool GraphData::convert(string file){
+     GraphData data;
+     if (!data.loadXml(file.c_str())){
+          return false;
+     }
+     return data.topology.save(getBinaryFile(file).c_str());
+}
+
+/*
+ * The xml file is read with libxml's streaming reader, so nodes and edges
+ * go straight into the topology without building a document tree first.
+ */
+bool GraphData::loadXml(const char* file){
+	xmlTextReaderPtr reader = xmlReaderForFile(file,NULL,XML_PARSE_NOBLANKS | XML_PARSE_COMPACT | XML_PARSE_HUGE);
+
+	if (reader == NULL ) {
+		cout << "Not parsed" << endl;
+		return false;
+	}
+
+	topology.clear();
+
+	int status;
+	bool root = false;
+	string section;
+
+	while ((status = xmlTextReaderRead(reader)) == 1){
+		if (xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT){
+			continue;
+		}
+
+		const xmlChar* name = xmlTextReaderConstLocalName(reader);
+		int depth = xmlTextReaderDepth(reader);
+
+		if (depth == 0){
+			if (xmlStrcmp(name, (const xmlChar *) "graph") != 0) {
+				cout << "document of the wrong type, root node != graph" << endl;
+				xmlFreeTextReader(reader);
+				return false;
+			}
+			root = true;
+		}
+		else if (depth == 1){
+			section = (const char*) name;
+			if (section.compare("nodes") == 0 || section.compare("edges") == 0){
+				cout << "parsing " << section << endl;
+			}
+		}
+		else if (depth == 2){
+			if (section.compare("nodes") == 0 && xmlStrcmp(name, (const xmlChar *) "node") == 0) {
+				parseNode(reader);
+			}
+			else if (section.compare("edges") == 0 && xmlStrcmp(name, (const xmlChar *) "edge") == 0) {
+				parseEdge(reader);
+			}
+		}
+	}
+
+	xmlFreeTextReader(reader);
+
+	if (status != 0) {
+		cout << "Not parsed" << endl;
+		topology.clear();
+		return false;
+	}
+
+	if (!root) {
+		cout << "Empty document" << endl;
+		return false;
+	}
+
+     topology.finalize();
+     return true;
+}
+
+void GraphData::parseNode(xmlTextReaderPtr reader){
+     string id;
+     double x = 0;
+     double y = 0;
+     bool base = false;
+     bool hasId = false;
+
+     while (xmlTextReaderMoveToNextAttribute(reader) == 1){
+          const char* name = (const char*) xmlTextReaderConstLocalName(reader);
+          const char* value = (const char*) xmlTextReaderConstValue(reader);
+
+          if (strcmp(name,"id") == 0){
+               id = value;
+               hasId = true;
+          }
+          else if (strcmp(name,"x") == 0){
+               x = atof(value);
+          }
+          else if (strcmp(name,"y") == 0){
+               y = atof(value);
+          }
+          else if (strcmp(name,"type") == 0){
+               base = strcmp(value,"base") == 0;
+          }
+     }
+     xmlTextReaderMoveToElement(reader);
+
+     if (!hasId) return;
+
+     uint32_t handle = topology.addNode(id,x,y);
+     if (base){
+          topology.setBase(handle);
+     }
+}
+
+void GraphData::parseEdge(xmlTextReaderPtr reader){
+     string from;
+     string to;
+
+     while (xmlTextReaderMoveToNextAttribute(reader) == 1){
+          const char* name = (const char*) xmlTextReaderConstLocalName(reader);
+          const char* value = (const char*) xmlTextReaderConstValue(reader);
+
+          if (strcmp(name,"from") == 0){
+               from = value;
+          }
+          else if (strcmp(name,"to") == 0){
+               to = value;
+          }
+     }
+     xmlTextReaderMoveToElement(reader);
+
+	topology.addEdge(from,to);
+}
+
+struct EdgeIdOrder {
+     const vector<string>* ids;
+     bool operator()(uint32_t a,uint32_t b) const { return (*ids)[a] < (*ids)[b]; }
+};
+
+const vector<uint32_t>& GraphData::getEdgesOrder() const{
+     if (edgesOrder.size() == topology.getEdgeCount()){
+          return edgesOrder;
+     }
+
+     vector<string> ids;
+     edgesOrder.clear();
+     for(uint32_t e=0; e < topology.getEdgeCount(); e++){
+          ids.push_back(topology.getId(topology.getEdgeSource(e)) + "->" +
+                        topology.getId(topology.getEdgeTarget(e)));
+          edgesOrder.push_back(e);
+     }
+
+     EdgeIdOrder order;
+     order.ids = &ids;
+     sort(edgesOrder.begin(),edgesOrder.end(),order);
+     return edgesOrder;
+}
+
+Region GraphData::spanningArea() const{
+	vector<float> x;
+	vector<float> y;
+	for(uint32_t i=0; i < topology.getNodeCount(); i++){
+		x.push_back(topology.getX(i));
+		y.push_back(topology.getY(i));
+	}
+
+	return Region(Util::min(x),Util::min(y),Util::max(x),Util::max(y));
+}
+
+CoverageGrid GraphData::decompose(float w,float l) const{
+     pair<float,float> key(w,l);
+     map<pair<float,float>,CoverageGrid>::const_iterator cached = decompositions.find(key);
+     if (cached != decompositions.end()){
+          return cached->second;
+     }
+
+	CoverageGrid cells(spanningArea(),w,l);
+
+     for(uint32_t e=0; e < topology.getEdgeCount(); e++){
+          uint32_t reverse = topology.getReverseEdge(e);
+          if (reverse != GraphTopology::NONE && reverse < e){
+               continue;
+          }
+
+          uint32_t from = topology.getEdgeSource(e);
+          uint32_t to = topology.getEdgeTarget(e);
+          cells.markRoad(topology.getX(from),topology.getY(from),
+                         topology.getX(to),topology.getY(to));
+     }
+
+     decompositions[key] = cells;
+     return cells;
+}
+
+/*
+ * The distances from every node to target, computed the first time a
+ * Graph asks for them and shared by every Graph returning to the same
+ * node. References stay valid until the data is reloaded.
+ */
+const DistanceField& GraphData::getDistanceField(uint32_t target) const{
+     map<uint32_t,DistanceField>::iterator field = distanceFields.find(target);
+     if (field != distanceFields.end()){
+          return field->second;
+     }
+
+     DistanceField& built = distanceFields[target];
+     built.build(topology,target);
+     return built;
+}
+
+/*
+ * The patrol tour of the graph, read from the tour file next to the graph
+ * when that is newer than the graph, otherwise planned from the base and
+ * written there for the next run. A graph that cannot be written next to
+ * is planned again in every process, and so is a graph changed since it
+ * was loaded, whose tour is not written.
+ */
+const PatrolTour& GraphData::getTour() const{
+     if (tourReady){
+          return tour;
+     }
+
+     string tourFile = getTourFile(file);
+     bool cached = !file.empty() && changes.empty() && isNewer(tourFile,file) &&
+          isNewer(tourFile,getBinaryFile(file)) && tour.load(tourFile,topology);
+     if (!cached){
+          tour.plan(topology,topology.getBase());
+          if (!file.empty() && changes.empty()){
+               tour.save(tourFile,topology);
+          }
+     }
+     tourReady = true;
+     return tour;
+}
+
+/*
+ * Built the first time it is asked for; a city graph takes a fraction of
+ * a second. Must be asked for before Graphs of several threads route
+ * over it. Streets added later are only in it after rebuildHierarchy().
+ */
+const ContractionHierarchy& GraphData::getContractionHierarchy() const{
+     if (!hierarchy.isBuilt()){
+          hierarchy.build(topology);
+     }
+     return hierarchy;
+}
+
+/*
+ * Builds the hierarchy again over the streets added since it was built;
+ * Graphs of the data route over it again from their next route.
+ */
+void GraphData::rebuildHierarchy(){
+     hierarchy.build(topology);
+     hierarchyStale = false;
+}
+
+/*
+ * The subgraph induced by nodes, handles of this data in any order; handles
+ * out of range are ignored. Every edge between two of the nodes is kept.
+ */
+Ptr<GraphData> GraphData::subgraph(vector<uint32_t> nodes) const{
+     sort(nodes.begin(),nodes.end());
+     nodes.erase(unique(nodes.begin(),nodes.end()),nodes.end());
+     while (!nodes.empty() && nodes.back() >= topology.getNodeCount()){
+          nodes.pop_back();
+     }
+
+     Ptr<GraphData> extracted = Ptr<GraphData>(new GraphData(),false);
+     extracted->parent = Ptr<GraphData>(const_cast<GraphData*>(this)); // owns the string table
+     extracted->topology.extract(topology,nodes);
+     extracted->parentNodes.swap(nodes);
+     extracted->index();
+     return extracted;
+}
+
+/* The subgraph of the nodes inside area, borders included. */
+Ptr<GraphData> GraphData::subgraph(Region area) const{
+     Vector corner1 = area.getTopLeft();
+     Vector corner2 = area.getBottomRight();
+     return subgraph(nodeGrid.inside(std::min(corner1.x,corner2.x),std::min(corner1.y,corner2.y),
+                                     std::max(corner1.x,corner2.x),std::max(corner1.y,corner2.y)));
+}
+
+/* The subgraph of the nodes inside polygon, given by its vertices in order. */
+Ptr<GraphData> GraphData::subgraph(const vector<Vector>& polygon) const{
+     vector<uint32_t> nodes;
+     if (polygon.size() < 3){
+          return subgraph(nodes);
+     }
+
+     double x1 = polygon[0].x;
+     double y1 = polygon[0].y;
+     double x2 = x1;
+     double y2 = y1;
+     for(uint32_t i=1; i < polygon.size(); i++){
+          x1 = std::min(x1,polygon[i].x);
+          y1 = std::min(y1,polygon[i].y);
+          x2 = std::max(x2,polygon[i].x);
+          y2 = std::max(y2,polygon[i].y);
+     }
+
+     vector<uint32_t> candidates = nodeGrid.inside(x1,y1,x2,y2);
+     for(uint32_t i=0; i < candidates.size(); i++){
+          Vector point(topology.getX(candidates[i]),topology.getY(candidates[i]),0);
+          if (Util::pointInPolygon(point,polygon)){
+               nodes.push_back(candidates[i]);
+          }
+     }
+     return subgraph(nodes);
+}
+
+void GraphData::closeEdge(uint32_t edge){
+     setStreetOpen(edge,false);
+}
+
+void GraphData::openEdge(uint32_t edge){
+     setStreetOpen(edge,true);
+}
+
+/*
+ * Closes or opens edge and its reverse, logs the edges that changed and
+ * brings the distance fields and the tour along. A tour that cannot get
+ * around a closed street is planned again.
+ */
+void GraphData::setStreetOpen(uint32_t edge,bool open){
+     if (edge >= topology.getEdgeCount()){
+          return;
+     }
+
+     uint32_t street[2] = {edge,topology.getReverseEdge(edge)};
+     vector<uint32_t> changed;
+     for(int i=0; i < 2; i++){
+          if (street[i] != GraphTopology::NONE && topology.isOpen(street[i]) != open){
+               topology.setOpen(street[i],open);
+               logChange(open ? EDGE_OPENED : EDGE_CLOSED,street[i]);
+               changed.push_back(street[i]);
+          }
+     }
+     if (changed.empty()){
+          return;
+     }
+
+     for(map<uint32_t,DistanceField>::iterator field = distanceFields.begin(); field != distanceFields.end(); field++){
+          for(uint32_t i=0; i < changed.size(); i++){
+               if (open){
+                    field->second.open(topology,changed[i]);
+               }
+               else {
+                    field->second.close(topology,changed[i]);
+               }
+          }
+     }
+
+     if (tourReady){
+          uint32_t from = topology.getEdgeSource(edge);
+          uint32_t to = topology.getEdgeTarget(edge);
+          bool patched = open ? tour.openStreet(topology,from,to) : tour.closeStreet(topology,from,to);
+          if (!patched){
+               tour.plan(topology,topology.getBase());
+          }
+     }
+}
+
+/*
+ * Adds the street between from and to, with an edge each way where there
+ * is none, opens it and returns the handle of the edge from from to to.
+ * Returns NONE if a node does not exist.
+ */
+uint32_t GraphData::addEdge(uint32_t from,uint32_t to){
+     uint32_t nodeCount = topology.getNodeCount();
+     if (from >= nodeCount || to >= nodeCount || from == to){
+          return GraphTopology::NONE;
+     }
+
+     bool street = topology.findEdge(from,to) == GraphTopology::NONE &&
+          topology.findEdge(to,from) == GraphTopology::NONE;
+     insertEdge(from,to);
+     insertEdge(to,from);
+
+     if (street){
+          for(map<pair<float,float>,CoverageGrid>::iterator cells = decompositions.begin(); cells != decompositions.end(); cells++){
+               cells->second.markRoad(topology.getX(from),topology.getY(from),topology.getX(to),topology.getY(to));
+          }
+          if (tourReady && !tour.openStreet(topology,from,to)){
+               tour.plan(topology,topology.getBase());
+          }
+     }
+
+     // the edge from from moves up when the one back is inserted before it
+     uint32_t edge = topology.findEdge(from,to);
+     openEdge(edge);
+     return edge;
+}
+
+/*
+ * A changed graph no longer matches its file, so it leaves the cache on
+ * its first change and later loads of the file parse a clean copy. The
+ * Graphs already holding it keep it and see the change.
+ */
+void GraphData::logChange(GraphChangeType type,uint32_t edge){
+     if (changes.empty() && !file.empty()){
+          CriticalSection lock(cacheMutex);
+          map<string,GraphCacheEntry>::iterator entry = cache.find(file);
+          if (entry != cache.end() && PeekPointer(entry->second.data) == this){
+               cache.erase(entry);
+          }
+     }
+
+     GraphChange change;
+     change.type = type;
+     change.edge = edge;
+     changes.push_back(change);
+}
+
+/* Inserts one edge and moves what is indexed by edge handle along. */
+uint32_t GraphData::insertEdge(uint32_t from,uint32_t to){
+     uint32_t edge = topology.findEdge(from,to);
+     if (edge != GraphTopology::NONE){
+          return edge;
+     }
+
+     edge = topology.insertEdge(from,to);
+     logChange(EDGE_ADDED,edge);
+
+     edgeGrid.insert(edge);
+     edgesOrder.clear();
+     for(map<uint32_t,DistanceField>::iterator field = distanceFields.begin(); field != distanceFields.end(); field++){
+          field->second.insert(topology,edge);
+     }
+     hierarchyStale = hierarchy.isBuilt();
+     return edge;
+}
+
+}
@@ -0,0 +1,158 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#ifndef GRAPHDATA_H_
+#define GRAPHDATA_H_
+
+#include "GraphTopology.h"
+#include "SpatialIndex.h"
+#include "CoverageGrid.h"
+#include "DistanceField.h"
+#include "ContractionHierarchy.h"
+#include "PatrolTour.h"
+#include "Util.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include <libxml/xmlreader.h>
+#include <map>
+#include <vector>
+#include <string>
+
+using namespace std;
+
+namespace ns3{
+
+enum GraphChangeType {
+     EDGE_CLOSED,
+     EDGE_OPENED,
+     EDGE_ADDED   // handles from edge on moved up by one
+};
+
+struct GraphChange {
+     GraphChangeType type;
+     uint32_t edge;
+};
+
+/**
+ * \ingroup mobility
+ * \brief Shared part of a graph.
+ *
+ * Holds the topology and everything derived from it alone: the node and
+ * edge grids, the edge id order used for output, the road cells of each
+ * decomposition, the distances to each base, the contraction hierarchy
+ * used for routes and the patrol tour. Loaded graphs are kept in a process-wide cache keyed
+ * by path, so every Graph loaded from the same file shares one instance
+ * and the file is parsed again only when its modification time or size
+ * changes.
+ *
+ * subgraph() extracts the graph induced by a set of nodes, a rectangle or
+ * a polygon without going through a file: the nodes are found with the node
+ * grid and copied into a new topology that reads its ids from the string
+ * table of this one. The subgraph is not cached and keeps this data alive;
+ * its node i is node getParentNode(i) here.
+ *
+ * Streets can be closed, opened again and added at runtime, for road
+ * closures and no-fly segments: closeEdge() and openEdge() change an edge
+ * and its reverse, addEdge() adds both. What is derived from the topology
+ * follows in place: the edge grid and road cells take added streets, each
+ * distance field searches again only the nodes the change moves, and the
+ * tour flies around closed streets and out to opened ones. The contraction
+ * hierarchy is kept, since Graph checks its routes against closures. An
+ * added street makes it stale and Graphs route with A* until
+ * rebuildHierarchy() is called, which is left to the caller so a burst of
+ * additions costs one build.
+ *
+ * Every change is logged. Graphs, blackboards and territory maps of the
+ * data read the log from where they last stopped before they next use
+ * their edges, moving their per edge state to the new handles after an
+ * addition and dropping the routes they were following, the way a
+ * VisitBlackboard hands out visits. Changes must be made on the thread
+ * driving the Graphs, as visits are. A change to a loaded graph is seen by
+ * every Graph already sharing it, but the first one takes the graph out of
+ * the cache, so graphs loaded from the file afterwards start unchanged.
+ */
+class GraphData : public SimpleRefCount<GraphData> {
+private:
+     string file;
+     GraphTopology topology;
+     Ptr<GraphData> parent;          // data a subgraph was extracted from, 0 otherwise
+     vector<uint32_t> parentNodes;   // indexed by node handle, node handle in parent
+     NodeGrid nodeGrid;
+     EdgeGrid edgeGrid;
+     mutable vector<uint32_t> edgesOrder; // edge handles sorted by edge id, built on first use
+     mutable map<pair<float,float>,CoverageGrid> decompositions; // road cells by cell width and length
+     mutable map<uint32_t,DistanceField> distanceFields;         // by target node, built on first use
+     mutable ContractionHierarchy hierarchy;                     // built on first use
+     bool hierarchyStale;                                        // streets added since it was built
+     mutable PatrolTour tour;                                    // planned or read on first use
+     mutable bool tourReady;
+     vector<GraphChange> changes;    // every change since the data was loaded, oldest first
+
+     GraphData(const GraphData&);
+     GraphData& operator=(const GraphData&);
+
+     bool loadXml(const char* file);
+     void parseNode(xmlTextReaderPtr);
+     void parseEdge(xmlTextReaderPtr);
+     void index();
+     void setStreetOpen(uint32_t edge,bool open);
+     uint32_t insertEdge(uint32_t from,uint32_t to);
+     void logChange(GraphChangeType type,uint32_t edge);
+
+public:
+     GraphData();
+
+     static Ptr<GraphData> load(string file);
+     static void clearCache();
+     static string getCacheStats();
+     static string getBinaryFile(string file);
+     static bool isBinaryUpToDate(string file);
+     static string getTourFile(string file);
+     static bool convert(string file);
+
+     const string& getFile() const { return file; }
+     const GraphTopology& getTopology() const { return topology; }
+     const NodeGrid& getNodeGrid() const { return nodeGrid; }
+     const EdgeGrid& getEdgeGrid() const { return edgeGrid; }
+     const vector<uint32_t>& getEdgesOrder() const;
+     size_t getBytes() const;
+     Region spanningArea() const;
+     CoverageGrid decompose(float w,float l) const;
+     const DistanceField& getDistanceField(uint32_t target) const;
+     const ContractionHierarchy& getContractionHierarchy() const;
+     bool isHierarchyCurrent() const { return hierarchy.isBuilt() && !hierarchyStale; }
+     void rebuildHierarchy();
+     const PatrolTour& getTour() const;
+
+     Ptr<GraphData> subgraph(vector<uint32_t> nodes) const;
+     Ptr<GraphData> subgraph(Region area) const;
+     Ptr<GraphData> subgraph(const vector<Vector>& polygon) const;
+     const GraphData* getParent() const { return PeekPointer(parent); }
+     uint32_t getParentNode(uint32_t node) const { return parentNodes[node]; }
+
+     void closeEdge(uint32_t edge);
+     void openEdge(uint32_t edge);
+     uint32_t addEdge(uint32_t from,uint32_t to);
+     uint32_t getChangeCount() const { return (uint32_t) changes.size(); }
+     const GraphChange& getChange(uint32_t change) const { return changes[change]; }
+};
+
+}
+
+#endif /* GRAPHDATA_H_ */
@@ -31,95 +31,57 @@ using namespace std;
 namespace ns3{
 
 
-GraphNode* RandomSelection::select(vector<GraphNode*>& nodes){
-	int randomNumber = rand() % (int) nodes.size();
-	return nodes[randomNumber];
+GraphNode::GraphNode() {
+     topology = NULL;
+     index = GraphTopology::NONE;
 }
 
-LeastVisitedEdgesSelection::LeastVisitedEdgesSelection(string f,Graph* g){
-     from = f;
-     graph = g;
-}
-
-GraphNode* LeastVisitedEdgesSelection::select(vector<GraphNode*>& nodes){
-     vector<GraphNode*> equalNodes;
-     equalNodes.push_back(nodes[0]);
-
-     for (int i=1; i < (int) nodes.size(); i++){
-          if (graph->getEdgeVisitCount(from,nodes[i]->getId()) < 
-               graph->getEdgeVisitCount(from,equalNodes[0]->getId()) ){
-               equalNodes.clear();
-               equalNodes.push_back(nodes[i]);
-          }
-          else if (graph->getEdgeVisitCount(from,nodes[i]->getId()) ==
-               graph->getEdgeVisitCount(from,equalNodes[0]->getId()) ){
-               equalNodes.push_back(nodes[i]);          
-          }
-     }
-
-     int randomNumber = rand() % (int) equalNodes.size();
-	return equalNodes[randomNumber];
-}
-
-GraphNode::GraphNode(string i,double x,double y,SelectionStrategy* s) {
-	this->id = i;
-	this->x = x;
-	this->y = y;
-     strategy = s;
+GraphNode::GraphNode(const GraphTopology* t,uint32_t i) {
+     topology = t;
+     index = i;
 }
 
 void GraphNode::print(){
-	cout << id << ":" << x <<	"," << y << ":" << nodes.size() << endl;
-}
-
-void GraphNode::addNode(GraphNode* node){
-	nodes.push_back(node);
-
+	cout << getId() << ":" << getX() <<	"," << getY() << ":" << getDegree() << endl;
 }
 
-void GraphNode::walk(int steps,int current,Visitor* visitor){
-
-	if(current == steps){
-		return;
-	}
-
-	visitor->accept(this);
-	current++;
-	next()->walk(steps,current,visitor);
+bool GraphNode::isValid(){
+     return topology != NULL && index < topology->getNodeCount();
 }
 
-GraphNode* GraphNode::next(){
-     if(nodes.size() == 0){
-		return this;
-	}
-
-     return strategy->select(nodes);
+uint32_t GraphNode::getIndex(){
+     return index;
 }
 
 string GraphNode::getId(){
-	return id;
+	return topology->getId(index);
 }
 
 double GraphNode::getX(){
-	return x;
+	return topology->getX(index);
 }
 
 double GraphNode::getY(){
-	return y;
+	return topology->getY(index);
+}
+
+uint32_t GraphNode::getDegree(){
+     return topology->getDegree(index);
 }
 
 double GraphNode::distance(double x,double y){
-	double xd = this->x - x;
-	double yd = this->y - y;
+	double xd = getX() - x;
+	double yd = getY() - y;
 	return sqrt(xd*xd + yd*yd);
 }
 
 bool GraphNode::lineEdgesIntersect(Vector p1, Vector p2){
 
 	Vector q1 (getX(),getY(),0);
+     const uint32_t* nodes = topology->getNeighbours(index);
 
-	for(int i=0; i < (int) nodes.size(); i++){
-          Vector q2(nodes[i]->getX(),nodes[i]->getY(),0);
+	for(int i=0; i < (int) getDegree(); i++){
+          Vector q2(topology->getX(nodes[i]),topology->getY(nodes[i]),0);
 
           if(Util::linesegmentsIntersect(p1,p2,q1,q2)) {
 			return true;
@@ -133,10 +95,11 @@ bool GraphNode::pointExists(float x,float y){
 
 	float x1 = getX();
 	float y1 = getY();
+     const uint32_t* nodes = topology->getNeighbours(index);
 
-	for(int i=0; i < (int) nodes.size(); i++){
-		float x2 = nodes[i]->getX();
-		float y2 = nodes[i]->getY();
+	for(int i=0; i < (int) getDegree(); i++){
+		float x2 = topology->getX(nodes[i]);
+		float y2 = topology->getY(nodes[i]);
 
 		float m = (y2-y1) / (x2-x1);
 		float c = y1 - (m*x1);
@@ -152,9 +115,10 @@ bool GraphNode::pointExists(float x,float y){
 
 bool GraphNode::cellExists(Region& cell){
      Vector p1(getX(),getY(),0);
+     const uint32_t* nodes = topology->getNeighbours(index);
 
-     for(int i=0; i < (int) nodes.size(); i++){
-          Vector p2( nodes[i]->getX(), nodes[i]->getY(),0);
+     for(int i=0; i < (int) getDegree(); i++){
+          Vector p2( topology->getX(nodes[i]), topology->getY(nodes[i]),0);
 
           if(  Util::linesegmentsIntersect(p1,p2,cell.getTopLeft(),cell.getTopRight() ) ||
 		     Util::linesegmentsIntersect(p1,p2,cell.getTopLeft(),cell.getBottomLeft() ) ||
@@ -168,9 +132,4 @@ bool GraphNode::cellExists(Region& cell){
      return false;
 }
 
-
-GraphNode::~GraphNode() {
-     delete strategy;
-}
-
 }
@@ -24,6 +24,7 @@
 #include <string>
 #include "ns3/vector.h"
 #include "Util.h"
+#include "GraphTopology.h"
 
 using namespace std;
 
@@ -33,48 +34,33 @@ class Visitor;
 class GraphNode;
 class Graph;
 
-class SelectionStrategy {
-public:
-     virtual GraphNode* select(vector<GraphNode*>&) = 0;
-
-};
-
-class RandomSelection : public SelectionStrategy {
-public:
-     virtual GraphNode* select(vector<GraphNode*>&);
-};
-
-class LeastVisitedEdgesSelection : public SelectionStrategy {
-private:
-     string from;
-     Graph* graph;
-public:
-     LeastVisitedEdgesSelection(string from,Graph* g);
-     virtual GraphNode* select(vector<GraphNode*>&);
-};
-
+/**
+ * \ingroup mobility
+ * \brief Handle to a node of a GraphTopology.
+ *
+ * A GraphNode is a small value (topology pointer and node handle) and does
+ * not own any storage, so it can be created on the fly and passed to
+ * visitors without allocating.
+ */
 class GraphNode {
 private:
-	string id;
-	double x;
-	double y;
-	vector<GraphNode*> nodes;
-     SelectionStrategy* strategy;
+     const GraphTopology* topology;
+     uint32_t index;
 
 public:
-	GraphNode(string i,double x,double y,SelectionStrategy* s);
-	void addNode(GraphNode* node);
+     GraphNode();
+	GraphNode(const GraphTopology* t,uint32_t i);
 	void print();
-	GraphNode* next();
-	void walk(int steps,int current, Visitor* visitor);	
+     bool isValid();
+     uint32_t getIndex();
      string getId();
 	double getX();
 	double getY();
+     uint32_t getDegree();
 	double distance(double x,double y);
      bool lineEdgesIntersect(Vector p1,Vector p2);
      bool pointExists(float x,float y);
      bool cellExists(Region& cell);
-	virtual ~GraphNode();
 };
 
 }
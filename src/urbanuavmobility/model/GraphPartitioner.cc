@@ -0,0 +1,1007 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#include "GraphPartitioner.h"
+#include "WorkerPool.h"
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
+#include <time.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace ns3{
+
+static const uint32_t NONE = GraphTopology::NONE;
+
+/*
+ * Rows of the connections from[i] -> to[i], parallel connections merged
+ * into one with their weights added.
+ */
+static void buildRows(uint32_t nodeCount,const vector<uint32_t>& from,const vector<uint32_t>& to,const vector<double>& weights,
+          vector<uint32_t>& offsets,vector<uint32_t>& targets,vector<double>& edgeWeights){
+     vector<uint32_t> starts(nodeCount + 1,0);
+     for(uint32_t i=0; i < from.size(); i++){
+          starts[from[i] + 1]++;
+     }
+     for(uint32_t n=0; n < nodeCount; n++){
+          starts[n + 1] += starts[n];
+     }
+
+     vector<uint32_t> rowTargets(from.size());
+     vector<double> rowWeights(from.size());
+     vector<uint32_t> fill(starts.begin(),starts.end() - 1);
+     for(uint32_t i=0; i < from.size(); i++){
+          uint32_t position = fill[from[i]]++;
+          rowTargets[position] = to[i];
+          rowWeights[position] = weights[i];
+     }
+
+     offsets.assign(nodeCount + 1,0);
+     targets.clear();
+     edgeWeights.clear();
+     vector<uint32_t> slots(nodeCount,NONE);
+     for(uint32_t n=0; n < nodeCount; n++){
+          offsets[n] = (uint32_t) targets.size();
+          for(uint32_t p = starts[n]; p < starts[n + 1]; p++){
+               uint32_t target = rowTargets[p];
+               if (slots[target] != NONE && slots[target] >= offsets[n]){
+                    edgeWeights[slots[target]] += rowWeights[p];
+               }
+               else {
+                    slots[target] = (uint32_t) targets.size();
+                    targets.push_back(target);
+                    edgeWeights.push_back(rowWeights[p]);
+               }
+          }
+     }
+     offsets[nodeCount] = (uint32_t) targets.size();
+}
+
+static void shuffle(vector<uint32_t>& order,UniformRandomVariable& random){
+     for(uint32_t i=0; i + 1 < order.size(); i++){
+          swap(order[i],order[random.GetInteger(i,(uint32_t) order.size() - 1)]);
+     }
+}
+
+GraphPartitioner::GraphPartitioner(Ptr<GraphData> data,double speed,double pause){
+     this->data = data;
+     this->speed = speed;
+     this->pause = pause;
+     imbalance = 0.03;
+     trialCount = 8;
+     stream = 0;
+
+     long cores = sysconf(_SC_NPROCESSORS_ONLN);
+     threads = cores > 0 ? (uint32_t) cores : 1;
+     partCount = 0;
+     cutStreets = 0;
+     leftOutStreets = 0;
+     elapsed = 0;
+     pending = NULL;
+
+     buildFinest();
+}
+
+/* Allowed excess of the heaviest territory over the average, 0.03 for 3%. */
+void GraphPartitioner::setImbalance(double imbalance){
+     this->imbalance = imbalance;
+}
+
+void GraphPartitioner::setThreads(uint32_t n){
+     threads = n > 0 ? n : 1;
+}
+
+void GraphPartitioner::setTrials(uint32_t n){
+     trialCount = n > 0 ? n : 1;
+}
+
+/* Trial i uses random stream stream + i. */
+void GraphPartitioner::assignStreams(int64_t stream){
+     this->stream = stream;
+}
+
+double GraphPartitioner::getLength(uint32_t edge) const{
+     const GraphTopology& topology = data->getTopology();
+     uint32_t from = topology.getEdgeSource(edge);
+     uint32_t to = topology.getEdgeTarget(edge);
+     double dx = topology.getX(to) - topology.getX(from);
+     double dy = topology.getY(to) - topology.getY(from);
+     return sqrt(dx*dx + dy*dy);
+}
+
+/*
+ * The node graph of the streets, restricted to its largest connected part.
+ * A street weighs the time to fly it once and pause, split between its
+ * nodes. Dead ends are folded into the node they hang from: a territory
+ * could only give them away together with that node, which a move of one
+ * node at a time never does.
+ */
+void GraphPartitioner::buildFinest(){
+     const GraphTopology& topology = data->getTopology();
+     uint32_t nodeCount = topology.getNodeCount();
+     uint32_t edgeCount = topology.getEdgeCount();
+
+     vector<uint32_t> from;
+     vector<uint32_t> to;
+     vector<double> ones;
+     vector<double> nodeTimes(nodeCount,0);
+     for(uint32_t e=0; e < edgeCount; e++){
+          uint32_t reverse = topology.getReverseEdge(e);
+          if (reverse != NONE && reverse < e){
+               continue;
+          }
+          uint32_t u = topology.getEdgeSource(e);
+          uint32_t v = topology.getEdgeTarget(e);
+          double time = getLength(e) / speed + pause;
+          nodeTimes[u] += time / 2;
+          nodeTimes[v] += time / 2;
+          if (u != v){
+               from.push_back(u);
+               to.push_back(v);
+               from.push_back(v);
+               to.push_back(u);
+               ones.push_back(1);
+               ones.push_back(1);
+          }
+     }
+
+     Level whole;
+     buildRows(nodeCount,from,to,ones,whole.offsets,whole.targets,whole.edgeWeights);
+
+     // connected parts, the heaviest kept
+     vector<uint32_t> components(nodeCount,NONE);
+     uint32_t largest = NONE;
+     double largestWeight = 0;
+     vector<uint32_t> frontier;
+     for(uint32_t start=0; start < nodeCount; start++){
+          if (components[start] != NONE || whole.offsets[start] == whole.offsets[start + 1]){
+               continue;
+          }
+          double weight = 0;
+          components[start] = start;
+          frontier.push_back(start);
+          while (!frontier.empty()){
+               uint32_t n = frontier.back();
+               frontier.pop_back();
+               weight += nodeTimes[n];
+               for(uint32_t p = whole.offsets[n]; p < whole.offsets[n + 1]; p++){
+                    if (components[whole.targets[p]] == NONE){
+                         components[whole.targets[p]] = start;
+                         frontier.push_back(whole.targets[p]);
+                    }
+               }
+          }
+          if (largest == NONE || weight > largestWeight){
+               largest = start;
+               largestWeight = weight;
+          }
+     }
+
+     // peel nodes of degree one until none are left
+     vector<uint32_t> degrees(nodeCount,0);
+     vector<uint32_t> folded(nodeCount,NONE);
+     uint32_t remaining = 0;
+     frontier.clear();
+     for(uint32_t n=0; n < nodeCount; n++){
+          if (largest == NONE || components[n] != largest){
+               continue;
+          }
+          remaining++;
+          for(uint32_t p = whole.offsets[n]; p < whole.offsets[n + 1]; p++){
+               degrees[n] += whole.targets[p] != n ? 1 : 0;
+          }
+          if (degrees[n] == 1){
+               frontier.push_back(n);
+          }
+     }
+     vector<double> foldedTimes(nodeTimes);
+     while (!frontier.empty() && remaining > 1){
+          uint32_t n = frontier.back();
+          frontier.pop_back();
+          if (degrees[n] != 1){
+               continue;
+          }
+          for(uint32_t p = whole.offsets[n]; p < whole.offsets[n + 1]; p++){
+               uint32_t t = whole.targets[p];
+               if (t != n && folded[t] == NONE && degrees[t] > 0){
+                    folded[n] = t;
+                    foldedTimes[t] += foldedTimes[n];
+                    degrees[n] = 0;
+                    remaining--;
+                    if (--degrees[t] == 1){
+                         frontier.push_back(t);
+                    }
+                    break;
+               }
+          }
+     }
+
+     levelNodes.assign(nodeCount,NONE);
+     graphNodes.clear();
+     finest.nodeWeights.clear();
+     totalWeight = 0;
+     for(uint32_t n=0; n < nodeCount; n++){
+          if (largest != NONE && components[n] == largest && folded[n] == NONE){
+               levelNodes[n] = (uint32_t) graphNodes.size();
+               graphNodes.push_back(n);
+               finest.nodeWeights.push_back(foldedTimes[n]);
+               totalWeight += foldedTimes[n];
+          }
+     }
+     for(uint32_t n=0; n < nodeCount; n++){
+          uint32_t root = n;
+          while (folded[root] != NONE){
+               root = folded[root];
+          }
+          if (root != n){
+               levelNodes[n] = levelNodes[root];
+          }
+     }
+     for(uint32_t i=0; i < from.size(); i++){
+          from[i] = levelNodes[from[i]];
+          to[i] = levelNodes[to[i]];
+     }
+     vector<uint32_t> keptFrom;
+     vector<uint32_t> keptTo;
+     vector<double> keptOnes;
+     for(uint32_t i=0; i < from.size(); i++){
+          if (from[i] != NONE && from[i] != to[i]){
+               keptFrom.push_back(from[i]);
+               keptTo.push_back(to[i]);
+               keptOnes.push_back(1);
+          }
+     }
+     buildRows((uint32_t) graphNodes.size(),keptFrom,keptTo,keptOnes,finest.offsets,finest.targets,finest.edgeWeights);
+}
+
+bool GraphPartitioner::partition(uint32_t k){
+     timespec start;
+     clock_gettime(CLOCK_MONOTONIC,&start);
+
+     partCount = 0;
+     owners.clear();
+     bases.clear();
+     lengths.clear();
+     times.clear();
+     cutStreets = 0;
+     leftOutStreets = 0;
+     if (k == 0 || graphNodes.size() < k){
+          return false;
+     }
+     partCount = k;
+
+     // random streams are created on the calling thread, as ns-3 objects must be
+     vector<Trial> trials(trialCount);
+     for(uint32_t i=0; i < trialCount; i++){
+          trials[i].random = CreateObject<UniformRandomVariable>();
+          trials[i].random->SetStream(stream + i);
+     }
+
+     pending = &trials;
+     WorkerPool pool(threads);
+     pool.run(trialCount,MakeCallback(&GraphPartitioner::runPending,this));
+     pending = NULL;
+
+     // the balanced trial with the fewest cut streets, else the best balanced one
+     double limit = (1 + imbalance) * totalWeight / k + 1e-9;
+     uint32_t best = 0;
+     for(uint32_t i=1; i < trialCount; i++){
+          bool balanced = trials[i].heaviest <= limit;
+          bool bestBalanced = trials[best].heaviest <= limit;
+          if (balanced != bestBalanced){
+               best = balanced ? i : best;
+          }
+          else if (balanced ? trials[i].cut < trials[best].cut : trials[i].heaviest < trials[best].heaviest){
+               best = i;
+          }
+     }
+
+     cutStreets = (uint32_t) trials[best].cut;
+     assignStreets(trials[best].parts);
+     placeBases();
+
+     // a territory whose streets all went to its neighbours
+     for(uint32_t i=0; i < k; i++){
+          if (bases[i] == NONE){
+               partCount = 0;
+               return false;
+          }
+     }
+
+     timespec end;
+     clock_gettime(CLOCK_MONOTONIC,&end);
+     elapsed = (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+     return true;
+}
+
+void GraphPartitioner::runPending(uint32_t i){
+     runTrial((*pending)[i]);
+}
+
+void GraphPartitioner::runTrial(Trial& trial) const{
+     UniformRandomVariable& random = *trial.random;
+
+     // coarsen until the graph is small or stops shrinking
+     vector<Level> coarser;
+     coarser.reserve(64);
+     while (true){
+          const Level& fine = coarser.empty() ? finest : coarser.back();
+          uint32_t fineCount = (uint32_t) fine.nodeWeights.size();
+          if (fineCount <= COARSEST_NODES * partCount || coarser.size() == coarser.capacity()){
+               break;
+          }
+          Level coarse;
+          coarsen(fine,coarse,random);
+          if (coarse.nodeWeights.size() > fineCount * 0.95){
+               break;
+          }
+          coarser.push_back(coarse);
+     }
+
+     vector<uint32_t> parts;
+     const Level& coarsest = coarser.empty() ? finest : coarser.back();
+     grow(coarsest,parts,random);
+     balance(coarsest,parts);
+     refine(coarsest,parts,random);
+
+     for(uint32_t i = (uint32_t) coarser.size(); i > 0; i--){
+          const Level& fine = i == 1 ? finest : coarser[i - 2];
+          const vector<uint32_t>& merged = coarser[i - 1].merged;
+          vector<uint32_t> fineParts(fine.nodeWeights.size());
+          for(uint32_t n=0; n < fineParts.size(); n++){
+               fineParts[n] = parts[merged[n]];
+          }
+          parts.swap(fineParts);
+          balance(fine,parts);
+          refine(fine,parts,random);
+     }
+
+     vector<double> weights(partCount,0);
+     trial.cut = 0;
+     for(uint32_t n=0; n < parts.size(); n++){
+          weights[parts[n]] += finest.nodeWeights[n];
+          for(uint32_t p = finest.offsets[n]; p < finest.offsets[n + 1]; p++){
+               if (parts[finest.targets[p]] != parts[n]){
+                    trial.cut += finest.edgeWeights[p] / 2;
+               }
+          }
+     }
+     trial.heaviest = 0;
+     for(uint32_t i=0; i < partCount; i++){
+          trial.heaviest = weights[i] > trial.heaviest ? weights[i] : trial.heaviest;
+     }
+     trial.parts.swap(parts);
+}
+
+/*
+ * Heavy edge matching: in random order every node is merged with the free
+ * neighbour it has the most streets with, unless both together would be
+ * too heavy for the coarsest graph.
+ */
+void GraphPartitioner::coarsen(const Level& fine,Level& coarse,UniformRandomVariable& random) const{
+     uint32_t nodeCount = (uint32_t) fine.nodeWeights.size();
+     double limit = 1.5 * totalWeight / (COARSEST_NODES * partCount);
+
+     vector<uint32_t> order(nodeCount);
+     for(uint32_t n=0; n < nodeCount; n++){
+          order[n] = n;
+     }
+     shuffle(order,random);
+
+     vector<uint32_t> match(nodeCount,NONE);
+     for(uint32_t i=0; i < nodeCount; i++){
+          uint32_t u = order[i];
+          if (match[u] != NONE){
+               continue;
+          }
+          uint32_t best = NONE;
+          double bestWeight = 0;
+          for(uint32_t p = fine.offsets[u]; p < fine.offsets[u + 1]; p++){
+               uint32_t v = fine.targets[p];
+               if (match[v] != NONE || fine.nodeWeights[u] + fine.nodeWeights[v] > limit){
+                    continue;
+               }
+               if (best == NONE || fine.edgeWeights[p] > bestWeight
+                         || (fine.edgeWeights[p] == bestWeight && fine.nodeWeights[v] < fine.nodeWeights[best])){
+                    best = v;
+                    bestWeight = fine.edgeWeights[p];
+               }
+          }
+          match[u] = best == NONE ? u : best;
+          if (best != NONE){
+               match[best] = u;
+          }
+     }
+
+     coarse.merged.assign(nodeCount,NONE);
+     uint32_t coarseCount = 0;
+     for(uint32_t n=0; n < nodeCount; n++){
+          if (coarse.merged[n] == NONE){
+               coarse.merged[n] = coarseCount;
+               coarse.merged[match[n]] = coarseCount;
+               coarseCount++;
+          }
+     }
+
+     coarse.nodeWeights.assign(coarseCount,0);
+     vector<uint32_t> from;
+     vector<uint32_t> to;
+     vector<double> weights;
+     for(uint32_t n=0; n < nodeCount; n++){
+          uint32_t cn = coarse.merged[n];
+          coarse.nodeWeights[cn] += fine.nodeWeights[n];
+          for(uint32_t p = fine.offsets[n]; p < fine.offsets[n + 1]; p++){
+               uint32_t ct = coarse.merged[fine.targets[p]];
+               if (ct != cn){
+                    from.push_back(cn);
+                    to.push_back(ct);
+                    weights.push_back(fine.edgeWeights[p]);
+               }
+          }
+     }
+     buildRows(coarseCount,from,to,weights,coarse.offsets,coarse.targets,coarse.edgeWeights);
+}
+
+/*
+ * Grows k regions from seeds spread out in hops, the first one at random
+ * and every next one the node farthest from those chosen. The lightest
+ * region that can still grow takes the free node it has the most streets
+ * with, so every region stays connected.
+ */
+void GraphPartitioner::grow(const Level& level,vector<uint32_t>& parts,UniformRandomVariable& random) const{
+     uint32_t nodeCount = (uint32_t) level.nodeWeights.size();
+     parts.assign(nodeCount,NONE);
+
+     vector<double> weights(partCount,0);
+     vector<vector<uint32_t> > frontiers(partCount);
+     vector<uint32_t> hops(nodeCount,NONE);
+     vector<uint32_t> queue;
+     uint32_t seed = random.GetInteger(0,nodeCount - 1);
+     for(uint32_t i=0; i < partCount; i++){
+          parts[seed] = i;
+          weights[i] = level.nodeWeights[seed];
+          for(uint32_t p = level.offsets[seed]; p < level.offsets[seed + 1]; p++){
+               frontiers[i].push_back(level.targets[p]);
+          }
+
+          // hops from the nearest seed
+          hops[seed] = 0;
+          queue.assign(1,seed);
+          for(uint32_t q=0; q < queue.size(); q++){
+               uint32_t n = queue[q];
+               for(uint32_t p = level.offsets[n]; p < level.offsets[n + 1]; p++){
+                    uint32_t t = level.targets[p];
+                    if (hops[t] == NONE || hops[n] + 1 < hops[t]){
+                         hops[t] = hops[n] + 1;
+                         queue.push_back(t);
+                    }
+               }
+          }
+          uint32_t farthest = NONE;
+          for(uint32_t n=0; n < nodeCount; n++){
+               if (parts[n] == NONE && (farthest == NONE || hops[n] > hops[farthest])){
+                    farthest = n;
+               }
+          }
+          seed = farthest;
+     }
+
+     vector<bool> growing(partCount,true);
+     while (true){
+          uint32_t part = NONE;
+          for(uint32_t i=0; i < partCount; i++){
+               if (growing[i] && (part == NONE || weights[i] < weights[part])){
+                    part = i;
+               }
+          }
+          if (part == NONE){
+               break;
+          }
+
+          vector<uint32_t>& frontier = frontiers[part];
+          uint32_t kept = 0;
+          uint32_t best = NONE;
+          double bestConnection = 0;
+          for(uint32_t i=0; i < frontier.size(); i++){
+               uint32_t n = frontier[i];
+               if (parts[n] != NONE){
+                    continue;
+               }
+               frontier[kept++] = n;
+               double connection = 0;
+               for(uint32_t p = level.offsets[n]; p < level.offsets[n + 1]; p++){
+                    connection += parts[level.targets[p]] == part ? level.edgeWeights[p] : 0;
+               }
+               if (best == NONE || connection > bestConnection
+                         || (connection == bestConnection && level.nodeWeights[n] < level.nodeWeights[best])){
+                    best = n;
+                    bestConnection = connection;
+               }
+          }
+          frontier.resize(kept);
+          if (best == NONE){
+               growing[part] = false;
+               continue;
+          }
+
+          parts[best] = part;
+          weights[part] += level.nodeWeights[best];
+          for(uint32_t p = level.offsets[best]; p < level.offsets[best + 1]; p++){
+               if (parts[level.targets[p]] == NONE){
+                    frontier.push_back(level.targets[p]);
+               }
+          }
+     }
+}
+
+/*
+ * Greedy boundary refinement: in random order every node moves to the
+ * neighbouring territory that cuts the most fewer streets, as long as it
+ * fits there, or to one that cuts as many and is lighter. Nodes of a
+ * territory above the limit, or next to one well below the average, may
+ * move at a loss to a territory that stays lighter. A move that would
+ * split its territory is refused.
+ */
+void GraphPartitioner::refine(const Level& level,vector<uint32_t>& parts,UniformRandomVariable& random) const{
+     uint32_t nodeCount = (uint32_t) level.nodeWeights.size();
+     double limit = (1 + imbalance) * totalWeight / partCount;
+     double low = (1 - imbalance) * totalWeight / partCount;
+
+     vector<double> weights(partCount,0);
+     vector<uint32_t> sizes(partCount,0);
+     vector<uint32_t> order(nodeCount);
+     for(uint32_t n=0; n < nodeCount; n++){
+          weights[parts[n]] += level.nodeWeights[n];
+          sizes[parts[n]]++;
+          order[n] = n;
+     }
+
+     vector<uint32_t> nearParts;
+     vector<double> nearWeights;
+     for(uint32_t pass=0; pass < REFINE_PASSES; pass++){
+          shuffle(order,random);
+          uint32_t moved = 0;
+          for(uint32_t i=0; i < nodeCount; i++){
+               uint32_t n = order[i];
+               uint32_t part = parts[n];
+               if (sizes[part] <= 1){
+                    continue;
+               }
+
+               double internal = 0;
+               nearParts.clear();
+               nearWeights.clear();
+               for(uint32_t p = level.offsets[n]; p < level.offsets[n + 1]; p++){
+                    uint32_t other = parts[level.targets[p]];
+                    if (other == part){
+                         internal += level.edgeWeights[p];
+                         continue;
+                    }
+                    uint32_t j = 0;
+                    while (j < nearParts.size() && nearParts[j] != other){
+                         j++;
+                    }
+                    if (j == nearParts.size()){
+                         nearParts.push_back(other);
+                         nearWeights.push_back(0);
+                    }
+                    nearWeights[j] += level.edgeWeights[p];
+               }
+
+               double weight = level.nodeWeights[n];
+               uint32_t best = NONE;
+               double bestGain = 0;
+               for(uint32_t j=0; j < nearParts.size(); j++){
+                    uint32_t other = nearParts[j];
+                    double gain = nearWeights[j] - internal;
+                    double after = weights[other] + weight;
+                    bool fits = after <= limit;
+                    bool better = (gain > 0 && fits) || (gain == 0 && fits && after < weights[part])
+                              || ((weights[part] > limit || weights[other] < low) && after < weights[part]);
+                    if (better && (best == NONE || gain > bestGain || (gain == bestGain && weights[other] < weights[best]))){
+                         best = other;
+                         bestGain = gain;
+                    }
+               }
+               if (best == NONE || !staysConnected(level,parts,n)){
+                    continue;
+               }
+
+               parts[n] = best;
+               weights[part] -= weight;
+               weights[best] += weight;
+               sizes[part]--;
+               sizes[best]++;
+               moved++;
+          }
+          if (moved == 0){
+               break;
+          }
+     }
+}
+
+/*
+ * Moves weight from the heaviest territory to the nearest one below the
+ * average, one node at a time along a shortest chain of neighbouring
+ * territories, so the territories in between keep about their weight.
+ * Each step moves the boundary node that cuts the fewest more streets and
+ * keeps its territory connected; a pair of territories where no node can
+ * move is not used again. Stops when all territories fit or no chain is
+ * left.
+ */
+void GraphPartitioner::balance(const Level& level,vector<uint32_t>& parts) const{
+     uint32_t nodeCount = (uint32_t) level.nodeWeights.size();
+     double average = totalWeight / partCount;
+     double limit = (1 + imbalance) * average;
+
+     vector<double> weights(partCount,0);
+     vector<vector<uint32_t> > members(partCount);
+     for(uint32_t n=0; n < nodeCount; n++){
+          weights[parts[n]] += level.nodeWeights[n];
+          members[parts[n]].push_back(n);
+     }
+
+     // streets between each pair of territories
+     vector<map<uint32_t,double> > contacts(partCount);
+     for(uint32_t n=0; n < nodeCount; n++){
+          for(uint32_t p = level.offsets[n]; p < level.offsets[n + 1]; p++){
+               if (parts[level.targets[p]] != parts[n]){
+                    contacts[parts[n]][parts[level.targets[p]]] += level.edgeWeights[p];
+               }
+          }
+     }
+
+     vector<bool> stuck(partCount,false);
+     set<pair<uint32_t,uint32_t> > blocked;
+     vector<uint32_t> previous(partCount);
+     vector<uint32_t> queue;
+     for(uint32_t chain=0; chain < nodeCount; chain++){
+          uint32_t heaviest = NONE;
+          for(uint32_t i=0; i < partCount; i++){
+               if (!stuck[i] && weights[i] > limit && (heaviest == NONE || weights[i] > weights[heaviest])){
+                    heaviest = i;
+               }
+          }
+          if (heaviest == NONE){
+               return;
+          }
+
+          // nearest territory below the average
+          previous.assign(partCount,NONE);
+          previous[heaviest] = heaviest;
+          queue.assign(1,heaviest);
+          uint32_t light = NONE;
+          for(uint32_t q=0; q < queue.size() && light == NONE; q++){
+               uint32_t from = queue[q];
+               for(map<uint32_t,double>::iterator it = contacts[from].begin(); it != contacts[from].end(); it++){
+                    uint32_t other = it->first;
+                    if (previous[other] != NONE || blocked.count(make_pair(from,other)) > 0){
+                         continue;
+                    }
+                    previous[other] = from;
+                    queue.push_back(other);
+                    if (weights[other] < average){
+                         light = other;
+                         break;
+                    }
+               }
+          }
+          if (light == NONE){
+               stuck[heaviest] = true;
+               continue;
+          }
+
+          // from the light end back, so no territory gives before it gains
+          uint32_t to = light;
+          for(; to != heaviest; to = previous[to]){
+               uint32_t from = previous[to];
+               vector<uint32_t>& candidates = members[from];
+               uint32_t best = NONE;
+               double bestGain = 0;
+               for(uint32_t i=0; i < candidates.size() && candidates.size() > 1; i++){
+                    uint32_t n = candidates[i];
+                    double gain = 0;
+                    bool adjacent = false;
+                    for(uint32_t p = level.offsets[n]; p < level.offsets[n + 1]; p++){
+                         uint32_t other = parts[level.targets[p]];
+                         gain += other == to ? level.edgeWeights[p] : (other == from ? -level.edgeWeights[p] : 0);
+                         adjacent = adjacent || other == to;
+                    }
+                    if (adjacent && (best == NONE || gain > bestGain) && staysConnected(level,parts,n)){
+                         best = i;
+                         bestGain = gain;
+                    }
+               }
+               if (best == NONE){
+                    blocked.insert(make_pair(from,to));
+                    break;
+               }
+
+               uint32_t n = candidates[best];
+               candidates[best] = candidates.back();
+               candidates.pop_back();
+               members[to].push_back(n);
+               for(uint32_t p = level.offsets[n]; p < level.offsets[n + 1]; p++){
+                    uint32_t other = parts[level.targets[p]];
+                    double weight = level.edgeWeights[p];
+                    if (other != from && (contacts[from][other] -= weight) <= 0){
+                         contacts[from].erase(other);
+                         contacts[other].erase(from);
+                    }
+                    else if (other != from){
+                         contacts[other][from] -= weight;
+                    }
+                    if (other != to){
+                         contacts[to][other] += weight;
+                         contacts[other][to] += weight;
+                    }
+               }
+               parts[n] = to;
+               weights[from] -= level.nodeWeights[n];
+               weights[to] += level.nodeWeights[n];
+          }
+     }
+}
+
+/*
+ * Whether the territory of node stays connected without it: its
+ * neighbours there must all be reached from one of them. The search gives
+ * up, and refuses the move, after CONNECTED_SEARCH nodes.
+ */
+bool GraphPartitioner::staysConnected(const Level& level,const vector<uint32_t>& parts,uint32_t node) const{
+     uint32_t part = parts[node];
+     set<uint32_t> neighbours;
+     for(uint32_t p = level.offsets[node]; p < level.offsets[node + 1]; p++){
+          if (parts[level.targets[p]] == part){
+               neighbours.insert(level.targets[p]);
+          }
+     }
+     if (neighbours.size() <= 1){
+          return true;
+     }
+
+     set<uint32_t> reached;
+     vector<uint32_t> queue(1,*neighbours.begin());
+     reached.insert(node);
+     reached.insert(*neighbours.begin());
+     size_t found = 1;
+     for(uint32_t q=0; q < queue.size() && reached.size() <= CONNECTED_SEARCH; q++){
+          uint32_t n = queue[q];
+          for(uint32_t p = level.offsets[n]; p < level.offsets[n + 1]; p++){
+               uint32_t t = level.targets[p];
+               if (parts[t] != part || !reached.insert(t).second){
+                    continue;
+               }
+               if (neighbours.count(t) > 0 && ++found == neighbours.size()){
+                    return true;
+               }
+               queue.push_back(t);
+          }
+     }
+     return false;
+}
+
+/*
+ * Streets inside a territory belong to it. A street between two goes to
+ * the one with less to fly so far.
+ */
+void GraphPartitioner::assignStreets(const vector<uint32_t>& parts){
+     const GraphTopology& topology = data->getTopology();
+     uint32_t edgeCount = topology.getEdgeCount();
+     owners.assign(edgeCount,NONE);
+     lengths.assign(partCount,0);
+     times.assign(partCount,0);
+
+     for(int between=0; between < 2; between++){
+          for(uint32_t e=0; e < edgeCount; e++){
+               uint32_t reverse = topology.getReverseEdge(e);
+               if (reverse != NONE && reverse < e){
+                    continue;
+               }
+               uint32_t u = levelNodes[topology.getEdgeSource(e)];
+               uint32_t v = levelNodes[topology.getEdgeTarget(e)];
+               if (u == NONE){
+                    leftOutStreets += between == 0 ? 1 : 0;
+                    continue;
+               }
+               if ((parts[u] != parts[v]) != (between == 1)){
+                    continue;
+               }
+
+               uint32_t owner = times[parts[u]] <= times[parts[v]] ? parts[u] : parts[v];
+               owners[e] = owner;
+               if (reverse != NONE){
+                    owners[reverse] = owner;
+               }
+               double length = getLength(e);
+               lengths[owner] += length;
+               times[owner] += length / speed + pause;
+          }
+     }
+}
+
+/* The base of a territory is its node nearest to the middle of its streets, weighted by length. */
+void GraphPartitioner::placeBases(){
+     const GraphTopology& topology = data->getTopology();
+     uint32_t edgeCount = topology.getEdgeCount();
+     vector<double> xs(partCount,0);
+     vector<double> ys(partCount,0);
+     vector<double> weights(partCount,0);
+     for(uint32_t e=0; e < edgeCount; e++){
+          if (owners[e] == NONE){
+               continue;
+          }
+          uint32_t from = topology.getEdgeSource(e);
+          uint32_t to = topology.getEdgeTarget(e);
+          double weight = getLength(e) + 1e-6;
+          xs[owners[e]] += weight * (topology.getX(from) + topology.getX(to)) / 2;
+          ys[owners[e]] += weight * (topology.getY(from) + topology.getY(to)) / 2;
+          weights[owners[e]] += weight;
+     }
+
+     bases.assign(partCount,NONE);
+     vector<double> distances(partCount,0);
+     for(uint32_t e=0; e < edgeCount; e++){
+          uint32_t owner = owners[e];
+          if (owner == NONE){
+               continue;
+          }
+          uint32_t node = topology.getEdgeSource(e);
+          double dx = topology.getX(node) - xs[owner] / weights[owner];
+          double dy = topology.getY(node) - ys[owner] / weights[owner];
+          double distance = dx*dx + dy*dy;
+          if (bases[owner] == NONE || distance < distances[owner]){
+               bases[owner] = node;
+               distances[owner] = distance;
+          }
+     }
+}
+
+string GraphPartitioner::getMetrics() const{
+     const GraphTopology& topology = data->getTopology();
+
+     // nodes on the edges of more than one territory
+     vector<uint32_t> firstOwners(topology.getNodeCount(),NONE);
+     vector<bool> shared(topology.getNodeCount(),false);
+     uint32_t sharedNodes = 0;
+     for(uint32_t e=0; e < owners.size(); e++){
+          uint32_t node = topology.getEdgeSource(e);
+          if (owners[e] == NONE){
+               continue;
+          }
+          if (firstOwners[node] == NONE){
+               firstOwners[node] = owners[e];
+          }
+          else if (firstOwners[node] != owners[e] && !shared[node]){
+               shared[node] = true;
+               sharedNodes++;
+          }
+     }
+
+     double lengthTotal = 0;
+     double lengthMax = 0;
+     double timeTotal = 0;
+     double timeMax = 0;
+     for(uint32_t i=0; i < partCount; i++){
+          lengthTotal += lengths[i];
+          lengthMax = lengths[i] > lengthMax ? lengths[i] : lengthMax;
+          timeTotal += times[i];
+          timeMax = times[i] > timeMax ? times[i] : timeMax;
+     }
+     double lengthAverage = partCount > 0 ? lengthTotal / partCount : 0;
+     double timeAverage = partCount > 0 ? timeTotal / partCount : 0;
+
+     stringstream metrics;
+     metrics << "territories:" << partCount << ";";
+     metrics << "trials:" << trialCount << ";";
+     metrics << "cut streets:" << cutStreets << ";";
+     metrics << "shared nodes:" << sharedNodes << ";";
+     metrics << "left out streets:" << leftOutStreets << ";";
+     metrics << "average length:" << lengthAverage << ";";
+     metrics << "max length:" << lengthMax << ";";
+     metrics << "length imbalance:" << (lengthAverage > 0 ? lengthMax / lengthAverage : 0) << ";";
+     metrics << "average time:" << timeAverage << ";";
+     metrics << "max time:" << timeMax << ";";
+     metrics << "time imbalance:" << (timeAverage > 0 ? timeMax / timeAverage : 0) << ";";
+     metrics << "partition time:" << elapsed << "ms;";
+     return metrics.str();
+}
+
+/*
+ * Writes g0.xml .. g<k-1>.xml, fleet.xml and metrics.txt into directory,
+ * which must exist. With binary every subgraph is also converted to the
+ * binary graph format. The fleet file names the subgraphs relative to
+ * itself and puts the base of every team on its territory's base node.
+ */
+bool GraphPartitioner::write(string directory,bool binary) const{
+     if (!directory.empty() && directory[directory.size() - 1] != '/'){
+          directory += "/";
+     }
+
+     const GraphTopology& topology = data->getTopology();
+     ofstream fleet((directory + "fleet.xml").c_str());
+     fleet << setprecision(10) << "<fleet>" << endl;
+     for(uint32_t i=0; i < partCount; i++){
+          stringstream name;
+          name << "g" << i << ".xml";
+          if (!writeSubgraph(i,directory + name.str())){
+               return false;
+          }
+          if (binary && !GraphData::convert(directory + name.str())){
+               return false;
+          }
+
+          stringstream network;
+          network << "10." << i / 256 << "." << i % 256;
+          fleet << "<team>" << endl;
+          fleet << "<base x='" << topology.getX(bases[i]) << "' y='" << topology.getY(bases[i]) << "' ip='" << network.str() << ".1' />" << endl;
+          fleet << "<uav graph='" << name.str() << "' ip='" << network.str() << ".2' />" << endl;
+          fleet << "</team>" << endl;
+     }
+     fleet << "</fleet>" << endl;
+     if (!fleet){
+          return false;
+     }
+
+     ofstream metrics((directory + "metrics.txt").c_str());
+     metrics << getMetrics() << endl;
+     for(uint32_t i=0; i < partCount; i++){
+          metrics << "territory:" << i << ";base:" << topology.getId(bases[i]) << ";length:" << lengths[i] << ";time:" << times[i] << ";" << endl;
+     }
+     return (bool) metrics;
+}
+
+/* The nodes and edges of one territory, in the format of the gN.xml files of data/. */
+bool GraphPartitioner::writeSubgraph(uint32_t territory,string file) const{
+     const GraphTopology& topology = data->getTopology();
+     vector<bool> written(topology.getNodeCount(),false);
+
+     ofstream out(file.c_str());
+     out << setprecision(10) << "<graph>" << endl << "<nodes>" << endl;
+     for(uint32_t e=0; e < owners.size(); e++){
+          if (owners[e] != territory){
+               continue;
+          }
+          uint32_t ends[2] = { topology.getEdgeSource(e), topology.getEdgeTarget(e) };
+          for(int i=0; i < 2; i++){
+               uint32_t node = ends[i];
+               if (written[node]){
+                    continue;
+               }
+               written[node] = true;
+               out << "<node id='" << topology.getId(node) << "' x='" << topology.getX(node) << "' y='" << topology.getY(node)
+                   << "' type='" << (node == bases[territory] ? "base" : "node") << "' />" << endl;
+          }
+     }
+     out << "</nodes>" << endl << "<edges>" << endl;
+     for(uint32_t e=0; e < owners.size(); e++){
+          if (owners[e] == territory){
+               out << "<edge from='" << topology.getId(topology.getEdgeSource(e)) << "' to='" << topology.getId(topology.getEdgeTarget(e)) << "' />" << endl;
+          }
+     }
+     out << "</edges>" << endl << "</graph>" << endl;
+     return (bool) out;
+}
+
+}
@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#ifndef GRAPHPARTITIONER_H_
+#define GRAPHPARTITIONER_H_
+
+#include "GraphData.h"
+#include "ns3/ptr.h"
+#include "ns3/random-variable-stream.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace ns3{
+
+/**
+ * \ingroup mobility
+ * \brief Cuts a graph into balanced, connected territories.
+ *
+ * Every street (an edge and its reverse) of the largest connected part of
+ * the graph goes to one of k territories, so that the time to fly all
+ * streets of a territory once, pauses included, is about the same for all
+ * of them and few streets cross between territories. The streets of
+ * smaller disconnected parts are left out.
+ *
+ * The cut is multilevel: dead ends are folded into the node they hang
+ * from, the node graph is coarsened by merging nodes along their heaviest
+ * connection, the coarsest graph is cut by growing k regions from spread
+ * out seeds, and the cut is projected back level by level. At each level
+ * the heaviest territories pass nodes along chains of neighbours to light
+ * ones, then boundary nodes move greedily to cut fewer streets. Merged
+ * nodes are always adjacent and a move never splits a territory, so every
+ * territory stays connected. Streets between two territories go to the
+ * one with less to fly; their far node is shared with the neighbour, as
+ * in the gN.xml files of data/.
+ *
+ * partition() runs several trials on a pool of threads, each with its own
+ * random stream for the matchings, seeds and move orders, and keeps the
+ * balanced one with the fewest cut streets. write() saves one subgraph per
+ * territory, with its base at the node nearest to the middle of its
+ * streets, a fleet file with one UAV per territory and the metrics.
+ */
+class GraphPartitioner {
+private:
+     // undirected graph of one level, rows in compressed sparse row form
+     struct Level {
+          vector<uint32_t> offsets;
+          vector<uint32_t> targets;
+          vector<double> edgeWeights; // streets between the two nodes
+          vector<double> nodeWeights; // seconds to fly the streets of the node
+          vector<uint32_t> merged;    // by node of the next finer level, node it was merged into
+     };
+
+     struct Trial {
+          Ptr<UniformRandomVariable> random;
+          vector<uint32_t> parts;     // by node of the finest level
+          double cut;
+          double heaviest;
+     };
+
+     Ptr<GraphData> data;
+     double speed;     // m/s
+     double pause;     // seconds
+     double imbalance; // allowed excess of the heaviest territory over the average
+     uint32_t threads;
+     uint32_t trialCount;
+     int64_t stream;
+
+     Level finest;                 // nodes of the largest connected part
+     double totalWeight;           // seconds to fly all streets of the finest level
+     vector<uint32_t> levelNodes;  // by node handle, node of the finest level or NONE
+     vector<uint32_t> graphNodes;  // by node of the finest level, node handle
+     uint32_t partCount;
+     vector<uint32_t> owners;      // by edge handle, territory or NONE
+     vector<uint32_t> bases;       // by territory, node handle
+     vector<double> lengths;       // by territory, meters
+     vector<double> times;         // by territory, seconds
+     uint32_t cutStreets;          // between nodes of different territories
+     uint32_t leftOutStreets;      // outside the largest connected part
+     double elapsed;               // milliseconds
+
+     vector<Trial>* pending; // trials shared by the threads
+
+     double getLength(uint32_t edge) const;
+     void buildFinest();
+     void runPending(uint32_t i);
+     void runTrial(Trial& trial) const;
+     void coarsen(const Level& fine,Level& coarse,UniformRandomVariable& random) const;
+     void grow(const Level& level,vector<uint32_t>& parts,UniformRandomVariable& random) const;
+     void balance(const Level& level,vector<uint32_t>& parts) const;
+     void refine(const Level& level,vector<uint32_t>& parts,UniformRandomVariable& random) const;
+     bool staysConnected(const Level& level,const vector<uint32_t>& parts,uint32_t node) const;
+     void assignStreets(const vector<uint32_t>& parts);
+     void placeBases();
+     bool writeSubgraph(uint32_t territory,string file) const;
+
+public:
+     static const uint32_t COARSEST_NODES = 16;   // per territory
+     static const uint32_t REFINE_PASSES = 8;
+     static const uint32_t CONNECTED_SEARCH = 256; // nodes searched before a move is refused
+
+     GraphPartitioner(Ptr<GraphData> data,double speed,double pause);
+     void setImbalance(double imbalance);
+     void setThreads(uint32_t n);
+     void setTrials(uint32_t n);
+     void assignStreams(int64_t stream);
+
+     bool partition(uint32_t k);
+     bool write(string directory,bool binary) const;
+
+     uint32_t getPartCount() const { return partCount; }
+     uint32_t getOwner(uint32_t edge) const { return owners[edge]; }
+     uint32_t getBase(uint32_t territory) const { return bases[territory]; }
+     double getLoadLength(uint32_t territory) const { return lengths[territory]; } // meters
+     double getLoadTime(uint32_t territory) const { return times[territory]; }     // seconds
+     string getMetrics() const;
+};
+
+}
+
+#endif /* GRAPHPARTITIONER_H_ */
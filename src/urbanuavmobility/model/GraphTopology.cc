@@ -0,0 +1,687 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#include "GraphTopology.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+namespace ns3{
+
+const uint32_t GraphTopology::NONE;
+const uint32_t GraphTopology::FILE_VERSION;
+
+/*
+ * Binary graph file: a header followed by the topology arrays, each
+ * starting on an 8 byte boundary, in the order of GraphFileLayout.
+ */
+struct GraphFileHeader {
+     char magic[4];      // "UAVG"
+     uint32_t byteOrder; // 0x01020304 as written by the host
+     uint32_t version;
+     uint32_t nodeCount;
+     uint32_t edgeCount;
+     uint32_t base;
+     uint32_t namesSize;
+     uint32_t reserved;
+};
+
+struct GraphFileLayout {
+     size_t xs;
+     size_t ys;
+     size_t offsets;
+     size_t targets;
+     size_t sources;
+     size_t reverse;
+     size_t namesOffsets;
+     size_t sorted;
+     size_t names;
+     size_t size;
+};
+
+static size_t align8(size_t position){
+     return (position + 7) & ~((size_t) 7);
+}
+
+static GraphFileLayout getLayout(uint32_t n,uint32_t m,uint32_t namesSize){
+     GraphFileLayout layout;
+     layout.xs = align8(sizeof(GraphFileHeader));
+     layout.ys = align8(layout.xs + n * sizeof(double));
+     layout.offsets = align8(layout.ys + n * sizeof(double));
+     layout.targets = align8(layout.offsets + (n + 1) * sizeof(uint32_t));
+     layout.sources = align8(layout.targets + m * sizeof(uint32_t));
+     layout.reverse = align8(layout.sources + m * sizeof(uint32_t));
+     layout.namesOffsets = align8(layout.reverse + m * sizeof(uint32_t));
+     layout.sorted = align8(layout.namesOffsets + n * sizeof(uint32_t));
+     layout.names = align8(layout.sorted + n * sizeof(uint32_t));
+     layout.size = layout.names + namesSize;
+     return layout;
+}
+
+/*
+ * Checks every array of a mapped file against the counts of its header, so
+ * a truncated or corrupt file is rejected before any handle read from it
+ * is used as an index.
+ */
+static bool isConsistent(const char* base,const GraphFileHeader* header,const GraphFileLayout& layout){
+     uint32_t n = header->nodeCount;
+     uint32_t m = header->edgeCount;
+     const uint32_t* offsets = (const uint32_t*) (base + layout.offsets);
+     const uint32_t* targets = (const uint32_t*) (base + layout.targets);
+     const uint32_t* sources = (const uint32_t*) (base + layout.sources);
+     const uint32_t* reverse = (const uint32_t*) (base + layout.reverse);
+     const uint32_t* namesOffsets = (const uint32_t*) (base + layout.namesOffsets);
+     const uint32_t* sorted = (const uint32_t*) (base + layout.sorted);
+
+     if (n == 0xffffffff || (header->base != 0xffffffff && header->base >= n)){
+          return false;
+     }
+     if (offsets[0] != 0 || offsets[n] != m){
+          return false;
+     }
+     if (header->namesSize > 0 && base[layout.names + header->namesSize - 1] != '\0'){
+          return false;
+     }
+     for(uint32_t i=0; i < n; i++){
+          if (offsets[i+1] < offsets[i] || sorted[i] >= n || namesOffsets[i] >= header->namesSize){
+               return false;
+          }
+     }
+     for(uint32_t e=0; e < m; e++){
+          if (targets[e] >= n || sources[e] >= n || (reverse[e] >= m && reverse[e] != 0xffffffff)){
+               return false;
+          }
+     }
+     return true;
+}
+
+template <class T>
+static const T* getData(const vector<T>& values){
+     return values.empty() ? NULL : &values[0];
+}
+
+struct NameOrder {
+     const char* names;
+     const uint32_t* namesOffsets;
+     bool operator()(uint32_t a,uint32_t b) const {
+          return strcmp(names + namesOffsets[a],names + namesOffsets[b]) < 0;
+     }
+};
+
+GraphTopology::GraphTopology() {
+     mapped = NULL;
+     mappedSize = 0;
+     sharedNames = NULL;
+     closedCount = 0;
+     baseNode = NONE;
+     bind();
+}
+
+GraphTopology::~GraphTopology() {
+     unmap();
+}
+
+void GraphTopology::bind(){
+     if (mapped != NULL){
+          return;
+     }
+
+     nodeCount = (uint32_t) xsData.size();
+     xs = getData(xsData);
+     ys = getData(ysData);
+     bindEdges();
+     namesOffsets = getData(namesOffsetsData);
+     sorted = getData(sortedData);
+     names = sharedNames != NULL ? sharedNames : getData(namesData);
+}
+
+void GraphTopology::bindEdges(){
+     edgeCount = (uint32_t) targetsData.size();
+     offsets = getData(offsetsData);
+     targets = getData(targetsData);
+     sources = getData(sourcesData);
+     reverse = getData(reverseData);
+}
+
+/*
+ * Copies the rows out of a mapped file, so edges can be inserted; the
+ * nodes and ids stay mapped.
+ */
+void GraphTopology::ownEdges(){
+     if (mapped == NULL || offsets == getData(offsetsData)){
+          return;
+     }
+
+     offsetsData.assign(offsets,offsets + nodeCount + 1);
+     targetsData.assign(targets,targets + edgeCount);
+     sourcesData.assign(sources,sources + edgeCount);
+     reverseData.assign(reverse,reverse + edgeCount);
+     bindEdges();
+}
+
+void GraphTopology::materialize(){
+     if (mapped == NULL){
+          return;
+     }
+
+     ownEdges();
+     uint32_t namesSize = getNamesSize();
+     xsData.assign(xs,xs + nodeCount);
+     ysData.assign(ys,ys + nodeCount);
+     namesOffsetsData.assign(namesOffsets,namesOffsets + nodeCount);
+     sortedData.assign(sorted,sorted + nodeCount);
+     namesData.assign(names,names + namesSize);
+
+     unmap();
+     bind();
+}
+
+void GraphTopology::unmap(){
+     if (mapped != NULL){
+          munmap(mapped,mappedSize);
+          mapped = NULL;
+          mappedSize = 0;
+     }
+}
+
+size_t GraphTopology::getBytes() const{
+     // rows copied out of a mapped file by insertEdge() come on top of it
+     if (mapped != NULL){
+          return mappedSize + closedData.capacity() / 8 +
+               (offsetsData.capacity() + targetsData.capacity() + sourcesData.capacity() +
+                reverseData.capacity()) * sizeof(uint32_t);
+     }
+
+     return (xsData.capacity() + ysData.capacity()) * sizeof(double) + closedData.capacity() / 8 +
+          (offsetsData.capacity() + targetsData.capacity() + sourcesData.capacity() +
+           reverseData.capacity() + namesOffsetsData.capacity() + sortedData.capacity()) * sizeof(uint32_t) +
+          namesData.capacity();
+}
+
+/* Copies the ids of the nodes out of a shared string table. */
+void GraphTopology::ownNames(){
+     if (sharedNames == NULL){
+          return;
+     }
+
+     vector<char> owned;
+     for(uint32_t i=0; i < nodeCount; i++){
+          const char* id = names + namesOffsets[i];
+          namesOffsetsData[i] = (uint32_t) owned.size();
+          owned.insert(owned.end(),id,id + strlen(id) + 1);
+     }
+     namesData.swap(owned);
+     sharedNames = NULL;
+     bind();
+}
+
+uint32_t GraphTopology::getNamesSize() const{
+     if (nodeCount == 0){
+          return 0;
+     }
+
+     const char* last = names + namesOffsets[nodeCount - 1];
+     return (uint32_t) (last - names + strlen(last) + 1);
+}
+
+uint32_t GraphTopology::addNode(const string& id,double x,double y){
+     materialize();
+     ownNames();
+
+     uint32_t node = find(id);
+     if (node != NONE){
+          xsData[node] = x;
+          ysData[node] = y;
+          return node;
+     }
+
+     node = nodeCount;
+     namesOffsetsData.push_back((uint32_t) namesData.size());
+     namesData.insert(namesData.end(),id.begin(),id.end());
+     namesData.push_back('\0');
+     xsData.push_back(x);
+     ysData.push_back(y);
+     pendingNodes[id] = node;
+     bind();
+     return node;
+}
+
+bool GraphTopology::addEdge(const string& from,const string& to){
+     uint32_t f = find(from);
+     uint32_t t = find(to);
+     if (f == NONE || t == NONE){
+          return false;
+     }
+
+     pendingFrom.push_back(f);
+     pendingTo.push_back(t);
+     return true;
+}
+
+void GraphTopology::setBase(uint32_t node){
+     baseNode = node;
+}
+
+/* Builds the rows from the edges added so far; every edge is open again. */
+void GraphTopology::finalize(){
+     materialize();
+     uint32_t n = nodeCount;
+     closedData.clear();
+     closedCount = 0;
+
+     // keep the edges already in the rows, then append the pending ones
+     for(uint32_t e=0; e < edgeCount; e++){
+          pendingFrom.push_back(sources[e]);
+          pendingTo.push_back(targets[e]);
+     }
+
+     offsetsData.assign(n + 1,0);
+     for(uint32_t i=0; i < (uint32_t) pendingFrom.size(); i++){
+          offsetsData[pendingFrom[i] + 1]++;
+     }
+     for(uint32_t i=0; i < n; i++){
+          offsetsData[i + 1] += offsetsData[i];
+     }
+
+     // counting sort by source keeps each row in file order
+     targetsData.assign(pendingFrom.size(),0);
+     sourcesData.assign(pendingFrom.size(),0);
+     vector<uint32_t> cursor(offsetsData.begin(),offsetsData.end() - 1);
+     for(uint32_t i=0; i < (uint32_t) pendingFrom.size(); i++){
+          uint32_t e = cursor[pendingFrom[i]]++;
+          sourcesData[e] = pendingFrom[i];
+          targetsData[e] = pendingTo[i];
+     }
+
+     vector<uint32_t>().swap(pendingFrom);
+     vector<uint32_t>().swap(pendingTo);
+     bind();
+
+     reverseData.assign(edgeCount,NONE);
+     for(uint32_t e=0; e < edgeCount; e++){
+          reverseData[e] = findEdge(targets[e],sources[e]);
+     }
+
+     sortedData.resize(n);
+     for(uint32_t i=0; i < n; i++){
+          sortedData[i] = i;
+     }
+     NameOrder order;
+     order.names = names;
+     order.namesOffsets = getData(namesOffsetsData);
+     sort(sortedData.begin(),sortedData.end(),order);
+     pendingNodes.clear();
+
+     bind();
+}
+
+void GraphTopology::clear(){
+     unmap();
+     xsData.clear();
+     ysData.clear();
+     offsetsData.clear();
+     targetsData.clear();
+     sourcesData.clear();
+     reverseData.clear();
+     namesOffsetsData.clear();
+     sortedData.clear();
+     namesData.clear();
+     pendingNodes.clear();
+     pendingFrom.clear();
+     pendingTo.clear();
+     closedData.clear();
+     closedCount = 0;
+     sharedNames = NULL;
+     baseNode = NONE;
+     bind();
+}
+
+/*
+ * Replaces this topology with the subgraph of parent induced by nodes,
+ * which must be sorted parent handles without repeats: node i here is
+ * nodes[i] there, and every edge of parent between two of the nodes is
+ * kept, in the order of its row and closed if it is closed there. Ids are
+ * not copied but read from the string table of parent, and the id order
+ * is the one of parent restricted to the nodes, so nothing is compared by
+ * name.
+ */
+void GraphTopology::extract(const GraphTopology& parent,const vector<uint32_t>& nodes){
+     clear();
+     uint32_t n = (uint32_t) nodes.size();
+
+     xsData.resize(n);
+     ysData.resize(n);
+     namesOffsetsData.resize(n);
+     offsetsData.assign(n + 1,0);
+     for(uint32_t i=0; i < n; i++){
+          uint32_t node = nodes[i];
+          xsData[i] = parent.xs[node];
+          ysData[i] = parent.ys[node];
+          namesOffsetsData[i] = parent.namesOffsets[node];
+          if (node == parent.baseNode){
+               baseNode = i;
+          }
+
+          for(uint32_t e = parent.getFirstEdge(node); e < parent.getLastEdge(node); e++){
+               vector<uint32_t>::const_iterator target = lower_bound(nodes.begin(),nodes.end(),parent.targets[e]);
+               if (target != nodes.end() && *target == parent.targets[e]){
+                    if (!parent.isOpen(e)){
+                         closedData.resize(targetsData.size() + 1,false);
+                         closedData.back() = true;
+                         closedCount++;
+                    }
+                    sourcesData.push_back(i);
+                    targetsData.push_back((uint32_t) (target - nodes.begin()));
+               }
+          }
+          offsetsData[i + 1] = (uint32_t) targetsData.size();
+     }
+
+     if (closedCount > 0){
+          closedData.resize(targetsData.size(),false);
+     }
+     sharedNames = parent.names;
+     bind();
+
+     reverseData.assign(edgeCount,NONE);
+     for(uint32_t e=0; e < edgeCount; e++){
+          reverseData[e] = findEdge(targets[e],sources[e]);
+     }
+
+     // the parent's id order, walked from whichever side is shorter
+     uint32_t parentCount = parent.nodeCount - (uint32_t) parent.pendingNodes.size();
+     if (n * 32 < parentCount){
+          sortedData.resize(n);
+          for(uint32_t i=0; i < n; i++){
+               sortedData[i] = i;
+          }
+          NameOrder order;
+          order.names = names;
+          order.namesOffsets = namesOffsets;
+          sort(sortedData.begin(),sortedData.end(),order);
+     }
+     else {
+          for(uint32_t i=0; i < parentCount; i++){
+               vector<uint32_t>::const_iterator node = lower_bound(nodes.begin(),nodes.end(),parent.sorted[i]);
+               if (node != nodes.end() && *node == parent.sorted[i]){
+                    sortedData.push_back((uint32_t) (node - nodes.begin()));
+               }
+          }
+     }
+
+     bind();
+}
+
+bool GraphTopology::save(const char* file) const{
+     if (!pendingNodes.empty() || !pendingFrom.empty() || offsets == NULL){
+          return false;
+     }
+
+     // a shared string table holds the ids of other nodes too, so only the
+     // ids of this topology's nodes are written
+     const char* savedNames = names;
+     const uint32_t* savedOffsets = namesOffsets;
+     vector<char> ownedNames;
+     vector<uint32_t> ownedOffsets;
+     if (sharedNames != NULL){
+          for(uint32_t i=0; i < nodeCount; i++){
+               const char* id = names + namesOffsets[i];
+               ownedOffsets.push_back((uint32_t) ownedNames.size());
+               ownedNames.insert(ownedNames.end(),id,id + strlen(id) + 1);
+          }
+          savedNames = getData(ownedNames);
+          savedOffsets = getData(ownedOffsets);
+     }
+
+     uint32_t namesSize = sharedNames != NULL ? (uint32_t) ownedNames.size() : getNamesSize();
+     GraphFileLayout layout = getLayout(nodeCount,edgeCount,namesSize);
+     vector<char> buffer(layout.size,0);
+
+     GraphFileHeader header;
+     memset(&header,0,sizeof(header));
+     memcpy(header.magic,"UAVG",4);
+     header.byteOrder = 0x01020304;
+     header.version = FILE_VERSION;
+     header.nodeCount = nodeCount;
+     header.edgeCount = edgeCount;
+     header.base = baseNode;
+     header.namesSize = namesSize;
+
+     memcpy(&buffer[0],&header,sizeof(header));
+     if (nodeCount > 0){
+          memcpy(&buffer[layout.xs],xs,nodeCount * sizeof(double));
+          memcpy(&buffer[layout.ys],ys,nodeCount * sizeof(double));
+          memcpy(&buffer[layout.namesOffsets],savedOffsets,nodeCount * sizeof(uint32_t));
+          memcpy(&buffer[layout.sorted],sorted,nodeCount * sizeof(uint32_t));
+          memcpy(&buffer[layout.names],savedNames,namesSize);
+     }
+     memcpy(&buffer[layout.offsets],offsets,(nodeCount + 1) * sizeof(uint32_t));
+     if (edgeCount > 0){
+          memcpy(&buffer[layout.targets],targets,edgeCount * sizeof(uint32_t));
+          memcpy(&buffer[layout.sources],sources,edgeCount * sizeof(uint32_t));
+          memcpy(&buffer[layout.reverse],reverse,edgeCount * sizeof(uint32_t));
+     }
+
+     // written next to the target and renamed, so readers never map a
+     // partially written file
+     string temporary = string(file) + ".tmp";
+     FILE* out = fopen(temporary.c_str(),"wb");
+     if (out == NULL){
+          return false;
+     }
+
+     bool written = fwrite(&buffer[0],1,buffer.size(),out) == buffer.size();
+     written = (fclose(out) == 0) && written;
+     if (!written || rename(temporary.c_str(),file) != 0){
+          remove(temporary.c_str());
+          return false;
+     }
+
+     return true;
+}
+
+bool GraphTopology::open(const char* file){
+     int fd = ::open(file,O_RDONLY);
+     if (fd < 0){
+          return false;
+     }
+
+     struct stat info;
+     if (fstat(fd,&info) != 0 || (size_t) info.st_size < sizeof(GraphFileHeader)){
+          close(fd);
+          return false;
+     }
+
+     size_t size = (size_t) info.st_size;
+     void* data = mmap(NULL,size,PROT_READ,MAP_PRIVATE,fd,0);
+     close(fd);
+     if (data == MAP_FAILED){
+          return false;
+     }
+
+     const GraphFileHeader* header = (const GraphFileHeader*) data;
+     GraphFileLayout layout = getLayout(header->nodeCount,header->edgeCount,header->namesSize);
+     const char* base = (const char*) data;
+
+     bool valid = memcmp(header->magic,"UAVG",4) == 0 &&
+          header->byteOrder == 0x01020304 &&
+          header->version == FILE_VERSION &&
+          layout.size <= size &&
+          isConsistent(base,header,layout);
+
+     if (!valid){
+          munmap(data,size);
+          return false;
+     }
+
+     clear();
+     mapped = data;
+     mappedSize = size;
+     nodeCount = header->nodeCount;
+     edgeCount = header->edgeCount;
+     baseNode = header->base;
+     xs = (const double*) (base + layout.xs);
+     ys = (const double*) (base + layout.ys);
+     offsets = (const uint32_t*) (base + layout.offsets);
+     targets = (const uint32_t*) (base + layout.targets);
+     sources = (const uint32_t*) (base + layout.sources);
+     reverse = (const uint32_t*) (base + layout.reverse);
+     namesOffsets = (const uint32_t*) (base + layout.namesOffsets);
+     sorted = (const uint32_t*) (base + layout.sorted);
+     names = base + layout.names;
+     return true;
+}
+
+uint32_t GraphTopology::find(const string& id) const{
+     map<string,uint32_t>::const_iterator pending = pendingNodes.find(id);
+     if (pending != pendingNodes.end()){
+          return pending->second;
+     }
+
+     // nodes added since the last finalize are only in the pending map
+     uint32_t low = 0;
+     uint32_t high = nodeCount - (uint32_t) pendingNodes.size();
+     const char* key = id.c_str();
+     while (low < high){
+          uint32_t middle = low + (high - low) / 2;
+          int order = strcmp(names + namesOffsets[sorted[middle]],key);
+          if (order == 0){
+               return sorted[middle];
+          }
+          if (order < 0){
+               low = middle + 1;
+          }
+          else {
+               high = middle;
+          }
+     }
+     return NONE;
+}
+
+void GraphTopology::setOpen(uint32_t edge,bool open){
+     if (edge >= edgeCount || isOpen(edge) == open){
+          return;
+     }
+
+     if (closedData.empty()){
+          closedData.assign(edgeCount,false);
+     }
+     closedData[edge] = !open;
+     if (open){
+          closedCount--;
+     }
+     else {
+          closedCount++;
+     }
+}
+
+/*
+ * Adds the edge from from to to, open, at the end of the row of from and
+ * returns its handle; handles from that one on move up by one. Returns the
+ * handle of the edge if there already is one, and NONE if the topology is
+ * not finalized or a node does not exist.
+ */
+uint32_t GraphTopology::insertEdge(uint32_t from,uint32_t to){
+     if (from >= nodeCount || to >= nodeCount || offsets == NULL || !pendingNodes.empty()){
+          return NONE;
+     }
+
+     uint32_t existing = findEdge(from,to);
+     if (existing != NONE){
+          return existing;
+     }
+
+     ownEdges();
+     uint32_t edge = offsetsData[from + 1];
+     for(uint32_t n = from + 1; n <= nodeCount; n++){
+          offsetsData[n]++;
+     }
+     targetsData.insert(targetsData.begin() + edge,to);
+     sourcesData.insert(sourcesData.begin() + edge,from);
+     for(uint32_t e=0; e < reverseData.size(); e++){
+          if (reverseData[e] != NONE && reverseData[e] >= edge){
+               reverseData[e]++;
+          }
+     }
+     reverseData.insert(reverseData.begin() + edge,NONE);
+     if (!closedData.empty()){
+          closedData.insert(closedData.begin() + edge,false);
+     }
+     bindEdges();
+
+     uint32_t back = findEdge(to,from);
+     reverseData[edge] = back;
+     if (back != NONE){
+          reverseData[back] = edge;
+     }
+     return edge;
+}
+
+uint32_t GraphTopology::getOpenDegree(uint32_t node) const{
+     if (closedCount == 0){
+          return getDegree(node);
+     }
+
+     uint32_t degree = 0;
+     for(uint32_t e = getFirstEdge(node); e < getLastEdge(node); e++){
+          if (!closedData[e]){
+               degree++;
+          }
+     }
+     return degree;
+}
+
+uint32_t GraphTopology::findEdge(uint32_t from,uint32_t to) const{
+     if (from >= nodeCount || offsets == NULL){
+          return NONE;
+     }
+
+     for(uint32_t e = getFirstEdge(from); e < getLastEdge(from); e++){
+          if (targets[e] == to){
+               return e;
+          }
+     }
+     return NONE;
+}
+
+uint32_t GraphTopology::getBase() const{
+     if (baseNode != NONE || nodeCount == 0){
+          return baseNode;
+     }
+
+     // without an explicit base the lowest id is the root, as with the old
+     // id-ordered node map
+     uint32_t lowest = NONE;
+     if (nodeCount > (uint32_t) pendingNodes.size()){
+          lowest = sorted[0];
+     }
+     if (!pendingNodes.empty() &&
+         (lowest == NONE || pendingNodes.begin()->first < getId(lowest))){
+          lowest = pendingNodes.begin()->second;
+     }
+     return lowest;
+}
+
+}
@@ -0,0 +1,153 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#ifndef GRAPHTOPOLOGY_H_
+#define GRAPHTOPOLOGY_H_
+
+#include <stdint.h>
+#include <cstddef>
+#include <map>
+#include <vector>
+#include <string>
+
+using namespace std;
+
+namespace ns3{
+
+/**
+ * \ingroup mobility
+ * \brief Compact graph topology.
+ *
+ * Nodes are interned to dense 32-bit handles in the order they are added.
+ * Coordinates are kept as separate x/y arrays and adjacency is stored in
+ * compressed sparse row form, so the neighbours of node n are
+ * targets[offsets[n]] .. targets[offsets[n+1]-1]. The position of an edge
+ * in the targets array is its edge handle, and the handle of the edge
+ * running the other way is precomputed so both directions of a street can
+ * be updated without a search. Node ids are kept in one string table.
+ *
+ * Nodes and edges are added while loading; finalize() builds the rows.
+ * The same arrays can be written to a binary graph file with save() and
+ * mapped back into memory with open(), which needs no parsing at all;
+ * every array is checked against the header once, and a file that does
+ * not agree with it is rejected.
+ *
+ * Edges can be closed and opened again at runtime without touching the
+ * rows, so edge handles stay valid; strategies and searches skip closed
+ * edges. insertEdge() adds an edge to a finalized topology in place: the
+ * new edge takes the handle after the last edge of its source, and every
+ * edge handle from there on moves up by one. Neither is saved.
+ *
+ * extract() copies the subgraph induced by some nodes of another topology.
+ * The copy reads its node ids from the other topology's string table, which
+ * must outlive it, until a node is added to it.
+ */
+class GraphTopology {
+private:
+     // storage owned by the topology, used unless a file is mapped
+     vector<double> xsData;
+     vector<double> ysData;
+     vector<uint32_t> offsetsData;
+     vector<uint32_t> targetsData;
+     vector<uint32_t> sourcesData;
+     vector<uint32_t> reverseData;
+     vector<uint32_t> namesOffsetsData;
+     vector<uint32_t> sortedData;
+     vector<char> namesData;
+     vector<bool> closedData; // indexed by edge handle, empty until an edge is closed
+     uint32_t closedCount;
+
+     // binary graph file mapped by open()
+     void* mapped;
+     size_t mappedSize;
+
+     // views over the owned or the mapped arrays
+     uint32_t nodeCount;
+     uint32_t edgeCount;
+     const double* xs;
+     const double* ys;
+     const uint32_t* offsets;
+     const uint32_t* targets;
+     const uint32_t* sources;
+     const uint32_t* reverse;
+     const uint32_t* namesOffsets;
+     const uint32_t* sorted; // node handles in id order
+     const char* names;
+     const char* sharedNames; // string table of another topology, NULL when owned
+     uint32_t baseNode;
+
+     map<string,uint32_t> pendingNodes;
+     vector<uint32_t> pendingFrom;
+     vector<uint32_t> pendingTo;
+
+     GraphTopology(const GraphTopology&);
+     GraphTopology& operator=(const GraphTopology&);
+
+     void bind();
+     void bindEdges();
+     void ownEdges();
+     void materialize();
+     void unmap();
+     void ownNames();
+     uint32_t getNamesSize() const;
+
+public:
+     static const uint32_t NONE = 0xffffffff;
+     static const uint32_t FILE_VERSION = 1;
+
+     GraphTopology();
+     ~GraphTopology();
+     uint32_t addNode(const string& id,double x,double y);
+     bool addEdge(const string& from,const string& to);
+     void setBase(uint32_t node);
+     void finalize();
+     void clear();
+     void extract(const GraphTopology& parent,const vector<uint32_t>& nodes);
+     void setOpen(uint32_t edge,bool open);
+     uint32_t insertEdge(uint32_t from,uint32_t to);
+
+     bool save(const char* file) const;
+     bool open(const char* file);
+     bool isMapped() const { return mapped != NULL; }
+     size_t getBytes() const;
+
+     uint32_t find(const string& id) const;
+     uint32_t findEdge(uint32_t from,uint32_t to) const;
+     uint32_t getBase() const;
+
+     uint32_t getNodeCount() const { return nodeCount; }
+     uint32_t getEdgeCount() const { return edgeCount; }
+     string getId(uint32_t node) const { return string(names + namesOffsets[node]); }
+     double getX(uint32_t node) const { return xs[node]; }
+     double getY(uint32_t node) const { return ys[node]; }
+     uint32_t getDegree(uint32_t node) const { return offsets[node+1] - offsets[node]; }
+     uint32_t getOpenDegree(uint32_t node) const;
+     bool isOpen(uint32_t edge) const { return closedCount == 0 || !closedData[edge]; }
+     uint32_t getClosedCount() const { return closedCount; }
+     uint32_t getFirstEdge(uint32_t node) const { return offsets[node]; }
+     uint32_t getLastEdge(uint32_t node) const { return offsets[node+1]; }
+     uint32_t getEdgeSource(uint32_t edge) const { return sources[edge]; }
+     uint32_t getEdgeTarget(uint32_t edge) const { return targets[edge]; }
+     uint32_t getReverseEdge(uint32_t edge) const { return reverse[edge]; }
+     const uint32_t* getNeighbours(uint32_t node) const { return edgeCount == 0 ? NULL : targets + offsets[node]; }
+};
+
+}
+
+#endif /* GRAPHTOPOLOGY_H_ */
@@ -0,0 +1,354 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#include "IdlenessEstimator.h"
+#include "GraphData.h"
+#include "SelectionStrategy.h"
+#include "WorkerPool.h"
+#include <cmath>
+#include <map>
+#include <time.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace ns3{
+
+static const double EULER_GAMMA = 0.5772156649;
+
+IdlenessEstimator::IdlenessEstimator(double speed,double pause,double duration){
+     this->speed = speed;
+     this->pause = pause;
+     this->duration = duration;
+     tolerance = 1e-12;
+     maxIterations = 1000000;
+     leastVisitedRounds = 4.5;
+
+     long cores = sysconf(_SC_NPROCESSORS_ONLN);
+     threads = cores > 0 ? (uint32_t) cores : 1;
+     pending = NULL;
+}
+
+void IdlenessEstimator::setThreads(uint32_t n){
+     threads = n > 0 ? n : 1;
+}
+
+/* Largest change of the distribution, summed over the nodes, at which the power iteration stops. */
+void IdlenessEstimator::setTolerance(double tolerance){
+     this->tolerance = tolerance;
+}
+
+/* Worst idleness of a least visited patrol, in rounds of all streets. */
+void IdlenessEstimator::setLeastVisitedRounds(double rounds){
+     leastVisitedRounds = rounds;
+}
+
+/*
+ * Graphs are loaded and released on the calling thread, since the counts
+ * of Ptr are not atomic and several estimates often share one file.
+ */
+void IdlenessEstimator::estimate(vector<IdlenessEstimate>& estimates){
+     map<string,Ptr<GraphData> > graphs;
+     topologies.assign(estimates.size(),NULL);
+     for(uint32_t i=0; i < estimates.size(); i++){
+          map<string,Ptr<GraphData> >::iterator graph = graphs.find(estimates[i].graphFile);
+          if (graph == graphs.end()){
+               graph = graphs.insert(make_pair(estimates[i].graphFile,GraphData::load(estimates[i].graphFile))).first;
+          }
+          if (graph->second != 0){
+               topologies[i] = &graph->second->getTopology();
+          }
+     }
+
+     pending = &estimates;
+     WorkerPool pool(threads);
+     pool.run((uint32_t) estimates.size(),MakeCallback(&IdlenessEstimator::estimatePending,this));
+     pending = NULL;
+     topologies.clear();
+}
+
+void IdlenessEstimator::estimatePending(uint32_t i){
+     IdlenessEstimate& estimated = (*pending)[i];
+     if (topologies[i] == NULL){
+          estimated.averageIdleness = -1;
+          estimated.worstIdleness = -1;
+          estimated.iterations = 0;
+          estimated.time = 0;
+          return;
+     }
+     estimate(*topologies[i],estimated);
+}
+
+void IdlenessEstimator::estimate(const GraphTopology& topology,IdlenessEstimate& estimate) const{
+     timespec start;
+     clock_gettime(CLOCK_MONOTONIC,&start);
+     estimate.averageIdleness = -1;
+     estimate.worstIdleness = -1;
+     estimate.iterations = 0;
+     estimate.time = 0;
+
+     SelectionPolicy policy = getSelectionPolicy(estimate.strategy);
+     uint32_t edgeCount = topology.getEdgeCount();
+     if ((policy != RANDOM_SELECTION && policy != LEAST_VISITED_SELECTION) || edgeCount == 0){
+          return;
+     }
+
+     // how often each edge is flown, per step
+     vector<double> edges(edgeCount,0);
+     if (policy == LEAST_VISITED_SELECTION){
+          uint32_t streets = 0;
+          for(uint32_t e=0; e < edgeCount; e++){
+               uint32_t reverse = topology.getReverseEdge(e);
+               streets += reverse == GraphTopology::NONE || reverse > e ? 1 : 0;
+          }
+          for(uint32_t e=0; e < edgeCount; e++){
+               edges[e] = 1.0 / streets / (topology.getReverseEdge(e) == GraphTopology::NONE ? 1 : 2);
+          }
+     }
+     else {
+          vector<double> nodes;
+          estimate.iterations = findStationary(topology,topology.getBase(),nodes);
+          for(uint32_t e=0; e < edgeCount; e++){
+               uint32_t from = topology.getEdgeSource(e);
+               edges[e] = nodes[from] / topology.getDegree(from);
+          }
+     }
+
+     double flown = 0;
+     double stepTime = 0;
+     for(uint32_t e=0; e < edgeCount; e++){
+          uint32_t from = topology.getEdgeSource(e);
+          uint32_t to = topology.getEdgeTarget(e);
+          double dx = topology.getX(to) - topology.getX(from);
+          double dy = topology.getY(to) - topology.getY(from);
+          flown += edges[e];
+          stepTime += edges[e] * (sqrt(dx*dx + dy*dy) / speed + pause);
+     }
+
+     // a walk that ends at a node without edges stops patrolling
+     if (flown < 1 - 1e-6){
+          estimate.averageIdleness = duration;
+          estimate.worstIdleness = duration;
+     }
+     else {
+          double visited = 0;
+          double rates = 0;
+          double slowest = -1;
+          for(uint32_t e=0; e < edgeCount; e++){
+               uint32_t reverse = topology.getReverseEdge(e);
+               double rate = (edges[e] + (reverse != GraphTopology::NONE ? edges[reverse] : 0)) / stepTime;
+               if (rate > 0){
+                    visited++;
+                    rates += rate;
+               }
+               if (slowest < 0 || rate < slowest){
+                    slowest = rate;
+               }
+          }
+
+          estimate.averageIdleness = visited / rates;
+          if (slowest <= 0){
+               estimate.worstIdleness = duration;
+          }
+          else if (policy == LEAST_VISITED_SELECTION){
+               estimate.worstIdleness = leastVisitedRounds / slowest;
+          }
+          else if (edgeCount <= HITTING_LIMIT){
+               estimate.worstIdleness = getWorstExcursion(topology,edges,stepTime);
+          }
+          else {
+               double n = duration * slowest;
+               estimate.worstIdleness = ((n > 1 ? log(n) : 0) + EULER_GAMMA) / slowest;
+          }
+          // nothing is idle for longer than the patrol
+          if (estimate.averageIdleness > duration){
+               estimate.averageIdleness = duration;
+          }
+          if (estimate.worstIdleness > duration){
+               estimate.worstIdleness = duration;
+          }
+     }
+
+     timespec end;
+     clock_gettime(CLOCK_MONOTONIC,&end);
+     estimate.time = (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+/*
+ * Power iteration of the lazy walk, which stays put half of the time: it
+ * has the stationary distribution of the walk but converges even when the
+ * walk is periodic. It starts from the nodes reachable from start weighted
+ * by degree, which is already stationary when every edge has a reverse,
+ * and converges to the part of the graph the walk from start ends up in.
+ * Returns the number of iterations.
+ */
+uint32_t IdlenessEstimator::findStationary(const GraphTopology& topology,uint32_t start,vector<double>& nodes) const{
+     uint32_t nodeCount = topology.getNodeCount();
+     nodes.assign(nodeCount,0);
+     start = start < nodeCount ? start : 0;
+
+     vector<bool> reached(nodeCount,false);
+     vector<uint32_t> frontier(1,start);
+     reached[start] = true;
+     double total = 0;
+     while (!frontier.empty()){
+          uint32_t n = frontier.back();
+          frontier.pop_back();
+          nodes[n] = topology.getDegree(n);
+          total += nodes[n];
+          uint32_t last = topology.getLastEdge(n);
+          for(uint32_t e = topology.getFirstEdge(n); e < last; e++){
+               uint32_t to = topology.getEdgeTarget(e);
+               if (!reached[to]){
+                    reached[to] = true;
+                    frontier.push_back(to);
+               }
+          }
+     }
+     if (total == 0){
+          nodes[start] = 1;
+          return 0;
+     }
+     for(uint32_t n=0; n < nodeCount; n++){
+          nodes[n] /= total;
+     }
+     vector<double> next(nodeCount);
+
+     for(uint32_t iteration = 1; iteration <= maxIterations; iteration++){
+          for(uint32_t n=0; n < nodeCount; n++){
+               next[n] = 0.5 * nodes[n];
+          }
+          for(uint32_t n=0; n < nodeCount; n++){
+               uint32_t degree = topology.getDegree(n);
+               if (degree == 0){
+                    next[n] += 0.5 * nodes[n];
+                    continue;
+               }
+               double share = 0.5 * nodes[n] / degree;
+               uint32_t last = topology.getLastEdge(n);
+               for(uint32_t e = topology.getFirstEdge(n); e < last; e++){
+                    next[topology.getEdgeTarget(e)] += share;
+               }
+          }
+
+          double change = 0;
+          for(uint32_t n=0; n < nodeCount; n++){
+               change += fabs(next[n] - nodes[n]);
+          }
+          nodes.swap(next);
+          if (change < tolerance){
+               return iteration;
+          }
+     }
+     return maxIterations;
+}
+
+/*
+ * The walk seen as a chain on directed edges, edge e followed by any edge
+ * leaving its target, has the stationary distribution edges. Its
+ * fundamental matrix Z = (I - P + 1 edges)^-1 gives the mean hitting times
+ * E_edges[H_j] = Z_jj / edges_j and E_i[H_j] = (Z_jj - Z_ij) / edges_j. A
+ * street is hit when either of its edges is; if the walk hits a first
+ * with probability p,
+ *
+ *   E[H_a] = E[H_street] + (1 - p) E_b[H_a]
+ *   E[H_b] = E[H_street] + p E_a[H_b]
+ *
+ * gives both p and E[H_street]. Every edge must be flown in edges.
+ */
+double IdlenessEstimator::getWorstExcursion(const GraphTopology& topology,const vector<double>& edges,double stepTime) const{
+     uint32_t n = (uint32_t) edges.size();
+     vector<double> m(n * n,0);
+     vector<double> z(n * n,0);
+     for(uint32_t i=0; i < n; i++){
+          uint32_t node = topology.getEdgeTarget(i);
+          uint32_t degree = topology.getDegree(node);
+          uint32_t last = topology.getLastEdge(node);
+          for(uint32_t j = topology.getFirstEdge(node); j < last; j++){
+               m[i*n + j] -= 1.0 / degree;
+          }
+          m[i*n + i] += 1;
+          for(uint32_t j=0; j < n; j++){
+               m[i*n + j] += edges[j];
+          }
+          z[i*n + i] = 1;
+     }
+
+     // Gauss-Jordan elimination with partial pivoting
+     for(uint32_t c=0; c < n; c++){
+          uint32_t pivot = c;
+          for(uint32_t r = c + 1; r < n; r++){
+               if (fabs(m[r*n + c]) > fabs(m[pivot*n + c])){
+                    pivot = r;
+               }
+          }
+          if (m[pivot*n + c] == 0){
+               return duration;
+          }
+          if (pivot != c){
+               for(uint32_t k=0; k < n; k++){
+                    swap(m[pivot*n + k],m[c*n + k]);
+                    swap(z[pivot*n + k],z[c*n + k]);
+               }
+          }
+
+          double d = m[c*n + c];
+          for(uint32_t k=0; k < n; k++){
+               m[c*n + k] /= d;
+               z[c*n + k] /= d;
+          }
+          for(uint32_t r=0; r < n; r++){
+               double f = m[r*n + c];
+               if (r == c || f == 0){
+                    continue;
+               }
+               for(uint32_t k=0; k < n; k++){
+                    m[r*n + k] -= f * m[c*n + k];
+                    z[r*n + k] -= f * z[c*n + k];
+               }
+          }
+     }
+
+     double worst = 0;
+     for(uint32_t a=0; a < n; a++){
+          uint32_t b = topology.getReverseEdge(a);
+          if (b != GraphTopology::NONE && b < a){
+               continue;
+          }
+
+          double hitting = z[a*n + a] / edges[a];
+          if (b != GraphTopology::NONE){
+               double hittingB = z[b*n + b] / edges[b];
+               double fromB = (z[a*n + a] - z[b*n + a]) / edges[a];
+               double fromA = (z[b*n + b] - z[a*n + b]) / edges[b];
+               double p = (hittingB - hitting + fromB) / (fromA + fromB);
+               hitting -= (1 - p) * fromB;
+          }
+
+          double excursion = hitting > 0 ? hitting * stepTime : 0;
+          double excursions = excursion > 0 ? duration / excursion : 0;
+          double longest = excursion * ((excursions > 1 ? log(excursions) : 0) + EULER_GAMMA);
+          if (longest > worst){
+               worst = longest;
+          }
+     }
+     return worst;
+}
+
+}
@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#ifndef IDLENESSESTIMATOR_H_
+#define IDLENESSESTIMATOR_H_
+
+#include "GraphTopology.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace ns3{
+
+/**
+ * \brief Idleness of one patrol predicted without walking it.
+ */
+struct IdlenessEstimate {
+     string graphFile;
+     string strategy;         // "random" or "leastvisited"
+     double averageIdleness;  // seconds, as in Graph::stats(), negative if not estimated
+     double worstIdleness;    // seconds
+     uint32_t iterations;     // of the power iteration
+     double time;             // milliseconds spent on the estimate
+};
+
+/**
+ * \ingroup mobility
+ * \brief Predicts the idleness of random and least visited patrols.
+ *
+ * A random walk is a Markov chain on the nodes whose transition matrix is
+ * the adjacency of the graph, each row divided by the node's degree. Its
+ * stationary distribution, found by power iteration over the part of the
+ * graph reachable from the root, gives how often each edge is flown.
+ * Together with the time of each step it gives the rate at which each
+ * street is visited; Graph marks an edge and its reverse together. The
+ * average idleness of Graph::stats() follows from those rates.
+ *
+ * The worst idleness of a random walk comes from its long excursions. A
+ * street's excursions last about its mean hitting time from the
+ * stationary distribution, computed from the fundamental matrix of the
+ * chain on directed edges. The largest of the excursions in the patrol
+ * is then expected to last that time times the log of their number. The
+ * fundamental matrix is dense, so graphs with more than HITTING_LIMIT
+ * edges use the street's mean gap between visits instead, which
+ * underestimates.
+ *
+ * A least visited patrol is not a Markov chain, but it keeps the visit
+ * counts of all streets level, so every street is visited once per round
+ * of all streets. Its worst idleness is taken as a number of rounds,
+ * setLeastVisitedRounds(), by default the ratio of 4.5 measured on the lfs
+ * partition of Cologne.
+ *
+ * estimate() works through a list of graphs on a pool of threads, one
+ * graph at a time per thread: the graphs of a partition are small, and
+ * one power iteration step over one of them costs less than handing it
+ * between threads. Each distinct file is loaded once on the calling
+ * thread, as PatrolEvaluator does, and the threads only read topologies.
+ */
+class IdlenessEstimator {
+private:
+     double speed;    // m/s
+     double pause;    // seconds
+     double duration; // seconds
+     uint32_t threads;
+     double tolerance;
+     uint32_t maxIterations;
+     double leastVisitedRounds;
+
+     // list shared by the threads
+     vector<IdlenessEstimate>* pending;
+     vector<const GraphTopology*> topologies; // by estimate, NULL if its graph did not load
+
+     void estimatePending(uint32_t i);
+
+public:
+     static const uint32_t HITTING_LIMIT = 1024;
+
+     IdlenessEstimator(double speed,double pause,double duration);
+     void setThreads(uint32_t n);
+     void setTolerance(double tolerance);
+     void setLeastVisitedRounds(double rounds);
+     void estimate(vector<IdlenessEstimate>& estimates);
+     void estimate(const GraphTopology& topology,IdlenessEstimate& estimate) const;
+     uint32_t findStationary(const GraphTopology& topology,uint32_t start,vector<double>& nodes) const;
+     double getWorstExcursion(const GraphTopology& topology,const vector<double>& edges,double stepTime) const;
+};
+
+}
+
+#endif /* IDLENESSESTIMATOR_H_ */
@@ -0,0 +1,99 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#include "PatrolEvaluator.h"
+#include "WorkerPool.h"
+#include <cmath>
+#include <unistd.h>
+
+using namespace std;
+
+namespace ns3{
+
+PatrolEvaluator::PatrolEvaluator(double speed,double pause,double duration){
+     this->speed = speed;
+     this->pause = pause;
+     this->duration = duration;
+
+     long cores = sysconf(_SC_NPROCESSORS_ONLN);
+     threads = cores > 0 ? (uint32_t) cores : 1;
+}
+
+void PatrolEvaluator::setThreads(uint32_t n){
+     threads = n > 0 ? n : 1;
+}
+
+/*
+ * Arrival times accumulate exactly as the events of GraphMobilityModel:
+ * the first leg (base to root) has no length, every arrival is followed
+ * by a pause, and arrivals after the end of the patrol are not counted.
+ */
+void PatrolEvaluator::patrol(Graph& graph,double speed,double pause,double duration){
+     const GraphTopology& topology = graph.getTopology();
+     uint32_t current = graph.getRoot().getIndex();
+     if (current >= topology.getNodeCount() || topology.getDegree(current) == 0){
+          return;
+     }
+
+     double time = pause;
+     while (true){
+          uint32_t next = graph.next(current);
+
+          double dx = topology.getX(next) - topology.getX(current);
+          double dy = topology.getY(next) - topology.getY(current);
+          time += sqrt(dx*dx + dy*dy) / speed;
+          if (time > duration){
+               return;
+          }
+
+          graph.markEdge(current,next,time);
+          current = next;
+          time += pause;
+     }
+}
+
+void PatrolEvaluator::evaluate(vector<PatrolRun>& runs){
+     WorkerPool pool(threads);
+     uint32_t batch = threads * 4;
+     for(uint32_t first = 0; first < runs.size(); first += batch){
+          uint32_t last = first + batch < runs.size() ? first + batch : (uint32_t) runs.size();
+
+          graphs.clear();
+          for(uint32_t i = first; i < last; i++){
+               Graph* graph = new Graph(runs[i].strategy);
+               graph->load((char*) runs[i].graphFile.c_str());
+               graph->assignStreams(runs[i].stream);
+               graphs.push_back(graph);
+          }
+          pool.run((uint32_t) graphs.size(),MakeCallback(&PatrolEvaluator::patrolGraph,this));
+
+          for(uint32_t i = first; i < last; i++){
+               Graph* graph = graphs[i - first];
+               runs[i].result = graph->getTopology().getNodeCount() > 0 ? graph->stats() : "";
+               delete graph;
+          }
+     }
+     graphs.clear();
+}
+
+void PatrolEvaluator::patrolGraph(uint32_t i){
+     patrol(*graphs[i],speed,pause,duration);
+}
+
+}
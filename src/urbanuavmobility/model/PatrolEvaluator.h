@@ -0,0 +1,77 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#ifndef PATROLEVALUATOR_H_
+#define PATROLEVALUATOR_H_
+
+#include "Graph.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace ns3{
+
+/**
+ * \brief One patrol to evaluate: a graph, a strategy and a random stream.
+ */
+struct PatrolRun {
+     string graphFile;
+     string strategy;  // a name of getSelectionPolicy()
+     int64_t stream;
+     string result;    // Graph::stats() of the patrol, empty if the graph did not load
+};
+
+/**
+ * \ingroup mobility
+ * \brief Evaluates patrols without the simulator.
+ *
+ * A patrol follows the timeline of GraphMobilityModel: the UAV starts at
+ * the root, flies each edge at constant speed, marks it on arrival and
+ * pauses before choosing the next node. Since nothing else happens between
+ * arrivals the patrol is a plain loop over arrival times, and gives the
+ * same Graph::stats() as the simulated model without energy, altitude or
+ * communication.
+ *
+ * evaluate() runs a list of patrols on a pool of threads. Graphs are
+ * created and released on the calling thread, in batches, so the threads
+ * only step their own Graph and share nothing but the read-only GraphData.
+ */
+class PatrolEvaluator {
+private:
+     double speed;    // m/s
+     double pause;    // seconds
+     double duration; // seconds
+     uint32_t threads;
+
+     vector<Graph*> graphs; // batch patrolled by the threads
+
+     void patrolGraph(uint32_t i);
+
+public:
+     PatrolEvaluator(double speed,double pause,double duration);
+     void setThreads(uint32_t n);
+     void evaluate(vector<PatrolRun>& runs);
+     static void patrol(Graph& graph,double speed,double pause,double duration);
+};
+
+}
+
+#endif /* PATROLEVALUATOR_H_ */
@@ -0,0 +1,441 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#include "PatrolTour.h"
+#include "Router.h"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <fstream>
+
+using namespace std;
+
+namespace ns3{
+
+PatrolTour::PatrolTour(){
+     length = 0;
+     search = 0;
+}
+
+void PatrolTour::clear(){
+     nodes.clear();
+     positions.clear();
+     length = 0;
+}
+
+void PatrolTour::plan(const GraphTopology& topology,uint32_t start){
+     clear();
+     uint32_t nodeCount = topology.getNodeCount();
+     if (start >= nodeCount){
+          return;
+     }
+     buildStreets(topology);
+
+     // streets connected to start and their odd degree nodes
+     vector<bool> connected(nodeCount,false);
+     vector<uint32_t> component(1,start);
+     connected[start] = true;
+     for(uint32_t i=0; i < component.size(); i++){
+          uint32_t node = component[i];
+          for(uint32_t a = adjacencyOffsets[node]; a < adjacencyOffsets[node+1]; a++){
+               uint32_t street = adjacencyStreets[a];
+               uint32_t next = streetFrom[street] == node ? streetTo[street] : streetFrom[street];
+               if (!connected[next]){
+                    connected[next] = true;
+                    component.push_back(next);
+               }
+          }
+     }
+
+     vector<uint32_t> odd;
+     for(uint32_t i=0; i < component.size(); i++){
+          uint32_t node = component[i];
+          if ((adjacencyOffsets[node+1] - adjacencyOffsets[node]) % 2 == 1){
+               odd.push_back(node);
+          }
+     }
+
+     // the streets to fly: each connected one, and the paths between the pairs again
+     vector<uint32_t> flown;
+     for(uint32_t s=0; s < streetFrom.size(); s++){
+          if (connected[streetFrom[s]]){
+               flown.push_back(s);
+          }
+     }
+     vector<pair<uint32_t,uint32_t> > pairs;
+     matchOddNodes(odd,pairs);
+     vector<bool> target(nodeCount,false);
+     for(uint32_t i=0; i < pairs.size(); i++){
+          target[pairs[i].second] = true;
+          findDistances(pairs[i].first,&target);
+          target[pairs[i].second] = false;
+          for(uint32_t node = pairs[i].second; node != pairs[i].first; ){
+               uint32_t street = parents[node];
+               flown.push_back(street);
+               node = streetFrom[street] == node ? streetTo[street] : streetFrom[street];
+          }
+     }
+
+     // Euler circuit of the flown streets, from start
+     vector<uint32_t> offsets(nodeCount + 1,0);
+     for(uint32_t i=0; i < flown.size(); i++){
+          offsets[streetFrom[flown[i]] + 1]++;
+          offsets[streetTo[flown[i]] + 1]++;
+     }
+     for(uint32_t n=0; n < nodeCount; n++){
+          offsets[n+1] += offsets[n];
+     }
+     vector<uint32_t> incident(offsets[nodeCount]);
+     vector<uint32_t> filled(offsets.begin(),offsets.end() - 1);
+     for(uint32_t i=0; i < flown.size(); i++){
+          incident[filled[streetFrom[flown[i]]]++] = i;
+          incident[filled[streetTo[flown[i]]]++] = i;
+     }
+
+     vector<bool> used(flown.size(),false);
+     vector<uint32_t> stack(1,start);
+     vector<uint32_t> circuit;
+     while (!stack.empty()){
+          uint32_t node = stack.back();
+          while (offsets[node] < filled[node] && used[incident[offsets[node]]]){
+               offsets[node]++;
+          }
+          if (offsets[node] == filled[node]){
+               circuit.push_back(node);
+               stack.pop_back();
+               continue;
+          }
+
+          uint32_t i = incident[offsets[node]];
+          used[i] = true;
+          length += streetLengths[flown[i]];
+          stack.push_back(streetFrom[flown[i]] == node ? streetTo[flown[i]] : streetFrom[flown[i]]);
+     }
+
+     if (circuit.size() > 1){
+          nodes.assign(circuit.rbegin(),circuit.rend() - 1);
+     }
+     index(nodeCount);
+
+     vector<uint32_t>().swap(streetFrom);
+     vector<uint32_t>().swap(streetTo);
+     vector<double>().swap(streetLengths);
+     vector<uint32_t>().swap(adjacencyOffsets);
+     vector<uint32_t>().swap(adjacencyStreets);
+     vector<double>().swap(distances);
+     vector<uint32_t>().swap(parents);
+     vector<uint32_t>().swap(reached);
+}
+
+/* One open street per edge and its reverse, or per edge when it has none. */
+void PatrolTour::buildStreets(const GraphTopology& topology){
+     uint32_t nodeCount = topology.getNodeCount();
+     streetFrom.clear();
+     streetTo.clear();
+     streetLengths.clear();
+     for(uint32_t e=0; e < topology.getEdgeCount(); e++){
+          uint32_t reverse = topology.getReverseEdge(e);
+          if ((reverse != GraphTopology::NONE && reverse < e) || !topology.isOpen(e)){
+               continue;
+          }
+
+          uint32_t from = topology.getEdgeSource(e);
+          uint32_t to = topology.getEdgeTarget(e);
+          double dx = topology.getX(to) - topology.getX(from);
+          double dy = topology.getY(to) - topology.getY(from);
+          streetFrom.push_back(from);
+          streetTo.push_back(to);
+          streetLengths.push_back(sqrt(dx*dx + dy*dy));
+     }
+
+     adjacencyOffsets.assign(nodeCount + 1,0);
+     for(uint32_t s=0; s < streetFrom.size(); s++){
+          adjacencyOffsets[streetFrom[s] + 1]++;
+          adjacencyOffsets[streetTo[s] + 1]++;
+     }
+     for(uint32_t n=0; n < nodeCount; n++){
+          adjacencyOffsets[n+1] += adjacencyOffsets[n];
+     }
+     adjacencyStreets.resize(adjacencyOffsets[nodeCount]);
+     vector<uint32_t> filled(adjacencyOffsets.begin(),adjacencyOffsets.end() - 1);
+     for(uint32_t s=0; s < streetFrom.size(); s++){
+          adjacencyStreets[filled[streetFrom[s]]++] = s;
+          adjacencyStreets[filled[streetTo[s]]++] = s;
+     }
+
+     distances.assign(nodeCount,0);
+     parents.assign(nodeCount,GraphTopology::NONE);
+     reached.assign(nodeCount,0);
+     search = 0;
+}
+
+/*
+ * Dijkstra over the streets from from, to every node it reaches, or up to
+ * the first node of targets other than from when targets is given, which
+ * is returned. Returns NONE if no node of targets is reached.
+ */
+uint32_t PatrolTour::findDistances(uint32_t from,const vector<bool>* targets){
+     if (++search == 0){
+          reached.assign(reached.size(),0);
+          search = 1;
+     }
+
+     vector<pair<double,uint32_t> > frontier;
+     distances[from] = 0;
+     parents[from] = GraphTopology::NONE;
+     reached[from] = search;
+     frontier.push_back(make_pair(0.0,from));
+
+     while (!frontier.empty()){
+          pop_heap(frontier.begin(),frontier.end(),greater<pair<double,uint32_t> >());
+          double d = frontier.back().first;
+          uint32_t node = frontier.back().second;
+          frontier.pop_back();
+          if (d > distances[node]){
+               continue;
+          }
+          if (targets != NULL && node != from && (*targets)[node]){
+               return node;
+          }
+
+          for(uint32_t a = adjacencyOffsets[node]; a < adjacencyOffsets[node+1]; a++){
+               uint32_t street = adjacencyStreets[a];
+               uint32_t next = streetFrom[street] == node ? streetTo[street] : streetFrom[street];
+               double nextDistance = d + streetLengths[street];
+               if (reached[next] != search || nextDistance < distances[next]){
+                    reached[next] = search;
+                    distances[next] = nextDistance;
+                    parents[next] = street;
+                    frontier.push_back(make_pair(nextDistance,next));
+                    push_heap(frontier.begin(),frontier.end(),greater<pair<double,uint32_t> >());
+               }
+          }
+     }
+     return GraphTopology::NONE;
+}
+
+/*
+ * Pairs up the odd degree nodes of one component, of which there is an
+ * even number.
+ */
+void PatrolTour::matchOddNodes(const vector<uint32_t>& odd,vector<pair<uint32_t,uint32_t> >& pairs){
+     uint32_t k = (uint32_t) odd.size();
+     pairs.clear();
+
+     if (k > MATCHING_LIMIT){
+          vector<bool> unpaired(distances.size(),false);
+          for(uint32_t i=0; i < k; i++){
+               unpaired[odd[i]] = true;
+          }
+          for(uint32_t i=0; i < k; i++){
+               if (!unpaired[odd[i]]){
+                    continue;
+               }
+               unpaired[odd[i]] = false;
+               uint32_t nearest = findDistances(odd[i],&unpaired);
+               unpaired[nearest] = false;
+               pairs.push_back(make_pair(odd[i],nearest));
+          }
+          return;
+     }
+
+     vector<double> matrix(k * k);
+     vector<pair<double,pair<uint32_t,uint32_t> > > candidates;
+     for(uint32_t i=0; i < k; i++){
+          findDistances(odd[i],NULL);
+          for(uint32_t j=0; j < k; j++){
+               matrix[i*k + j] = distances[odd[j]];
+               if (j > i){
+                    candidates.push_back(make_pair(distances[odd[j]],make_pair(i,j)));
+               }
+          }
+     }
+     sort(candidates.begin(),candidates.end());
+
+     vector<pair<uint32_t,uint32_t> > matched;
+     vector<bool> paired(k,false);
+     for(uint32_t c=0; c < candidates.size(); c++){
+          uint32_t i = candidates[c].second.first;
+          uint32_t j = candidates[c].second.second;
+          if (!paired[i] && !paired[j]){
+               paired[i] = true;
+               paired[j] = true;
+               matched.push_back(make_pair(i,j));
+          }
+     }
+
+     bool improved = true;
+     while (improved){
+          improved = false;
+          for(uint32_t p=0; p < matched.size(); p++){
+               for(uint32_t q = p + 1; q < matched.size(); q++){
+                    uint32_t a = matched[p].first, b = matched[p].second;
+                    uint32_t c = matched[q].first, d = matched[q].second;
+                    double current = matrix[a*k + b] + matrix[c*k + d];
+                    double crossed = matrix[a*k + c] + matrix[b*k + d];
+                    double swapped = matrix[a*k + d] + matrix[b*k + c];
+                    if (crossed < current - 1e-9 && crossed <= swapped){
+                         matched[p] = make_pair(a,c);
+                         matched[q] = make_pair(b,d);
+                         improved = true;
+                    }
+                    else if (swapped < current - 1e-9){
+                         matched[p] = make_pair(a,d);
+                         matched[q] = make_pair(b,c);
+                         improved = true;
+                    }
+               }
+          }
+     }
+
+     for(uint32_t p=0; p < matched.size(); p++){
+          pairs.push_back(make_pair(odd[matched[p].first],odd[matched[p].second]));
+     }
+}
+
+static double getDistance(const GraphTopology& topology,uint32_t from,uint32_t to){
+     double dx = topology.getX(to) - topology.getX(from);
+     double dy = topology.getY(to) - topology.getY(from);
+     return sqrt(dx*dx + dy*dy);
+}
+
+/*
+ * Replaces every step of the tour between a and b, either way, by the
+ * shortest open path between them. Returns false, leaving the tour as it
+ * was, when one of them has no such path.
+ */
+bool PatrolTour::closeStreet(const GraphTopology& topology,uint32_t a,uint32_t b){
+     Router router;
+     vector<uint32_t> patched;
+     vector<uint32_t> path;
+     double patchedLength = length;
+     for(uint32_t i=0; i < nodes.size(); i++){
+          uint32_t from = nodes[i];
+          uint32_t to = nodes[(i + 1) % nodes.size()];
+          patched.push_back(from);
+          if (!((from == a && to == b) || (from == b && to == a))){
+               continue;
+          }
+
+          path.clear();
+          double detour = router.route(topology,from,to,path);
+          if (path.empty()){
+               return false;
+          }
+          patched.insert(patched.end(),path.begin() + 1,path.end() - 1);
+          patchedLength += detour - getDistance(topology,from,to);
+     }
+
+     nodes.swap(patched);
+     length = patchedLength;
+     index(topology.getNodeCount());
+     return true;
+}
+
+/*
+ * Flies the street between a and b there and back from the first place
+ * the tour passes a, or else b; a street away from the tour is not added.
+ * Returns false, leaving the tour as it was, when the street joins the
+ * tour to open streets it does not cover, which need a new plan.
+ */
+bool PatrolTour::openStreet(const GraphTopology& topology,uint32_t a,uint32_t b){
+     uint32_t position = getPosition(a);
+     if (position == GraphTopology::NONE){
+          position = getPosition(b);
+          swap(a,b);
+     }
+     if (position == GraphTopology::NONE){
+          return true;
+     }
+     // b is off the tour, so any other open street of b is not toured
+     if (getPosition(b) == GraphTopology::NONE && topology.getOpenDegree(b) > 1){
+          return false;
+     }
+
+     uint32_t detour[2] = {b,a};
+     nodes.insert(nodes.begin() + position + 1,detour,detour + 2);
+     length += 2 * getDistance(topology,a,b);
+     index(topology.getNodeCount());
+     return true;
+}
+
+void PatrolTour::index(uint32_t nodeCount){
+     positions.assign(nodeCount,GraphTopology::NONE);
+     for(uint32_t i = (uint32_t) nodes.size(); i > 0; i--){
+          positions[nodes[i-1]] = i - 1;
+     }
+}
+
+/*
+ * Fails, leaving the tour empty, if the file cannot be read or does not
+ * fit the topology: an unknown node or two consecutive nodes not joined
+ * by a street.
+ */
+bool PatrolTour::load(const string& file,const GraphTopology& topology){
+     clear();
+     ifstream in(file.c_str());
+     if (!in){
+          return false;
+     }
+
+     string id;
+     while (getline(in,id)){
+          if (id.empty()){
+               continue;
+          }
+          uint32_t node = topology.find(id);
+          if (node == GraphTopology::NONE){
+               clear();
+               return false;
+          }
+          nodes.push_back(node);
+     }
+
+     for(uint32_t i=0; i < nodes.size(); i++){
+          uint32_t from = nodes[i];
+          uint32_t to = nodes[(i + 1) % nodes.size()];
+          if (topology.findEdge(from,to) == GraphTopology::NONE && topology.findEdge(to,from) == GraphTopology::NONE){
+               clear();
+               return false;
+          }
+          double dx = topology.getX(to) - topology.getX(from);
+          double dy = topology.getY(to) - topology.getY(from);
+          length += sqrt(dx*dx + dy*dy);
+     }
+     index(topology.getNodeCount());
+     return !nodes.empty();
+}
+
+bool PatrolTour::save(const string& file,const GraphTopology& topology) const{
+     ofstream out(file.c_str());
+     if (!out){
+          return false;
+     }
+     for(uint32_t i=0; i < nodes.size(); i++){
+          out << topology.getId(nodes[i]) << "\n";
+     }
+     return (bool) out;
+}
+
+size_t PatrolTour::getBytes() const{
+     return (nodes.capacity() + positions.capacity()) * sizeof(uint32_t);
+}
+
+}
@@ -0,0 +1,101 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#ifndef PATROLTOUR_H_
+#define PATROLTOUR_H_
+
+#include "GraphTopology.h"
+#include <stdint.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <utility>
+
+using namespace std;
+
+namespace ns3{
+
+/**
+ * \brief Closed walk covering every street of a graph.
+ *
+ * A street is an edge together with its reverse; Graph marks both when
+ * either is flown, so a tour needs to fly each street once, in either
+ * direction. plan() solves the Chinese postman problem on the streets:
+ * - the odd degree nodes are paired up, and the shortest path between
+ *   each pair is flown a second time, so every node has even degree;
+ * - the tour is then an Euler circuit of the streets and those paths.
+ * The pairs are first matched greedily, shortest first, then improved by
+ * exchanging partners between two pairs while that shortens the total.
+ * Graphs with more than MATCHING_LIMIT odd nodes skip the exchanges and
+ * pair each node with its nearest unpaired one.
+ *
+ * Only the open streets connected to the start node are toured. When a
+ * street closes, closeStreet() flies around it by the shortest open path
+ * wherever the tour crosses it; when one opens, openStreet() flies it
+ * there and back from the first place the tour passes one of its ends.
+ * Both keep the tour a closed walk without planning it again, and return
+ * false when that is not possible: a closed street with no way around, or
+ * an opened one reaching streets the tour never covered.
+ *
+ * The tour can be saved to and loaded from a text file of node ids, one
+ * per line.
+ */
+class PatrolTour {
+private:
+     vector<uint32_t> nodes;     // the tour, back to nodes[0] after the last one
+     vector<uint32_t> positions; // indexed by node handle, first place in nodes, NONE when not on the tour
+     double length;              // meters
+
+     // streets of the graph being planned, released at the end of plan()
+     vector<uint32_t> streetFrom;
+     vector<uint32_t> streetTo;
+     vector<double> streetLengths;
+     vector<uint32_t> adjacencyOffsets; // streets of each node, in the form of GraphTopology
+     vector<uint32_t> adjacencyStreets;
+     vector<double> distances;
+     vector<uint32_t> parents;          // street the search reached the node by
+     vector<uint32_t> reached;
+     uint32_t search;
+
+     void buildStreets(const GraphTopology& topology);
+     uint32_t findDistances(uint32_t from,const vector<bool>* targets);
+     void matchOddNodes(const vector<uint32_t>& odd,vector<pair<uint32_t,uint32_t> >& pairs);
+     void index(uint32_t nodeCount);
+
+public:
+     static const uint32_t MATCHING_LIMIT = 1024;
+
+     PatrolTour();
+     void plan(const GraphTopology& topology,uint32_t start);
+     bool closeStreet(const GraphTopology& topology,uint32_t a,uint32_t b);
+     bool openStreet(const GraphTopology& topology,uint32_t a,uint32_t b);
+     bool load(const string& file,const GraphTopology& topology);
+     bool save(const string& file,const GraphTopology& topology) const;
+     void clear();
+
+     uint32_t getSize() const { return (uint32_t) nodes.size(); }
+     uint32_t getNode(uint32_t position) const { return nodes[position]; }
+     uint32_t getPosition(uint32_t node) const { return node < positions.size() ? positions[node] : GraphTopology::NONE; }
+     double getLength() const { return length; }
+     size_t getBytes() const;
+};
+
+}
+
+#endif /* PATROLTOUR_H_ */
@@ -0,0 +1,262 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#include "Router.h"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <functional>
+
+using namespace std;
+
+namespace ns3{
+
+Router::Router(){
+     search = 0;
+     settled = 0;
+}
+
+/* Sizes the search state for the graph and starts a new search. */
+void Router::prepare(uint32_t nodeCount){
+     if (reached.size() != nodeCount){
+          distances.assign(nodeCount,0);
+          parents.assign(nodeCount,GraphTopology::NONE);
+          middles.assign(nodeCount,GraphTopology::NONE);
+          reached.assign(nodeCount,0);
+          backDistances.assign(nodeCount,0);
+          backParents.assign(nodeCount,GraphTopology::NONE);
+          backMiddles.assign(nodeCount,GraphTopology::NONE);
+          backReached.assign(nodeCount,0);
+          search = 0;
+     }
+     if (++search == 0){
+          reached.assign(nodeCount,0);
+          backReached.assign(nodeCount,0);
+          search = 1;
+     }
+     frontier.clear();
+     backFrontier.clear();
+     settled = 0;
+}
+
+/*
+ * Edges are as long as the straight line between their ends, so the
+ * straight line to the target never overestimates and the first time the
+ * target is settled its distance is the shortest.
+ */
+double Router::route(const GraphTopology& topology,uint32_t from,uint32_t to,vector<uint32_t>& path){
+     path.clear();
+     if (from >= topology.getNodeCount() || to >= topology.getNodeCount()){
+          return numeric_limits<double>::infinity();
+     }
+
+     prepare(topology.getNodeCount());
+     double toX = topology.getX(to);
+     double toY = topology.getY(to);
+
+     distances[from] = 0;
+     parents[from] = GraphTopology::NONE;
+     reached[from] = search;
+     frontier.push_back(make_pair(0.0,from));
+
+     while (!frontier.empty()){
+          pop_heap(frontier.begin(),frontier.end(),greater<pair<double,uint32_t> >());
+          uint32_t node = frontier.back().second;
+          double estimate = frontier.back().first;
+          frontier.pop_back();
+          double d = distances[node];
+          double hx = toX - topology.getX(node);
+          double hy = toY - topology.getY(node);
+          if (estimate > d + sqrt(hx*hx + hy*hy)){
+               continue;
+          }
+
+          settled++;
+          if (node == to){
+               for(uint32_t n = to; n != GraphTopology::NONE; n = parents[n]){
+                    path.push_back(n);
+               }
+               reverse(path.begin(),path.end());
+               return d;
+          }
+
+          uint32_t last = topology.getLastEdge(node);
+          for(uint32_t e = topology.getFirstEdge(node); e < last; e++){
+               if (!topology.isOpen(e)){
+                    continue;
+               }
+               uint32_t next = topology.getEdgeTarget(e);
+               double dx = topology.getX(next) - topology.getX(node);
+               double dy = topology.getY(next) - topology.getY(node);
+               double nextDistance = d + sqrt(dx*dx + dy*dy);
+               if (reached[next] != search || nextDistance < distances[next]){
+                    reached[next] = search;
+                    distances[next] = nextDistance;
+                    parents[next] = node;
+                    hx = toX - topology.getX(next);
+                    hy = toY - topology.getY(next);
+                    frontier.push_back(make_pair(nextDistance + sqrt(hx*hx + hy*hy),next));
+                    push_heap(frontier.begin(),frontier.end(),greater<pair<double,uint32_t> >());
+               }
+          }
+     }
+     return numeric_limits<double>::infinity();
+}
+
+/*
+ * The two searches take turns, each only going up in rank, and a side
+ * stops once its smallest distance is no shorter than the best path met
+ * so far.
+ */
+double Router::route(const ContractionHierarchy& hierarchy,uint32_t from,uint32_t to,vector<uint32_t>& path){
+     path.clear();
+     double best = numeric_limits<double>::infinity();
+     if (from >= hierarchy.getNodeCount() || to >= hierarchy.getNodeCount()){
+          return best;
+     }
+
+     prepare(hierarchy.getNodeCount());
+     distances[from] = 0;
+     parents[from] = GraphTopology::NONE;
+     reached[from] = search;
+     frontier.push_back(make_pair(0.0,from));
+     backDistances[to] = 0;
+     backParents[to] = GraphTopology::NONE;
+     backReached[to] = search;
+     backFrontier.push_back(make_pair(0.0,to));
+
+     uint32_t meeting = GraphTopology::NONE;
+     bool forward = true;
+     while (true){
+          bool forwardDone = frontier.empty() || frontier.front().first >= best;
+          bool backwardDone = backFrontier.empty() || backFrontier.front().first >= best;
+          if (forwardDone && backwardDone){
+               break;
+          }
+          if (forwardDone || backwardDone){
+               forward = backwardDone;
+          }
+
+          if (forward){
+               pop_heap(frontier.begin(),frontier.end(),greater<pair<double,uint32_t> >());
+               double d = frontier.back().first;
+               uint32_t node = frontier.back().second;
+               frontier.pop_back();
+               if (d > distances[node]){
+                    continue;
+               }
+
+               settled++;
+               if (backReached[node] == search && d + backDistances[node] < best){
+                    best = d + backDistances[node];
+                    meeting = node;
+               }
+               for(uint32_t a = hierarchy.getFirstUp(node); a < hierarchy.getLastUp(node); a++){
+                    uint32_t next = hierarchy.getUpNode(a);
+                    double nextDistance = d + hierarchy.getUpWeight(a);
+                    if (reached[next] != search || nextDistance < distances[next]){
+                         reached[next] = search;
+                         distances[next] = nextDistance;
+                         parents[next] = node;
+                         middles[next] = hierarchy.getUpMiddle(a);
+                         frontier.push_back(make_pair(nextDistance,next));
+                         push_heap(frontier.begin(),frontier.end(),greater<pair<double,uint32_t> >());
+                    }
+               }
+          }
+          else {
+               pop_heap(backFrontier.begin(),backFrontier.end(),greater<pair<double,uint32_t> >());
+               double d = backFrontier.back().first;
+               uint32_t node = backFrontier.back().second;
+               backFrontier.pop_back();
+               if (d > backDistances[node]){
+                    continue;
+               }
+
+               settled++;
+               if (reached[node] == search && d + distances[node] < best){
+                    best = d + distances[node];
+                    meeting = node;
+               }
+               for(uint32_t a = hierarchy.getFirstDown(node); a < hierarchy.getLastDown(node); a++){
+                    uint32_t previous = hierarchy.getDownNode(a);
+                    double previousDistance = d + hierarchy.getDownWeight(a);
+                    if (backReached[previous] != search || previousDistance < backDistances[previous]){
+                         backReached[previous] = search;
+                         backDistances[previous] = previousDistance;
+                         backParents[previous] = node;
+                         backMiddles[previous] = hierarchy.getDownMiddle(a);
+                         backFrontier.push_back(make_pair(previousDistance,previous));
+                         push_heap(backFrontier.begin(),backFrontier.end(),greater<pair<double,uint32_t> >());
+                    }
+               }
+          }
+          forward = !forward;
+     }
+
+     if (meeting == GraphTopology::NONE){
+          return best;
+     }
+
+     // the forward half is kept in reverse, then unpacked from the source
+     vector<uint32_t> up;
+     for(uint32_t n = meeting; n != from; n = parents[n]){
+          up.push_back(n);
+     }
+     path.push_back(from);
+     uint32_t node = from;
+     for(int i = (int) up.size() - 1; i >= 0; i--){
+          unpack(hierarchy,node,up[i],middles[up[i]],path);
+          node = up[i];
+     }
+     for(; node != to; node = backParents[node]){
+          unpack(hierarchy,node,backParents[node],backMiddles[node],path);
+     }
+     return best;
+}
+
+/*
+ * Appends the graph nodes of the arc from -> to after from. A shortcut is
+ * made of two arcs through its middle, which ranks below both ends: the
+ * first arc is in the down row of the middle, the second in its up row.
+ */
+void Router::unpack(const ContractionHierarchy& hierarchy,uint32_t from,uint32_t to,uint32_t middle,vector<uint32_t>& path) const{
+     if (middle == GraphTopology::NONE){
+          path.push_back(to);
+          return;
+     }
+
+     uint32_t first = GraphTopology::NONE;
+     for(uint32_t a = hierarchy.getFirstDown(middle); a < hierarchy.getLastDown(middle); a++){
+          if (hierarchy.getDownNode(a) == from){
+               first = hierarchy.getDownMiddle(a);
+          }
+     }
+     uint32_t second = GraphTopology::NONE;
+     for(uint32_t a = hierarchy.getFirstUp(middle); a < hierarchy.getLastUp(middle); a++){
+          if (hierarchy.getUpNode(a) == to){
+               second = hierarchy.getUpMiddle(a);
+          }
+     }
+
+     unpack(hierarchy,from,middle,first,path);
+     unpack(hierarchy,middle,to,second,path);
+}
+
+}
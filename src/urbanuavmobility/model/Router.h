@@ -0,0 +1,77 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#ifndef ROUTER_H_
+#define ROUTER_H_
+
+#include "GraphTopology.h"
+#include "ContractionHierarchy.h"
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+#include <utility>
+
+using namespace std;
+
+namespace ns3{
+
+/**
+ * \brief Point to point shortest paths over a graph.
+ *
+ * route() either runs A* over the topology, guided by the straight line
+ * distance to the target, or searches a ContractionHierarchy of the same
+ * topology upward from both ends and unpacks the shortcuts it took. Both
+ * give the node sequence from the source to the target and its length in
+ * meters, or INFINITY and no nodes when the target cannot be reached.
+ * A* skips closed edges; a hierarchy knows nothing of them.
+ *
+ * A Router only holds the search state, kept between queries so a query
+ * costs no allocation; the hierarchy can be shared by the Routers of
+ * several threads.
+ */
+class Router {
+private:
+     // forward search, also used by A*
+     vector<double> distances;
+     vector<uint32_t> parents;
+     vector<uint32_t> middles;
+     vector<uint32_t> reached;
+     vector<pair<double,uint32_t> > frontier;
+     // backward search of a hierarchy
+     vector<double> backDistances;
+     vector<uint32_t> backParents;
+     vector<uint32_t> backMiddles;
+     vector<uint32_t> backReached;
+     vector<pair<double,uint32_t> > backFrontier;
+     uint32_t search;
+     uint32_t settled;
+
+     void prepare(uint32_t nodeCount);
+     void unpack(const ContractionHierarchy& hierarchy,uint32_t from,uint32_t to,uint32_t middle,vector<uint32_t>& path) const;
+
+public:
+     Router();
+     double route(const GraphTopology& topology,uint32_t from,uint32_t to,vector<uint32_t>& path);
+     double route(const ContractionHierarchy& hierarchy,uint32_t from,uint32_t to,vector<uint32_t>& path);
+     uint32_t getSettled() const { return settled; } // nodes settled by the last query
+};
+
+}
+
+#endif /* ROUTER_H_ */
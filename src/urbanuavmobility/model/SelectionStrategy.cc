@@ -0,0 +1,478 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#include "SelectionStrategy.h"
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <time.h>
+
+using namespace std;
+
+namespace ns3{
+
+GlobalLeastVisitedSelection::GlobalLeastVisitedSelection() {
+     routeNode = GraphTopology::NONE;
+     routeEdge = GraphTopology::NONE;
+     routeKey = 0;
+     search = 0;
+}
+
+/* Starts over on topology with every edge unvisited. */
+void GlobalLeastVisitedSelection::reset(const GraphTopology& topology){
+     queue.build(topology.getEdgeCount(),getKey(EdgeStats()));
+     route.clear();
+     routeNode = GraphTopology::NONE;
+     routeEdge = GraphTopology::NONE;
+
+     distance.assign(topology.getNodeCount(),0);
+     parent.assign(topology.getNodeCount(),GraphTopology::NONE);
+     reached.assign(topology.getNodeCount(),0);
+     search = 0;
+}
+
+void GlobalLeastVisitedSelection::update(uint32_t edge,const EdgeStats& stats){
+     queue.update(edge,getKey(stats));
+}
+
+/* Queues an edge inserted into the topology as unvisited and drops the route. */
+void GlobalLeastVisitedSelection::insert(uint32_t edge){
+     queue.insert(edge,getKey(EdgeStats()));
+     route.clear();
+     routeEdge = GraphTopology::NONE;
+}
+
+uint32_t GlobalLeastVisitedSelection::select(const GraphTopology& topology,const vector<EdgeStats>& stats,UniformRandomVariable& random,uint32_t from){
+     if (route.empty() || routeNode != from || queue.getKey(routeEdge) != routeKey){
+          plan(topology,from);
+     }
+
+     routeNode = route.back();
+     route.pop_back();
+     return routeNode;
+}
+
+size_t GlobalLeastVisitedSelection::getBytes() const{
+     return queue.getBytes() + route.capacity() * sizeof(uint32_t) + distance.capacity() * sizeof(double) +
+          parent.capacity() * sizeof(uint32_t) + reached.capacity() * sizeof(uint32_t) +
+          frontier.capacity() * sizeof(pair<double,uint32_t>);
+}
+
+/*
+ * Dijkstra from from over the open edges, visiting nodes by distance. The
+ * first settled node with an open edge keyed as the top of the queue ends the search; if no such
+ * edge can be reached the smallest key met is taken instead. Distances are
+ * only valid for nodes reached by the current search, so nothing has to be
+ * cleared between plans.
+ */
+void GlobalLeastVisitedSelection::plan(const GraphTopology& topology,uint32_t from){
+     if (++search == 0){
+          reached.assign(reached.size(),0);
+          search = 1;
+     }
+
+     double target = queue.topKey();
+     uint32_t best = GraphTopology::NONE;
+     double bestKey = 0;
+
+     frontier.clear();
+     distance[from] = 0;
+     parent[from] = GraphTopology::NONE;
+     reached[from] = search;
+     frontier.push_back(make_pair(0.0,from));
+
+     while (!frontier.empty()){
+          pop_heap(frontier.begin(),frontier.end(),greater<pair<double,uint32_t> >());
+          double d = frontier.back().first;
+          uint32_t node = frontier.back().second;
+          frontier.pop_back();
+          if (d > distance[node]){
+               continue;
+          }
+
+          uint32_t last = topology.getLastEdge(node);
+          for(uint32_t e = topology.getFirstEdge(node); e < last; e++){
+               if (!topology.isOpen(e)){
+                    continue;
+               }
+               if (best == GraphTopology::NONE || queue.getKey(e) < bestKey){
+                    best = e;
+                    bestKey = queue.getKey(e);
+               }
+          }
+          if (best != GraphTopology::NONE && bestKey <= target){
+               break;
+          }
+
+          for(uint32_t e = topology.getFirstEdge(node); e < last; e++){
+               if (!topology.isOpen(e)){
+                    continue;
+               }
+               uint32_t next = topology.getEdgeTarget(e);
+               double dx = topology.getX(next) - topology.getX(node);
+               double dy = topology.getY(next) - topology.getY(node);
+               double nextDistance = d + sqrt(dx*dx + dy*dy);
+               if (reached[next] != search || nextDistance < distance[next]){
+                    reached[next] = search;
+                    distance[next] = nextDistance;
+                    parent[next] = node;
+                    frontier.push_back(make_pair(nextDistance,next));
+                    push_heap(frontier.begin(),frontier.end(),greater<pair<double,uint32_t> >());
+               }
+          }
+     }
+
+     // from has open edges, so the search always finds one
+     route.clear();
+     route.push_back(topology.getEdgeTarget(best));
+     for(uint32_t node = topology.getEdgeSource(best); node != from; node = parent[node]){
+          route.push_back(node);
+     }
+     routeEdge = best;
+     routeKey = bestKey;
+}
+
+LookaheadSelection::LookaheadSelection() {
+     topology = NULL;
+     depth = 5;
+     latest = 0;
+     updates = 0;
+     decisions = 0;
+     totalLatency = 0;
+     worstLatency = 0;
+}
+
+/* Starts over on topology with every edge unvisited. */
+void LookaheadSelection::reset(const GraphTopology& topology,int depth){
+     this->depth = depth;
+     latest = 0;
+     decisions = 0;
+     totalLatency = 0;
+     worstLatency = 0;
+     this->topology = &topology;
+
+     uint32_t edgeCount = topology.getEdgeCount();
+     scores.assign(edgeCount * depth,0);
+     valid.assign(edgeCount * depth,false);
+     marked.assign(edgeCount,0);
+     updates = 0;
+     indexIncoming();
+}
+
+/* The incoming edges of every node, in CSR form. */
+void LookaheadSelection::indexIncoming(){
+     uint32_t edgeCount = topology->getEdgeCount();
+     inOffsets.assign(topology->getNodeCount() + 1,0);
+     for(uint32_t e=0; e < edgeCount; e++){
+          inOffsets[topology->getEdgeTarget(e) + 1]++;
+     }
+     for(uint32_t n=0; n < topology->getNodeCount(); n++){
+          inOffsets[n + 1] += inOffsets[n];
+     }
+     inEdges.assign(edgeCount,0);
+     vector<uint32_t> filled(inOffsets.begin(),inOffsets.end() - 1);
+     for(uint32_t e=0; e < edgeCount; e++){
+          inEdges[filled[topology->getEdgeTarget(e)]++] = e;
+     }
+}
+
+void LookaheadSelection::update(uint32_t edge,const EdgeStats& stats){
+     if (stats.lastVisit > latest){
+          latest = stats.lastVisit;
+     }
+     drop(edge);
+}
+
+/*
+ * Follows the edges inserted into the topology, given by their handles in
+ * it in ascending order, so each lands where the ones before it moved the
+ * rest. The scores of the other edges move with them.
+ */
+void LookaheadSelection::insert(const vector<uint32_t>& edges){
+     for(uint32_t i=0; i < edges.size(); i++){
+          scores.insert(scores.begin() + edges[i] * depth,depth,0);
+          valid.insert(valid.begin() + edges[i] * depth,depth,false);
+          marked.insert(marked.begin() + edges[i],0);
+     }
+     indexIncoming();
+     for(uint32_t i=0; i < edges.size(); i++){
+          drop(edges[i]);
+     }
+}
+
+/*
+ * Drops the scores that depend on edge: level j holds the edges j steps
+ * before it, whose paths reach it from depth j + 1 on. An edge with none
+ * of those scores cached cannot have a predecessor that does, since its
+ * scores were computed with theirs, so the walk stops there; edge itself
+ * is passed, as one just opened or added was left out of them.
+ */
+void LookaheadSelection::drop(uint32_t edge){
+     if (++updates == 0){
+          marked.assign(marked.size(),0);
+          updates = 1;
+     }
+
+     level.clear();
+     level.push_back(edge);
+     marked[edge] = updates;
+     for(int j=0; j < depth && !level.empty(); j++){
+          nextLevel.clear();
+          for(uint32_t i=0; i < level.size(); i++){
+               uint32_t e = level[i];
+               bool cached = false;
+               for(int d = j + 1; d <= depth; d++){
+                    if (valid[e * depth + d - 1]){
+                         valid[e * depth + d - 1] = false;
+                         cached = true;
+                    }
+               }
+               if (!cached && j > 0){
+                    continue;
+               }
+
+               uint32_t source = topology->getEdgeSource(e);
+               for(uint32_t k = inOffsets[source]; k < inOffsets[source + 1]; k++){
+                    if (marked[inEdges[k]] != updates){
+                         marked[inEdges[k]] = updates;
+                         nextLevel.push_back(inEdges[k]);
+                    }
+               }
+          }
+          level.swap(nextLevel);
+     }
+}
+
+uint32_t LookaheadSelection::select(const GraphTopology& topology,const vector<EdgeStats>& stats,UniformRandomVariable& random,uint32_t from){
+     timespec start;
+     clock_gettime(CLOCK_MONOTONIC,&start);
+
+     uint32_t first = topology.getFirstEdge(from);
+     uint32_t last = topology.getLastEdge(from);
+
+     double bestScore = 0;
+     int equalEdges = 0;
+     for (uint32_t e = first; e < last; e++){
+          if (!topology.isOpen(e)){
+               continue;
+          }
+          double s = score(topology,stats,e,depth);
+          if (equalEdges == 0 || s < bestScore){
+               bestScore = s;
+               equalEdges = 1;
+          }
+          else if (s == bestScore){
+               equalEdges++;
+          }
+     }
+
+     int randomNumber = (int) random.GetInteger(0,equalEdges - 1);
+     uint32_t chosen = first;
+     for (uint32_t e = first; ; e++){
+          if (topology.isOpen(e) && scores[e * depth + depth - 1] == bestScore && randomNumber-- == 0){
+               chosen = e;
+               break;
+          }
+     }
+
+     timespec end;
+     clock_gettime(CLOCK_MONOTONIC,&end);
+     double latency = (end.tv_sec - start.tv_sec) * 1e6 + (end.tv_nsec - start.tv_nsec) / 1e3;
+     decisions++;
+     totalLatency += latency;
+     if (latency > worstLatency){
+          worstLatency = latency;
+     }
+
+     return topology.getEdgeTarget(chosen);
+}
+
+size_t LookaheadSelection::getBytes() const{
+     return scores.capacity() * sizeof(double) + valid.capacity() / 8 + inOffsets.capacity() * sizeof(uint32_t) +
+          inEdges.capacity() * sizeof(uint32_t) + marked.capacity() * sizeof(uint32_t) +
+          (level.capacity() + nextLevel.capacity()) * sizeof(uint32_t);
+}
+
+double LookaheadSelection::score(const GraphTopology& topology,const vector<EdgeStats>& stats,uint32_t edge,int d){
+     uint32_t slot = edge * depth + d - 1;
+     if (valid[slot]){
+          return scores[slot];
+     }
+
+     double s = stats[edge].lastVisit;
+     if (d > 1){
+          uint32_t node = topology.getEdgeTarget(edge);
+          uint32_t back = topology.getReverseEdge(edge);
+          uint32_t first = topology.getFirstEdge(node);
+          uint32_t last = topology.getLastEdge(node);
+
+          bool found = false;
+          bool open = false;
+          double best = 0;
+          for (uint32_t e = first; e < last; e++){
+               if (!topology.isOpen(e)){
+                    continue;
+               }
+               open = true;
+               if (e == back){
+                    continue;
+               }
+               double next = score(topology,stats,e,d - 1);
+               if (!found || next < best){
+                    best = next;
+                    found = true;
+               }
+          }
+
+          if (found){
+               s += best;
+          }
+          else if (open){
+               s += score(topology,stats,back,d - 1);
+          }
+          else {
+               s += (d - 1) * latest;
+          }
+     }
+
+     scores[slot] = s;
+     valid[slot] = true;
+     return s;
+}
+
+TerritorySelection::TerritorySelection() {
+     routeNode = GraphTopology::NONE;
+     search = 0;
+}
+
+void TerritorySelection::reset(const GraphTopology& topology){
+     route.clear();
+     routeNode = GraphTopology::NONE;
+     parent.assign(topology.getNodeCount(),GraphTopology::NONE);
+     reached.assign(topology.getNodeCount(),0);
+     search = 0;
+}
+
+uint32_t TerritorySelection::select(const GraphTopology& topology,const vector<EdgeStats>& stats,UniformRandomVariable& random,uint32_t from,
+                                    const TerritoryMap& territories,uint32_t territory){
+     uint32_t first = topology.getFirstEdge(from);
+     uint32_t last = topology.getLastEdge(from);
+
+     int ownedEdges = 0;
+     double oldestKey = 0;
+     int equalEdges = 0;
+     for (uint32_t e = first; e < last; e++){
+          if (!territories.owns(territory,e) || !topology.isOpen(e)){
+               continue;
+          }
+          double key = GlobalLeastVisitedSelection::getKey(stats[e]);
+          if (ownedEdges++ == 0 || key < oldestKey){
+               oldestKey = key;
+               equalEdges = 1;
+          }
+          else if (key == oldestKey){
+               equalEdges++;
+          }
+     }
+
+     if (ownedEdges > 0){
+          route.clear();
+          int randomNumber = (int) random.GetInteger(0,equalEdges - 1);
+          for (uint32_t e = first; ; e++){
+               if (territories.owns(territory,e) && topology.isOpen(e) &&
+                   GlobalLeastVisitedSelection::getKey(stats[e]) == oldestKey && randomNumber-- == 0){
+                    return topology.getEdgeTarget(e);
+               }
+          }
+     }
+
+     if ((route.empty() || routeNode != from) && !plan(topology,territories,territory,from)){
+          return GraphTopology::NONE;
+     }
+
+     routeNode = route.back();
+     route.pop_back();
+     return routeNode;
+}
+
+/* Finds the way to the nearest node with an owned edge; false if there is none. */
+bool TerritorySelection::plan(const GraphTopology& topology,const TerritoryMap& territories,uint32_t territory,uint32_t from){
+     if (++search == 0){
+          reached.assign(reached.size(),0);
+          search = 1;
+     }
+
+     route.clear();
+     frontier.clear();
+     frontier.push_back(from);
+     reached[from] = search;
+     parent[from] = GraphTopology::NONE;
+
+     for(uint32_t i=0; i < frontier.size(); i++){
+          uint32_t node = frontier[i];
+          uint32_t last = topology.getLastEdge(node);
+          for(uint32_t e = topology.getFirstEdge(node); e < last; e++){
+               if (territories.owns(territory,e) && topology.isOpen(e)){
+                    for(; node != from; node = parent[node]){
+                         route.push_back(node);
+                    }
+                    return !route.empty();
+               }
+          }
+
+          for(uint32_t e = topology.getFirstEdge(node); e < last; e++){
+               uint32_t next = topology.getEdgeTarget(e);
+               if (topology.isOpen(e) && reached[next] != search){
+                    reached[next] = search;
+                    parent[next] = node;
+                    frontier.push_back(next);
+               }
+          }
+     }
+     return false;
+}
+
+TourSelection::TourSelection() {
+     tour = NULL;
+     position = 0;
+}
+
+void TourSelection::reset(const PatrolTour& tour){
+     this->tour = &tour;
+     position = 0;
+}
+
+uint32_t TourSelection::select(uint32_t from){
+     if (tour == NULL || tour->getSize() == 0){
+          return GraphTopology::NONE;
+     }
+
+     if (tour->getNode(position) != from){
+          position = tour->getPosition(from);
+          if (position == GraphTopology::NONE){
+               position = 0;
+               return GraphTopology::NONE;
+          }
+     }
+
+     position = position + 1 < tour->getSize() ? position + 1 : 0;
+     return tour->getNode(position);
+}
+
+}
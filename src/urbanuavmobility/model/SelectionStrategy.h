@@ -0,0 +1,316 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#ifndef SELECTIONSTRATEGY_H_
+#define SELECTIONSTRATEGY_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <utility>
+#include "GraphTopology.h"
+#include "EdgeQueue.h"
+#include "TerritoryMap.h"
+#include "PatrolTour.h"
+#include "ns3/random-variable-stream.h"
+
+using namespace std;
+
+namespace ns3{
+
+/**
+ * \brief Visit statistics of one edge.
+ *
+ * Idleness only depends on the first and last visit and on the largest gap
+ * between visits, so individual visit times are not kept.
+ */
+struct EdgeStats {
+     int count;
+     int visits;
+     double firstVisit;   // seconds
+     double lastVisit;    // seconds
+     double worstIdleness; // seconds
+
+     EdgeStats() : count(0), visits(0), firstVisit(0), lastVisit(0), worstIdleness(0) {}
+};
+
+/*
+ * Selection strategies pick the next node of a walk. They keep no state of
+ * their own: everything they read is passed in, so one strategy serves
+ * every graph and Graph calls them through templates rather than virtual
+ * functions. A strategy is a class with a static
+ *
+ *   uint32_t select(const GraphTopology&,const vector<EdgeStats>&,
+ *                   UniformRandomVariable& random,uint32_t from)
+ *
+ * returning a neighbour of from over an open edge; from always has at
+ * least one. All random choices are drawn from the graph's own stream,
+ * random.
+ *
+ * Strategies that plan beyond the current node need state of their own;
+ * those are objects owned by the Graph, which reports every visit to them.
+ */
+enum SelectionPolicy {
+     RANDOM_SELECTION,
+     LEAST_VISITED_SELECTION,
+     GLOBAL_LEAST_VISITED_SELECTION,
+     LOOKAHEAD_SELECTION,
+     TOUR_SELECTION
+};
+
+/*
+ * Maps the strategy names of the mobility models, "random", "leastvisited",
+ * "globalleastvisited", "lookahead", optionally followed by its depth as
+ * in "lookahead4", and "tour".
+ */
+inline SelectionPolicy getSelectionPolicy(const string& name){
+     if (name.compare("leastvisited") == 0){
+          return LEAST_VISITED_SELECTION;
+     }
+     if (name.compare("globalleastvisited") == 0){
+          return GLOBAL_LEAST_VISITED_SELECTION;
+     }
+     if (name.compare(0,9,"lookahead") == 0){
+          return LOOKAHEAD_SELECTION;
+     }
+     if (name.compare("tour") == 0){
+          return TOUR_SELECTION;
+     }
+     return RANDOM_SELECTION;
+}
+
+/* Depth of a "lookahead<k>" strategy name, 5 when not given. */
+inline int getLookaheadDepth(const string& name){
+     int depth = name.size() > 9 ? atoi(name.c_str() + 9) : 0;
+     if (depth < 1){
+          return 5;
+     }
+     return depth < 8 ? depth : 8;
+}
+
+struct RandomSelection {
+     static uint32_t select(const GraphTopology& topology,const vector<EdgeStats>& stats,UniformRandomVariable& random,uint32_t from){
+          if (topology.getClosedCount() == 0){
+               uint32_t randomNumber = random.GetInteger(0,topology.getDegree(from) - 1);
+               return topology.getNeighbours(from)[randomNumber];
+          }
+
+          uint32_t randomNumber = random.GetInteger(0,topology.getOpenDegree(from) - 1);
+          for (uint32_t e = topology.getFirstEdge(from); ; e++){
+               if (topology.isOpen(e) && randomNumber-- == 0){
+                    return topology.getEdgeTarget(e);
+               }
+          }
+     }
+};
+
+/* Picks uniformly among the edges of from with the lowest visit count. */
+struct LeastVisitedEdgesSelection {
+     static uint32_t select(const GraphTopology& topology,const vector<EdgeStats>& stats,UniformRandomVariable& random,uint32_t from){
+          uint32_t first = topology.getFirstEdge(from);
+          uint32_t last = topology.getLastEdge(from);
+
+          int leastCount = 0;
+          int equalEdges = 0;
+          for (uint32_t e = first; e < last; e++){
+               if (!topology.isOpen(e)){
+                    continue;
+               }
+               if (equalEdges == 0 || stats[e].count < leastCount){
+                    leastCount = stats[e].count;
+                    equalEdges = 1;
+               }
+               else if (stats[e].count == leastCount){
+                    equalEdges++;
+               }
+          }
+
+          int randomNumber = (int) random.GetInteger(0,equalEdges - 1);
+          for (uint32_t e = first; ; e++){
+               if (topology.isOpen(e) && stats[e].count == leastCount && randomNumber-- == 0){
+                    return topology.getEdgeTarget(e);
+               }
+          }
+     }
+};
+
+/**
+ * \brief Heads for the most idle edge of the whole graph.
+ *
+ * Every edge is kept in an EdgeQueue keyed by its last visit, unvisited
+ * edges first, and update() moves an edge in O(log E) when it is marked.
+ * When the UAV needs a new target, a shortest path search from its node
+ * stops at the nearest edge with the smallest key in the queue; the UAV
+ * then follows that route one node per call and crosses the edge. A route
+ * is only planned again when it is finished, when the UAV is not where the
+ * route left it, or when its target edge is visited on the way (by this
+ * UAV or by merged visits of others), so most calls pop one node.
+ */
+class GlobalLeastVisitedSelection {
+private:
+     EdgeQueue queue;
+     vector<uint32_t> route;  // nodes still to visit, next one last
+     uint32_t routeNode;      // node the route continues from
+     uint32_t routeEdge;      // target edge of the route
+     double routeKey;         // key of the target edge when planned
+
+     // search state kept between plans
+     vector<double> distance;
+     vector<uint32_t> parent;
+     vector<uint32_t> reached; // search that last reached the node
+     uint32_t search;
+     vector<pair<double,uint32_t> > frontier;
+
+     void plan(const GraphTopology& topology,uint32_t from);
+
+public:
+     GlobalLeastVisitedSelection();
+     void reset(const GraphTopology& topology);
+     void update(uint32_t edge,const EdgeStats& stats);
+     void insert(uint32_t edge);
+     void clearRoute() { route.clear(); }
+     uint32_t select(const GraphTopology& topology,const vector<EdgeStats>& stats,UniformRandomVariable& random,uint32_t from);
+     size_t getBytes() const;
+     static double getKey(const EdgeStats& stats) { return stats.visits == 0 ? -1 : stats.lastVisit; }
+};
+
+/**
+ * \brief Picks the first edge of the best path of depth edges.
+ *
+ * The idleness gained by crossing an edge at time now is now - lastVisit,
+ * so over paths of the same length the best path is the one with the
+ * smallest sum of last visits (0 for unvisited edges). The score of a path
+ * starting with edge e is kept per (e, depth):
+ *
+ *   score(e,1) = lastVisit(e)
+ *   score(e,d) = lastVisit(e) + min score(f,d-1) over the edges f leaving
+ *                the target of e, except the way back
+ *
+ * A path may only turn back at a dead end; a node with no edge at all ends
+ * the path, and every missing step costs the latest visit time seen.
+ *
+ * Scores are computed on demand and kept between decisions. When an edge
+ * is visited, update() walks back from it along incoming edges and only
+ * drops the scores whose paths can reach it: the edges d steps before it,
+ * for depths above d. Consecutive steps therefore reuse most of the tree
+ * of the previous decision. Closed edges are never part of a path; when
+ * an edge closes or opens, update() drops the scores through it as for a
+ * visit. insert() follows a topology that gained edges: the scores move to
+ * the new handles and only those whose paths can take a new edge are
+ * dropped.
+ *
+ * Every decision is timed; getDecisions(), getAverageLatency() and
+ * getWorstLatency() report the counters.
+ */
+class LookaheadSelection {
+private:
+     const GraphTopology* topology;
+     int depth;
+     double latest;            // latest visit time seen
+     vector<double> scores;    // [edge * depth + d - 1]
+     vector<bool> valid;       // same layout as scores
+
+     // incoming edges, in CSR form
+     vector<uint32_t> inOffsets;
+     vector<uint32_t> inEdges;
+
+     // invalidation state kept between updates
+     vector<uint32_t> marked;  // update that last reached the edge
+     uint32_t updates;
+     vector<uint32_t> level;
+     vector<uint32_t> nextLevel;
+
+     uint64_t decisions;
+     double totalLatency;      // microseconds
+     double worstLatency;      // microseconds
+
+     double score(const GraphTopology& topology,const vector<EdgeStats>& stats,uint32_t edge,int d);
+     void indexIncoming();
+     void drop(uint32_t edge);
+
+public:
+     LookaheadSelection();
+     void reset(const GraphTopology& topology,int depth);
+     void update(uint32_t edge,const EdgeStats& stats);
+     void insert(const vector<uint32_t>& edges);
+     uint32_t select(const GraphTopology& topology,const vector<EdgeStats>& stats,UniformRandomVariable& random,uint32_t from);
+     int getDepth() const { return depth; }
+     double getScore(uint32_t edge) const { return scores[edge * depth + depth - 1]; } // as of the last select() from its source
+     uint64_t getDecisions() const { return decisions; }
+     double getAverageLatency() const { return decisions > 0 ? totalLatency / decisions : 0; }
+     double getWorstLatency() const { return worstLatency; }
+     size_t getBytes() const;
+};
+
+/**
+ * \brief Keeps a walk on the edges its territory owns.
+ *
+ * At a node with owned edges the one visited longest ago is taken, ties
+ * broken at random; counts are not used since borrowed edges carry the
+ * counts of their home. At a node with no owned edge (the UAV is on edges
+ * taken back by their home, or just got its own back) a breadth first
+ * search gives the way to the nearest node with an owned edge, followed
+ * one node per call. select() returns NONE only when no owned edge can
+ * be reached. Closed edges are neither taken nor searched.
+ */
+class TerritorySelection {
+private:
+     vector<uint32_t> route;   // nodes still to visit, next one last
+     uint32_t routeNode;       // node the route continues from
+
+     // search state kept between plans
+     vector<uint32_t> parent;
+     vector<uint32_t> reached; // search that last reached the node
+     uint32_t search;
+     vector<uint32_t> frontier;
+
+     bool plan(const GraphTopology& topology,const TerritoryMap& territories,uint32_t territory,uint32_t from);
+
+public:
+     TerritorySelection();
+     void reset(const GraphTopology& topology);
+     void clearRoute() { route.clear(); }
+     uint32_t select(const GraphTopology& topology,const vector<EdgeStats>& stats,UniformRandomVariable& random,uint32_t from,
+                     const TerritoryMap& territories,uint32_t territory);
+};
+
+/**
+ * \brief Replays the patrol tour of the graph.
+ *
+ * Each call moves one node further along the tour, so a lap flies every
+ * street and a step costs a comparison and an index. A walk that left the
+ * tour (a return to base, another strategy) joins it again at the first
+ * place the tour passes its node; select() returns NONE at a node the tour
+ * does not pass.
+ */
+class TourSelection {
+private:
+     const PatrolTour* tour;
+     uint32_t position;
+
+public:
+     TourSelection();
+     void reset(const PatrolTour& tour);
+     uint32_t select(uint32_t from);
+};
+
+}
+
+#endif /* SELECTIONSTRATEGY_H_ */
@@ -0,0 +1,432 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#include "SpatialIndex.h"
+#include "Util.h"
+#include <cmath>
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+namespace ns3{
+
+
+NodeGrid::NodeGrid() {
+     topology = NULL;
+     minX = 0;
+     minY = 0;
+     cellSize = 1;
+     cols = 0;
+     rows = 0;
+}
+
+void NodeGrid::build(const GraphTopology* t){
+     topology = t;
+     cellOffsets.clear();
+     cellNodes.clear();
+     cols = 0;
+     rows = 0;
+
+     uint32_t n = topology->getNodeCount();
+     if (n == 0){
+          return;
+     }
+
+     minX = topology->getX(0);
+     minY = topology->getY(0);
+     double maxX = minX;
+     double maxY = minY;
+     for(uint32_t i=1; i < n; i++){
+          minX = std::min(minX,topology->getX(i));
+          minY = std::min(minY,topology->getY(i));
+          maxX = std::max(maxX,topology->getX(i));
+          maxY = std::max(maxY,topology->getY(i));
+     }
+
+     double width = std::max(maxX - minX,1.0);
+     double height = std::max(maxY - minY,1.0);
+     cellSize = sqrt(width * height * 2 / n);
+     cols = (int) (width / cellSize) + 1;
+     rows = (int) (height / cellSize) + 1;
+
+     cellOffsets.assign(cols * rows + 1,0);
+     vector<uint32_t> cells(n);
+     for(uint32_t i=0; i < n; i++){
+          cells[i] = getRow(topology->getY(i)) * cols + getCol(topology->getX(i));
+          cellOffsets[cells[i] + 1]++;
+     }
+     for(int c=0; c < cols * rows; c++){
+          cellOffsets[c + 1] += cellOffsets[c];
+     }
+
+     cellNodes.assign(n,0);
+     vector<uint32_t> cursor(cellOffsets.begin(),cellOffsets.end() - 1);
+     for(uint32_t i=0; i < n; i++){
+          cellNodes[cursor[cells[i]]++] = i;
+     }
+}
+
+size_t NodeGrid::getBytes() const{
+     return (cellOffsets.capacity() + cellNodes.capacity()) * sizeof(uint32_t);
+}
+
+bool NodeGrid::isEmpty() const{
+     return cellNodes.empty();
+}
+
+int NodeGrid::getCol(double x) const{
+     int col = (int) floor((x - minX) / cellSize);
+     return std::max(0,std::min(cols - 1,col));
+}
+
+int NodeGrid::getRow(double y) const{
+     int row = (int) floor((y - minY) / cellSize);
+     return std::max(0,std::min(rows - 1,row));
+}
+
+double NodeGrid::distance2(uint32_t node,double x,double y) const{
+     double xd = topology->getX(node) - x;
+     double yd = topology->getY(node) - y;
+     return xd*xd + yd*yd;
+}
+
+uint32_t NodeGrid::nearest(double x,double y) const{
+     if (isEmpty()){
+          return GraphTopology::NONE;
+     }
+
+     int col = getCol(x);
+     int row = getRow(y);
+     int maxRing = std::max(cols,rows);
+
+     uint32_t best = GraphTopology::NONE;
+     double bestDistance = 0;
+
+     for(int r=0; r <= maxRing; r++){
+          for(int j = row - r; j <= row + r; j++){
+               if (j < 0 || j >= rows) continue;
+               // inner rows of the ring only contribute their two end cells
+               int step = (j == row - r || j == row + r) ? 1 : 2 * r;
+               for(int i = col - r; i <= col + r; i += std::max(step,1)){
+                    if (i < 0 || i >= cols) continue;
+                    int cell = j * cols + i;
+                    for(uint32_t k = cellOffsets[cell]; k < cellOffsets[cell + 1]; k++){
+                         double d = distance2(cellNodes[k],x,y);
+                         if (best == GraphTopology::NONE || d < bestDistance ||
+                             (d == bestDistance && cellNodes[k] < best)){
+                              best = cellNodes[k];
+                              bestDistance = d;
+                         }
+                    }
+               }
+          }
+
+          // every node outside the searched rings is at least r cells away
+          double reach = r * cellSize;
+          if (best != GraphTopology::NONE && bestDistance <= reach * reach){
+               break;
+          }
+     }
+
+     return best;
+}
+
+vector<uint32_t> NodeGrid::nearest(double x,double y,int k) const{
+     vector<uint32_t> result;
+     if (isEmpty() || k <= 0){
+          return result;
+     }
+
+     int col = getCol(x);
+     int row = getRow(y);
+     int maxRing = std::max(cols,rows);
+
+     // max-heap of the k closest nodes found so far
+     vector<pair<double,uint32_t> > heap;
+
+     for(int r=0; r <= maxRing; r++){
+          for(int j = row - r; j <= row + r; j++){
+               if (j < 0 || j >= rows) continue;
+               int step = (j == row - r || j == row + r) ? 1 : 2 * r;
+               for(int i = col - r; i <= col + r; i += std::max(step,1)){
+                    if (i < 0 || i >= cols) continue;
+                    int cell = j * cols + i;
+                    for(uint32_t c = cellOffsets[cell]; c < cellOffsets[cell + 1]; c++){
+                         pair<double,uint32_t> candidate(distance2(cellNodes[c],x,y),cellNodes[c]);
+                         if ((int) heap.size() < k){
+                              heap.push_back(candidate);
+                              push_heap(heap.begin(),heap.end());
+                         }
+                         else if (candidate < heap.front()){
+                              pop_heap(heap.begin(),heap.end());
+                              heap.back() = candidate;
+                              push_heap(heap.begin(),heap.end());
+                         }
+                    }
+               }
+          }
+
+          double reach = r * cellSize;
+          if ((int) heap.size() == k && heap.front().first <= reach * reach){
+               break;
+          }
+     }
+
+     sort_heap(heap.begin(),heap.end());
+     for(int i=0; i < (int) heap.size(); i++){
+          result.push_back(heap[i].second);
+     }
+     return result;
+}
+
+vector<uint32_t> NodeGrid::within(double x,double y,double radius) const{
+     vector<uint32_t> result;
+     if (isEmpty() || radius < 0){
+          return result;
+     }
+
+     int col1 = getCol(x - radius);
+     int col2 = getCol(x + radius);
+     int row1 = getRow(y - radius);
+     int row2 = getRow(y + radius);
+     double radius2 = radius * radius;
+
+     for(int j = row1; j <= row2; j++){
+          for(int i = col1; i <= col2; i++){
+               int cell = j * cols + i;
+               for(uint32_t k = cellOffsets[cell]; k < cellOffsets[cell + 1]; k++){
+                    if (distance2(cellNodes[k],x,y) <= radius2){
+                         result.push_back(cellNodes[k]);
+                    }
+               }
+          }
+     }
+
+     sort(result.begin(),result.end());
+     return result;
+}
+
+/* The nodes in the box from (x1,y1) to (x2,y2), borders included. */
+vector<uint32_t> NodeGrid::inside(double x1,double y1,double x2,double y2) const{
+     vector<uint32_t> result;
+     if (isEmpty() || x2 < x1 || y2 < y1){
+          return result;
+     }
+
+     int col1 = getCol(x1);
+     int col2 = getCol(x2);
+     int row1 = getRow(y1);
+     int row2 = getRow(y2);
+
+     for(int j = row1; j <= row2; j++){
+          for(int i = col1; i <= col2; i++){
+               int cell = j * cols + i;
+               for(uint32_t k = cellOffsets[cell]; k < cellOffsets[cell + 1]; k++){
+                    double x = topology->getX(cellNodes[k]);
+                    double y = topology->getY(cellNodes[k]);
+                    if (x >= x1 && x <= x2 && y >= y1 && y <= y2){
+                         result.push_back(cellNodes[k]);
+                    }
+               }
+          }
+     }
+
+     sort(result.begin(),result.end());
+     return result;
+}
+
+EdgeGrid::EdgeGrid() {
+     topology = NULL;
+     minX = 0;
+     minY = 0;
+     cellSize = 1;
+     cols = 0;
+     rows = 0;
+}
+
+void EdgeGrid::build(const GraphTopology* t){
+     topology = t;
+     cellOffsets.clear();
+     cellEdges.clear();
+     cols = 0;
+     rows = 0;
+
+     uint32_t n = topology->getNodeCount();
+     uint32_t m = topology->getEdgeCount();
+     if (n == 0 || m == 0){
+          return;
+     }
+
+     minX = topology->getX(0);
+     minY = topology->getY(0);
+     double maxX = minX;
+     double maxY = minY;
+     for(uint32_t i=1; i < n; i++){
+          minX = std::min(minX,topology->getX(i));
+          minY = std::min(minY,topology->getY(i));
+          maxX = std::max(maxX,topology->getX(i));
+          maxY = std::max(maxY,topology->getY(i));
+     }
+
+     // cells about as large as a typical street, but never more cells than
+     // a few per edge
+     double extent = 0;
+     for(uint32_t e=0; e < m; e++){
+          uint32_t from = topology->getEdgeSource(e);
+          uint32_t to = topology->getEdgeTarget(e);
+          extent += std::max(fabs(topology->getX(from) - topology->getX(to)),
+                             fabs(topology->getY(from) - topology->getY(to)));
+     }
+
+     double width = std::max(maxX - minX,1.0);
+     double height = std::max(maxY - minY,1.0);
+     cellSize = std::max(extent / m,sqrt(width * height / (4.0 * m)));
+     cellSize = std::max(cellSize,1.0);
+     cols = (int) (width / cellSize) + 1;
+     rows = (int) (height / cellSize) + 1;
+
+     cellOffsets.assign(cols * rows + 1,0);
+     int col1,row1,col2,row2;
+     for(int pass=0; pass < 2; pass++){
+          vector<uint32_t> cursor;
+          if (pass == 1){
+               for(int c=0; c < cols * rows; c++){
+                    cellOffsets[c + 1] += cellOffsets[c];
+               }
+               cellEdges.assign(cellOffsets.back(),0);
+               cursor.assign(cellOffsets.begin(),cellOffsets.end() - 1);
+          }
+
+          for(uint32_t e=0; e < m; e++){
+               uint32_t reverse = topology->getReverseEdge(e);
+               if (reverse != GraphTopology::NONE && reverse < e){
+                    continue;
+               }
+
+               getCells(e,col1,row1,col2,row2);
+               for(int j = row1; j <= row2; j++){
+                    for(int i = col1; i <= col2; i++){
+                         if (pass == 0){
+                              cellOffsets[j * cols + i + 1]++;
+                         }
+                         else {
+                              cellEdges[cursor[j * cols + i]++] = e;
+                         }
+                    }
+               }
+          }
+     }
+}
+
+/*
+ * Follows GraphTopology::insertEdge(): the stored edges are moved to the
+ * new handles and edge is added to its cells, unless its street already
+ * is. The grid keeps its bounds; a street beyond them lands in the border
+ * cells, where the clamped queries find it.
+ */
+void EdgeGrid::insert(uint32_t edge){
+     if (cellEdges.empty()){
+          build(topology);
+          return;
+     }
+
+     for(uint32_t k=0; k < cellEdges.size(); k++){
+          if (cellEdges[k] >= edge){
+               cellEdges[k]++;
+          }
+     }
+     if (topology->getReverseEdge(edge) != GraphTopology::NONE){
+          return;
+     }
+
+     int col1,row1,col2,row2;
+     getCells(edge,col1,row1,col2,row2);
+     vector<uint32_t> edges;
+     edges.reserve(cellEdges.size() + (col2 - col1 + 1) * (row2 - row1 + 1));
+     uint32_t added = 0;
+     for(int c=0; c < cols * rows; c++){
+          edges.insert(edges.end(),cellEdges.begin() + cellOffsets[c],cellEdges.begin() + cellOffsets[c + 1]);
+          cellOffsets[c] += added;
+          int col = c % cols;
+          int row = c / cols;
+          if (col >= col1 && col <= col2 && row >= row1 && row <= row2){
+               edges.push_back(edge);
+               added++;
+          }
+     }
+     cellOffsets[cols * rows] += added;
+     cellEdges.swap(edges);
+}
+
+int EdgeGrid::getCol(double x) const{
+     int col = (int) floor((x - minX) / cellSize);
+     return std::max(0,std::min(cols - 1,col));
+}
+
+int EdgeGrid::getRow(double y) const{
+     int row = (int) floor((y - minY) / cellSize);
+     return std::max(0,std::min(rows - 1,row));
+}
+
+void EdgeGrid::getCells(uint32_t edge,int& col1,int& row1,int& col2,int& row2) const{
+     uint32_t from = topology->getEdgeSource(edge);
+     uint32_t to = topology->getEdgeTarget(edge);
+
+     // padded by a metre for the rounding in Util::linesegmentsIntersect
+     col1 = getCol(std::min(topology->getX(from),topology->getX(to)) - 1);
+     col2 = getCol(std::max(topology->getX(from),topology->getX(to)) + 1);
+     row1 = getRow(std::min(topology->getY(from),topology->getY(to)) - 1);
+     row2 = getRow(std::max(topology->getY(from),topology->getY(to)) + 1);
+}
+
+size_t EdgeGrid::getBytes() const{
+     return (cellOffsets.capacity() + cellEdges.capacity()) * sizeof(uint32_t);
+}
+
+bool EdgeGrid::intersects(Vector p1,Vector p2) const{
+     if (cellEdges.empty()){
+          return false;
+     }
+
+     int col1 = getCol(std::min(p1.x,p2.x));
+     int col2 = getCol(std::max(p1.x,p2.x));
+     int row1 = getRow(std::min(p1.y,p2.y));
+     int row2 = getRow(std::max(p1.y,p2.y));
+
+     for(int j = row1; j <= row2; j++){
+          for(int i = col1; i <= col2; i++){
+               int cell = j * cols + i;
+               for(uint32_t k = cellOffsets[cell]; k < cellOffsets[cell + 1]; k++){
+                    uint32_t from = topology->getEdgeSource(cellEdges[k]);
+                    uint32_t to = topology->getEdgeTarget(cellEdges[k]);
+                    Vector q1(topology->getX(from),topology->getY(from),0);
+                    Vector q2(topology->getX(to),topology->getY(to),0);
+
+                    if (Util::linesegmentsIntersect(p1,p2,q1,q2)){
+                         return true;
+                    }
+               }
+          }
+     }
+
+     return false;
+}
+
+}
@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#ifndef SPATIALINDEX_H_
+#define SPATIALINDEX_H_
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/vector.h"
+#include "GraphTopology.h"
+
+using namespace std;
+
+namespace ns3{
+
+/**
+ * \ingroup mobility
+ * \brief Uniform grid over the nodes of a GraphTopology.
+ *
+ * The bounding box of the nodes is split into square cells holding about
+ * two nodes each, and the nodes of every cell are stored contiguously.
+ * Nearest and k-nearest queries search rings of cells around the query
+ * point and stop as soon as no unvisited cell can hold a closer node.
+ */
+class NodeGrid {
+private:
+     const GraphTopology* topology;
+     double minX;
+     double minY;
+     double cellSize;
+     int cols;
+     int rows;
+     vector<uint32_t> cellOffsets;
+     vector<uint32_t> cellNodes;
+
+     int getCol(double x) const;
+     int getRow(double y) const;
+     double distance2(uint32_t node,double x,double y) const;
+
+public:
+     NodeGrid();
+     void build(const GraphTopology* t);
+     bool isEmpty() const;
+     size_t getBytes() const;
+     uint32_t nearest(double x,double y) const;
+     vector<uint32_t> nearest(double x,double y,int k) const;
+     vector<uint32_t> within(double x,double y,double radius) const;
+     vector<uint32_t> inside(double x1,double y1,double x2,double y2) const;
+};
+
+/**
+ * \ingroup mobility
+ * \brief Uniform grid over the edge segments of a GraphTopology.
+ *
+ * Each street is stored once (not once per direction) in every cell its
+ * bounding box overlaps. A segment query only tests the streets stored in
+ * the cells overlapped by the query's own bounding box. Closed streets are
+ * still streets on the ground and stay in the grid.
+ */
+class EdgeGrid {
+private:
+     const GraphTopology* topology;
+     double minX;
+     double minY;
+     double cellSize;
+     int cols;
+     int rows;
+     vector<uint32_t> cellOffsets;
+     vector<uint32_t> cellEdges;
+
+     int getCol(double x) const;
+     int getRow(double y) const;
+     void getCells(uint32_t edge,int& col1,int& row1,int& col2,int& row2) const;
+
+public:
+     EdgeGrid();
+     void build(const GraphTopology* t);
+     void insert(uint32_t edge);
+     size_t getBytes() const;
+     double getCellSize() const { return cellSize; } // cells start at the lowest node coordinates
+     bool intersects(Vector p1,Vector p2) const;
+};
+
+}
+
+#endif /* SPATIALINDEX_H_ */
@@ -0,0 +1,283 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#include "TerritoryMap.h"
+#include <cmath>
+
+using namespace std;
+
+namespace ns3{
+
+TerritoryMap::TerritoryMap(Ptr<GraphData> data) {
+     this->data = data;
+     const GraphTopology& topology = data->getTopology();
+     home.assign(topology.getEdgeCount(),GraphTopology::NONE);
+     owner.assign(topology.getEdgeCount(),GraphTopology::NONE);
+     reachedBy.assign(topology.getNodeCount(),GraphTopology::NONE);
+     hops.assign(topology.getNodeCount(),0);
+     largestLoad = 0;
+     lendingDepth = 1;
+     changesSeen = data->getChangeCount();
+}
+
+/*
+ * Adds the edges of subgraph not yet in a territory, matched by node id;
+ * the root of the territory is the base of the subgraph. Returns the id of
+ * the territory, which starts present.
+ */
+uint32_t TerritoryMap::addTerritory(Ptr<GraphData> subgraph){
+     const GraphTopology& topology = data->getTopology();
+     const GraphTopology& sub = subgraph->getTopology();
+     uint32_t territory = (uint32_t) roots.size();
+     uint32_t root = GraphTopology::NONE;
+
+     edgeCounts.push_back(0);
+     loads.push_back(0);
+     edges.push_back(vector<uint32_t>());
+     for(uint32_t e=0; e < sub.getEdgeCount(); e++){
+          uint32_t from = topology.find(sub.getId(sub.getEdgeSource(e)));
+          uint32_t to = topology.find(sub.getId(sub.getEdgeTarget(e)));
+          if (from == GraphTopology::NONE || to == GraphTopology::NONE){
+               continue;
+          }
+
+          uint32_t edge = topology.findEdge(from,to);
+          if (edge != GraphTopology::NONE && home[edge] == GraphTopology::NONE){
+               home[edge] = territory;
+               setOwner(edge,territory);
+               edges[territory].push_back(edge);
+               if (root == GraphTopology::NONE){
+                    root = from;
+               }
+          }
+     }
+
+     if (sub.getBase() != GraphTopology::NONE && topology.find(sub.getId(sub.getBase())) != GraphTopology::NONE){
+          root = topology.find(sub.getId(sub.getBase()));
+     }
+
+     if (loads[territory] > largestLoad){
+          largestLoad = loads[territory];
+     }
+     roots.push_back(root);
+     present.push_back(true);
+     lent.push_back(vector<uint32_t>());
+     return territory;
+}
+
+/* Hops from a shared node within which edges are lent; 0 lends nothing. */
+void TerritoryMap::setLendingDepth(int depth){
+     lendingDepth = depth;
+}
+
+void TerritoryMap::setPresent(uint32_t territory,bool present){
+     update();
+     if (this->present[territory] == present){
+          return;
+     }
+
+     this->present[territory] = present;
+     if (present){
+          reclaim(territory);
+     }
+     else {
+          returnBorrowed(territory);
+          lend(territory);
+     }
+}
+
+void TerritoryMap::update(){
+     const GraphTopology& topology = data->getTopology();
+     vector<uint32_t> added;
+     for(; changesSeen < data->getChangeCount(); changesSeen++){
+          const GraphChange& change = data->getChange(changesSeen);
+          if (change.type != EDGE_ADDED){
+               continue;
+          }
+
+          uint32_t edge = change.edge;
+          for(uint32_t t=0; t < edges.size(); t++){
+               for(uint32_t i=0; i < edges[t].size(); i++){
+                    if (edges[t][i] >= edge){
+                         edges[t][i]++;
+                    }
+               }
+               for(uint32_t i=0; i < lent[t].size(); i++){
+                    if (lent[t][i] >= edge){
+                         lent[t][i]++;
+                    }
+               }
+          }
+          for(uint32_t i=0; i < added.size(); i++){
+               if (added[i] >= edge){
+                    added[i]++;
+               }
+          }
+          home.insert(home.begin() + edge,GraphTopology::NONE);
+          owner.insert(owner.begin() + edge,GraphTopology::NONE);
+          added.push_back(edge);
+     }
+
+     // homes are given once every handle is current
+     for(uint32_t i=0; i < added.size(); i++){
+          uint32_t edge = added[i];
+          uint32_t territory = GraphTopology::NONE;
+          uint32_t reverse = topology.getReverseEdge(edge);
+          if (reverse != GraphTopology::NONE){
+               territory = home[reverse];
+          }
+          uint32_t source = topology.getEdgeSource(edge);
+          for(uint32_t e = topology.getFirstEdge(source); territory == GraphTopology::NONE && e < topology.getLastEdge(source); e++){
+               territory = home[e];
+          }
+          if (territory == GraphTopology::NONE){
+               continue;
+          }
+
+          home[edge] = territory;
+          setOwner(edge,territory);
+          edges[territory].push_back(edge);
+          if (loads[territory] > largestLoad){
+               largestLoad = loads[territory];
+          }
+     }
+}
+
+void TerritoryMap::setOwner(uint32_t edge,uint32_t territory){
+     double length = getLength(edge);
+     if (owner[edge] != GraphTopology::NONE){
+          edgeCounts[owner[edge]]--;
+          loads[owner[edge]] -= length;
+     }
+     owner[edge] = territory;
+     edgeCounts[territory]++;
+     loads[territory] += length;
+}
+
+double TerritoryMap::getLength(uint32_t edge) const{
+     const GraphTopology& topology = data->getTopology();
+     double dx = topology.getX(topology.getEdgeTarget(edge)) - topology.getX(topology.getEdgeSource(edge));
+     double dy = topology.getY(topology.getEdgeTarget(edge)) - topology.getY(topology.getEdgeSource(edge));
+     return sqrt(dx*dx + dy*dy);
+}
+
+/*
+ * Breadth first search over the edges the territory still owns, from its
+ * nodes that touch an edge of a present neighbour; every edge met within
+ * lendingDepth hops goes, with its reverse, to the neighbour the search
+ * came from, unless it would take that neighbour past largestLoad.
+ */
+void TerritoryMap::lend(uint32_t territory){
+     if (lendingDepth <= 0){
+          return;
+     }
+
+     const GraphTopology& topology = data->getTopology();
+     frontier.clear();
+     for(uint32_t i=0; i < edges[territory].size(); i++){
+          uint32_t e = edges[territory][i];
+          if (owner[e] != territory){
+               continue;
+          }
+
+          uint32_t node = topology.getEdgeSource(e);
+          if (reachedBy[node] != GraphTopology::NONE){
+               continue;
+          }
+          uint32_t last = topology.getLastEdge(node);
+          for(uint32_t f = topology.getFirstEdge(node); f < last; f++){
+               uint32_t neighbour = owner[f];
+               if (neighbour != territory && neighbour != GraphTopology::NONE && present[neighbour]){
+                    reachedBy[node] = neighbour;
+                    hops[node] = 0;
+                    frontier.push_back(node);
+                    break;
+               }
+          }
+     }
+
+     for(uint32_t i=0; i < frontier.size(); i++){
+          uint32_t node = frontier[i];
+          if (hops[node] >= lendingDepth){
+               continue;
+          }
+
+          uint32_t last = topology.getLastEdge(node);
+          for(uint32_t e = topology.getFirstEdge(node); e < last; e++){
+               uint32_t borrower = reachedBy[node];
+               if (owner[e] != territory || loads[borrower] + 2 * getLength(e) > largestLoad){
+                    continue;
+               }
+
+               setOwner(e,borrower);
+               lent[territory].push_back(e);
+               uint32_t reverse = topology.getReverseEdge(e);
+               if (reverse != GraphTopology::NONE && owner[reverse] == territory){
+                    setOwner(reverse,borrower);
+                    lent[territory].push_back(reverse);
+               }
+
+               uint32_t next = topology.getEdgeTarget(e);
+               if (reachedBy[next] == GraphTopology::NONE){
+                    reachedBy[next] = reachedBy[node];
+                    hops[next] = hops[node] + 1;
+                    frontier.push_back(next);
+               }
+          }
+     }
+
+     for(uint32_t i=0; i < frontier.size(); i++){
+          reachedBy[frontier[i]] = GraphTopology::NONE;
+     }
+}
+
+/* Takes back the edges lent while the territory was away. */
+void TerritoryMap::reclaim(uint32_t territory){
+     for(uint32_t i=0; i < lent[territory].size(); i++){
+          setOwner(lent[territory][i],territory);
+     }
+     lent[territory].clear();
+}
+
+/*
+ * Gives borrowed edges back to their home before the territory leaves; a
+ * home that is away too lends them again to its present neighbours, so
+ * they are not left idle until it returns.
+ */
+void TerritoryMap::returnBorrowed(uint32_t territory){
+     for(uint32_t t=0; t < lent.size(); t++){
+          uint32_t kept = 0;
+          bool returned = false;
+          for(uint32_t i=0; i < lent[t].size(); i++){
+               if (owner[lent[t][i]] == territory){
+                    setOwner(lent[t][i],t);
+                    returned = true;
+               }
+               else {
+                    lent[t][kept++] = lent[t][i];
+               }
+          }
+          lent[t].resize(kept);
+          if (returned && !present[t]){
+               lend(t);
+          }
+     }
+}
+
+}
@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#ifndef TERRITORYMAP_H_
+#define TERRITORYMAP_H_
+
+#include "GraphData.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+namespace ns3{
+
+/**
+ * \brief Territories of a fleet on one graph, with edges lent at runtime.
+ *
+ * Every territory is a subgraph (one gN.xml of a partition) matched by
+ * node id onto the full graph, which all UAVs of the fleet walk; each edge
+ * of the full graph has a home territory and a current owner, and a UAV
+ * only chooses the edges its territory owns.
+ *
+ * When a territory's UAV leaves its patrol (to return to base and switch
+ * battery) its edges near present neighbours are lent to them: a search
+ * from the nodes the territory shares with each neighbour gives that
+ * neighbour the edges within a few hops (setLendingDepth()), as long as
+ * the length of road it owns stays within the largest home territory, so
+ * no UAV gets a longer round than the busiest one already has. When the UAV
+ * is back the lent edges return home, and edges it had borrowed itself go
+ * back when it leaves, or on to the present neighbours of their home if
+ * that is still away. Only the edges that change owner are touched, and
+ * the Graphs read the owners directly, so nothing is reloaded.
+ *
+ * update() follows the edges added to the data since it was last called;
+ * a new edge joins the territory of its reverse, or else of an edge
+ * leaving its source. Closed edges keep their owners.
+ */
+class TerritoryMap : public SimpleRefCount<TerritoryMap> {
+private:
+     Ptr<GraphData> data;
+     vector<uint32_t> home;           // indexed by edge handle, NONE outside every territory
+     vector<uint32_t> owner;          // indexed by edge handle
+     vector<vector<uint32_t> > edges; // indexed by territory, home edges
+     vector<uint32_t> roots;          // indexed by territory, node handle
+     vector<bool> present;            // indexed by territory
+     vector<vector<uint32_t> > lent;  // indexed by territory, edges lent to others
+     vector<uint32_t> edgeCounts;     // indexed by territory, edges owned
+     vector<double> loads;            // indexed by territory, length of the edges owned
+     double largestLoad;              // largest length of a territory's home edges
+     int lendingDepth;
+     uint32_t changesSeen;            // changes of the data followed so far
+
+     // search state kept between calls
+     vector<uint32_t> reachedBy;      // territory a node was reached from
+     vector<int> hops;
+     vector<uint32_t> frontier;
+
+     void setOwner(uint32_t edge,uint32_t territory);
+     double getLength(uint32_t edge) const;
+     void lend(uint32_t territory);
+     void reclaim(uint32_t territory);
+     void returnBorrowed(uint32_t territory);
+
+public:
+     TerritoryMap(Ptr<GraphData> data);
+     uint32_t addTerritory(Ptr<GraphData> subgraph);
+     void setLendingDepth(int depth);
+     void setPresent(uint32_t territory,bool present);
+     void update();
+
+     const GraphData* getData() const { return PeekPointer(data); }
+     uint32_t getTerritoryCount() const { return (uint32_t) roots.size(); }
+     uint32_t getRoot(uint32_t territory) const { return roots[territory]; }
+     bool isPresent(uint32_t territory) const { return present[territory]; }
+     bool owns(uint32_t territory,uint32_t edge) const { return owner[edge] == territory; }
+     uint32_t getOwner(uint32_t edge) const { return owner[edge]; }
+     uint32_t getHome(uint32_t edge) const { return home[edge]; }
+     uint32_t getEdgeCount(uint32_t territory) const { return edgeCounts[territory]; }
+     double getLoad(uint32_t territory) const { return loads[territory]; } // meters
+};
+
+}
+
+#endif /* TERRITORYMAP_H_ */
@@ -24,8 +24,9 @@
 namespace ns3 {
 
 float Util::min(vector<float> values){
-     float minValue = 0;
-     for(int i=0; i < (int) values.size(); i++){
+     if (values.empty()) return 0;
+     float minValue = values[0];
+     for(int i=1; i < (int) values.size(); i++){
           if (values[i] < minValue){
                minValue = values[i];
           }
@@ -34,8 +35,9 @@ float Util::min(vector<float> values){
 }
 
 float Util::max(vector<float> values){
-     float maxValue = 0;
-     for(int i=0; i < (int) values.size(); i++){
+     if (values.empty()) return 0;
+     float maxValue = values[0];
+     for(int i=1; i < (int) values.size(); i++){
           if (values[i] > maxValue){
                maxValue = values[i];
           }
@@ -99,5 +101,23 @@ bool Util::linesegmentsIntersect(Vector p1, Vector q1, Vector p2, Vector q2)
     return false; // Doesn't fall in any of the above cases
 }
 
+/*
+ * Even-odd test: a ray from point to the right crosses the border of the
+ * polygon an odd number of times when point is inside. The polygon is
+ * closed from its last vertex back to its first.
+ */
+bool Util::pointInPolygon(Vector point,const vector<Vector>& polygon){
+     bool inside = false;
+     for(size_t i=0, j=polygon.size() - 1; i < polygon.size(); j = i++){
+          const Vector& a = polygon[i];
+          const Vector& b = polygon[j];
+          if ((a.y > point.y) != (b.y > point.y) &&
+              point.x < (b.x - a.x) * (point.y - a.y) / (b.y - a.y) + a.x){
+               inside = !inside;
+          }
+     }
+     return inside;
+}
+
 } // namespace ns3
 
@@ -104,6 +104,7 @@ private:
 
 public:
      static bool linesegmentsIntersect(Vector p1,Vector p2,Vector q1,Vector q2);
+     static bool pointInPolygon(Vector point,const vector<Vector>& polygon);
      static float min(vector<float> values);
      static float max(vector<float> values);
 
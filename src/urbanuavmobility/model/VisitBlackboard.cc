@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#include "VisitBlackboard.h"
+
+using namespace std;
+
+namespace ns3{
+
+VisitBlackboard::VisitBlackboard(Ptr<GraphData> data) {
+     this->data = data;
+     counts.assign(data->getTopology().getEdgeCount(),0);
+     lastVisits.assign(data->getTopology().getEdgeCount(),0);
+     logStart = 0;
+     trimSize = counts.size() + 1024;
+     changesSeen = data->getChangeCount();
+}
+
+/* Moves the counts and the log to the handles of edges added since. */
+void VisitBlackboard::update(){
+     for(; changesSeen < data->getChangeCount(); changesSeen++){
+          const GraphChange& change = data->getChange(changesSeen);
+          if (change.type != EDGE_ADDED){
+               continue;
+          }
+
+          counts.insert(counts.begin() + change.edge,0);
+          lastVisits.insert(lastVisits.begin() + change.edge,0);
+          for(uint32_t i=0; i < log.size(); i++){
+               if (log[i] >= change.edge){
+                    log[i]++;
+               }
+          }
+     }
+}
+
+/* Returns the id of a new subscriber, which will only collect later visits. */
+uint32_t VisitBlackboard::subscribe(){
+     cursors.push_back(logStart + log.size());
+     return (uint32_t) cursors.size() - 1;
+}
+
+void VisitBlackboard::publish(uint32_t edge,int count,double time){
+     update();
+     if (count > counts[edge]){
+          counts[edge] = count;
+     }
+     if (time > lastVisits[edge]){
+          lastVisits[edge] = time;
+     }
+     log.push_back(edge);
+
+     if (log.size() > trimSize){
+          trim();
+     }
+}
+
+/*
+ * Appends to edges the edges published since the subscriber last
+ * collected, in publishing order; an edge may appear more than once.
+ */
+void VisitBlackboard::collect(uint32_t subscriber,vector<uint32_t>& edges){
+     update();
+     for(uint64_t i = cursors[subscriber]; i < logStart + log.size(); i++){
+          edges.push_back(log[i - logStart]);
+     }
+     cursors[subscriber] = logStart + log.size();
+}
+
+/*
+ * Drops the part of the log every subscriber has read. A subscriber that
+ * stopped collecting holds the log back, so the next trim waits until the
+ * log has doubled.
+ */
+void VisitBlackboard::trim(){
+     uint64_t read = logStart + log.size();
+     for(uint32_t i=0; i < cursors.size(); i++){
+          if (cursors[i] < read){
+               read = cursors[i];
+          }
+     }
+
+     if (read > logStart){
+          log.erase(log.begin(),log.begin() + (read - logStart));
+          logStart = read;
+     }
+     if (trimSize < 2 * log.size()){
+          trimSize = 2 * log.size();
+     }
+}
+
+}
@@ -0,0 +1,77 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#ifndef VISITBLACKBOARD_H_
+#define VISITBLACKBOARD_H_
+
+#include "GraphData.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+namespace ns3{
+
+/**
+ * \brief Visits shared in process by the UAVs patrolling one graph.
+ *
+ * Stands in for the edges broadcasts when only the patrol matters: every
+ * Graph sharing the board publishes its own visits, and before choosing a
+ * node takes the edges others visited since it last looked, keeping the
+ * larger count as mergeMobilityData does with a received broadcast.
+ *
+ * The board keeps the largest count and the latest visit of each edge and
+ * a log of the edges published. Each subscriber has a cursor in the log,
+ * so catching up costs the visits made since, not the size of the graph;
+ * the log is trimmed once every subscriber has read past its start.
+ * Edges added to the data are followed before every publish and collect.
+ *
+ * There is no locking: all the Graphs of a simulation are driven by the
+ * simulator thread, which is the only writer and reader.
+ */
+class VisitBlackboard : public SimpleRefCount<VisitBlackboard> {
+private:
+     Ptr<GraphData> data;
+     vector<int> counts;         // indexed by edge handle
+     vector<double> lastVisits;  // indexed by edge handle, seconds
+     vector<uint32_t> log;       // edges published, oldest first
+     uint64_t logStart;          // position of log[0] since the board was created
+     vector<uint64_t> cursors;   // indexed by subscriber, next position to read
+     size_t trimSize;            // log size that triggers the next trim
+     uint32_t changesSeen;       // changes of the data followed so far
+
+     void trim();
+
+public:
+     VisitBlackboard(Ptr<GraphData> data);
+     uint32_t subscribe();
+     void update();
+     void publish(uint32_t edge,int count,double time);
+     void collect(uint32_t subscriber,vector<uint32_t>& edges);
+     const GraphData* getData() const { return PeekPointer(data); }
+     int getCount(uint32_t edge) const { return counts[edge]; }
+     double getLastVisit(uint32_t edge) const { return lastVisits[edge]; }
+     uint32_t getSubscribers() const { return (uint32_t) cursors.size(); }
+};
+
+}
+
+#endif /* VISITBLACKBOARD_H_ */
@@ -0,0 +1,69 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#include "WorkerPool.h"
+#include "ns3/system-thread.h"
+#include <libxml/parser.h>
+#include <vector>
+
+using namespace std;
+
+namespace ns3{
+
+WorkerPool::WorkerPool(uint32_t threads){
+     this->threads = threads > 0 ? threads : 1;
+     count = 0;
+     next = 0;
+}
+
+void WorkerPool::run(uint32_t count,Callback<void,uint32_t> task){
+     // libxml must be initialised before it is used from several threads
+     xmlInitParser();
+
+     this->count = count;
+     this->task = task;
+     next = 0;
+
+     uint32_t n = threads < count ? threads : count;
+     vector<Ptr<SystemThread> > workers;
+     for(uint32_t i=0; i < n; i++){
+          workers.push_back(Create<SystemThread>(MakeCallback(&WorkerPool::runPending,this)));
+          workers.back()->Start();
+     }
+     for(uint32_t i=0; i < n; i++){
+          workers[i]->Join();
+     }
+     this->task = Callback<void,uint32_t>();
+}
+
+void WorkerPool::runPending(){
+     while (true){
+          uint32_t index;
+          {
+               CriticalSection lock(mutex);
+               if (next >= count){
+                    return;
+               }
+               index = next++;
+          }
+          task(index);
+     }
+}
+
+}
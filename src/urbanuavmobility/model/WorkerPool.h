@@ -0,0 +1,57 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
+#ifndef WORKERPOOL_H_
+#define WORKERPOOL_H_
+
+#include "ns3/callback.h"
+#include "ns3/system-mutex.h"
+#include <stdint.h>
+
+using namespace std;
+
+namespace ns3{
+
+/**
+ * \brief Runs a task for each index of a list on a pool of threads.
+ *
+ * run() starts up to the given number of threads, each taking the next
+ * index from a shared counter until the list is exhausted, and returns
+ * once all have finished. The task must only touch what belongs to its
+ * index; Ptr counts are not atomic, so objects it shares with other
+ * indices are created on the calling thread and only read.
+ */
+class WorkerPool {
+private:
+     uint32_t threads;
+     uint32_t count;
+     uint32_t next;
+     Callback<void,uint32_t> task;
+     SystemMutex mutex;
+
+     void runPending();
+
+public:
+     WorkerPool(uint32_t threads);
+     void run(uint32_t count,Callback<void,uint32_t> task);
+};
+
+}
+
+#endif /* WORKERPOOL_H_ */
@@ -52,11 +52,14 @@ GraphMobilityModel::GetTypeId (void)
 
 GraphMobilityModel::GraphMobilityModel ()
 {
-
+     currentNodeIndex = GraphTopology::NONE;
+     nextNodeIndex = GraphTopology::NONE;
 }
 
 GraphMobilityModel::GraphMobilityModel (char* file)
 {
+     currentNodeIndex = GraphTopology::NONE;
+     nextNodeIndex = GraphTopology::NONE;
 
      graph.load(file);
 //     walk();
@@ -70,11 +73,11 @@ GraphMobilityModel::GraphMobilityModel (char* file,double maxSpeed,string select
 
      cout << "loading graph" << endl;      
      graph.load(file);
-     baseNode = Vector(graph.getRoot()->getX(),graph.getRoot()->getY(),0);
+     baseNode = Vector(graph.getRoot().getX(),graph.getRoot().getY(),0);
      currentNode = baseNode;
      nextNode = baseNode;
-     currentNodeId = "base";
-     nextNodeId = "base";
+     currentNodeIndex = GraphTopology::NONE;
+     nextNodeIndex = GraphTopology::NONE;
 
 
 //     walk();
@@ -87,8 +90,8 @@ GraphMobilityModel::GraphMobilityModel (char* file,double maxSpeed,float baseX,f
 
      currentNode = baseNode;
      nextNode = baseNode;
-     currentNodeId = "base";
-     nextNodeId = "base";
+     currentNodeIndex = GraphTopology::NONE;
+     nextNodeIndex = GraphTopology::NONE;
 
      cout << "loading graph" << endl;      
      graph.load(file);
@@ -137,11 +140,42 @@ Vector GraphMobilityModel::DoGetVelocity (void) const
   return Vector();
 }
 
+int64_t GraphMobilityModel::DoAssignStreams (int64_t stream)
+{
+  return graph.assignStreams(stream);
+}
+
+/*
+ * Takes the visits of the other models sharing board instead of edges
+ * broadcasts. Fails when board was made for another graph.
+ */
+bool GraphMobilityModel::shareVisits(Ptr<VisitBlackboard> board)
+{
+  return graph.shareVisits(board);
+}
+
+/*
+ * Patrols the edges territory owns in map, from the root of the territory,
+ * which becomes the base. Must be called before the walk starts.
+ */
+bool GraphMobilityModel::joinTerritory(Ptr<TerritoryMap> map,uint32_t territory)
+{
+  if (!graph.setTerritory(map,territory))
+    {
+      return false;
+    }
+
+  baseNode = Vector(graph.getRoot().getX(),graph.getRoot().getY(),0);
+  currentNode = baseNode;
+  nextNode = baseNode;
+  return true;
+}
+
 void GraphMobilityModel::onReached(){
      cout << GetId() <<  " reached at " << Simulator::Now() << endl;
      currentNode = nextNode;     
-     graph.markEdge(currentNodeId,nextNodeId,Simulator::Now().GetSeconds());
-     currentNodeId = nextNodeId;
+     graph.markEdge(currentNodeIndex,nextNodeIndex,Simulator::Now().GetSeconds());
+     currentNodeIndex = nextNodeIndex;
 }
 
 void GraphMobilityModel::reached(){
@@ -170,7 +204,7 @@ void GraphMobilityModel::accept(GraphNode* node){
 
      Vector point(node->getX(),node->getY(),0.0);
      nextNode = point;
-     nextNodeId = node->getId();
+     nextNodeIndex = node->getIndex();
 
      cout << GetId() << ";current: (" << currentNode.x << "," << currentNode.y << ");"
           << "next: (" << nextNode.x << "," << nextNode.y << ")" << endl;
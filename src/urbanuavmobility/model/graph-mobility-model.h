@@ -53,8 +53,8 @@ protected:
   Vector baseNode;
   Vector currentNode;
   Vector nextNode;
-  string currentNodeId;
-  string nextNodeId;
+  uint32_t currentNodeIndex;
+  uint32_t nextNodeIndex;
   Time lastUpdate;
   Time travelDelay;
   EventId lastScheduledEvent;
@@ -79,9 +79,12 @@ public:
   void walk();
 
   virtual void accept(GraphNode* node);
+  bool shareVisits(Ptr<VisitBlackboard> board);
+  bool joinTerritory(Ptr<TerritoryMap> map,uint32_t territory);
   virtual Vector DoGetPosition (void) const;
   virtual void DoSetPosition (const Vector &position);
   virtual Vector DoGetVelocity (void) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
   virtual void printResults();
   virtual ~GraphMobilityModel ();
 
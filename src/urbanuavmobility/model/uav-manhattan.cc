@@ -116,45 +116,22 @@ UavManhattanMobilityModel::printTrajectory()
 void
 UavManhattanMobilityModel::printCoverage(float cellwidth,float celllength)
 {
-     int totalrelevantcount = 0,relevantcovered = 0, irrelevantcovered = 0;
-
-     vector<Region> cells = graph.decompose(cellwidth,celllength);
-     for(int i=0; i < (int) cells.size(); i++){
-          if(cells[i].getColor() == 1) {
-               totalrelevantcount++;
-          }
-     }
-
+     CoverageGrid cells = graph.decompose(cellwidth,celllength);
+     int totalrelevantcount = cells.count(1);
 
      for(int i=0; i < (int) trajectory.size(); i++){
-          for(int j=0; j < (int) cells.size(); j++){
-               if(cells[j].hasPoint(trajectory[i])) {
-                    if (cells[j].getColor() == 1)
-                         cells[j].mark(2);
-                    else if (cells[j].getColor() == 0)
-                         cells[j].mark(3);
-                    break;
-               }
-          }
+          cells.visit(trajectory[i]);
      }
 
-//     int count = 0;
-     for(int i=0; i < (int) cells.size(); i++){
-          if(cells[i].getColor() == 2) {
-               relevantcovered++;
-          }
-          else if (cells[i].getColor() == 3){
-               irrelevantcovered++;
-          }
-     }
+     int relevantcovered = cells.count(2);
+     int irrelevantcovered = cells.count(3);
 
      cout << "coverage:" << ( 100.0 * relevantcovered / totalrelevantcount )  << "%" << endl;
      cout << "deviation:" << ( 100.0 * irrelevantcovered / (relevantcovered+irrelevantcovered) )  << "%" << endl;
 
-     for(int i=0; i < (int) cells.size(); i++){
-          if(cells[i].getColor() == 1) {
-               cells[i].print();
-          }
+     vector<Region> uncovered = cells.getCells(1);
+     for(int i=0; i < (int) uncovered.size(); i++){
+          uncovered[i].print();
      }
 
 }
@@ -63,6 +63,8 @@ UavMobilityModel::UavMobilityModel(){
   numberOfRecharges = 0;
   mode = patrolling;
   monitoringDestination = baseNode;
+  routedReturn = false;
+  returnNode = GraphTopology::NONE;
 }
 
 UavMobilityModel::UavMobilityModel(char* file,double maxSpeed,double ascSpeed,double descSpeed,Ptr<UavEnergyModel> energyModel,string selectionStrategy)
@@ -77,6 +79,16 @@ UavMobilityModel::UavMobilityModel(char* file,double maxSpeed,double ascSpeed,do
      monitoringDestination = baseNode;
      ascendSpeed = ascSpeed;
      descendSpeed = descSpeed;
+     routedReturn = false;
+     returnNode = GraphTopology::NONE;
+}
+
+/*
+ * Flies back to base along the shortest path of the graph instead of a
+ * straight line, and checks the battery against the length of that path.
+ */
+void UavMobilityModel::setRoutedReturn(bool routed){
+     routedReturn = routed;
 }
 
 void UavMobilityModel::activateLowEnergyMode(){
@@ -90,29 +102,94 @@ void UavMobilityModel::activateLowEnergyMode(){
 
 void UavMobilityModel::checkReturningToBase(){
      if (lowEnergyMode == true){
-          Vector currentPosition = DoGetPosition();
           double nextDistance = CalculateDistance (currentNode, nextNode);
-          double nextBaseDistance = CalculateDistance (nextNode, baseNode);
+          double nextBaseDistance = getBaseDistance();
           if ( energyModel->isLow(nextDistance + nextBaseDistance,ALT_FLY,GetSpeed(),GetSpeed(),GraphMobilityModel::PAUSE_TIME) ){
                returnToBase();
           }
      }
 }
 
+/*
+ * Distance from nextNode back to the base. The base of a UAV is the root
+ * of its graph, so with a routed return it is looked up in the distances
+ * to the root, computed once per graph; otherwise it is the straight line.
+ */
+double UavMobilityModel::getBaseDistance(){
+     if (routedReturn && mode == patrolling){
+          const DistanceField& field = graph.getReturnField();
+          if (field.isReachable(nextNodeIndex)){
+               return field.getDistance(nextNodeIndex);
+          }
+     }
+     return CalculateDistance (nextNode, baseNode);
+}
+
+/*
+ * The end of the current edge to join the way back at, the one giving the
+ * shorter return; NONE when neither leads back to the root.
+ */
+uint32_t UavMobilityModel::getReturnEntry(){
+     if (!routedReturn || mode != patrolling){
+          return GraphTopology::NONE;
+     }
+
+     const DistanceField& field = graph.getReturnField();
+     Vector position = DoGetPosition();
+     uint32_t ends[2] = {currentNodeIndex,nextNodeIndex};
+     uint32_t entry = GraphTopology::NONE;
+     double entryDistance = 0;
+     for(int i=0; i < 2; i++){
+          if (!field.isReachable(ends[i])){
+               continue;
+          }
+
+          GraphNode end = graph.getNode(ends[i]);
+          double distance = CalculateDistance (position, Vector(end.getX(),end.getY(),0)) + field.getDistance(ends[i]);
+          if (entry == GraphTopology::NONE || distance < entryDistance){
+               entry = ends[i];
+               entryDistance = distance;
+          }
+     }
+     return entry;
+}
+
 void UavMobilityModel::returnToBase(){
+     graph.setTerritoryPresence(false);
      energyModel->move(ALT_FLY,GetSpeed());
      cout << GetId() << " returning to base at " << Simulator::Now() << endl;
      lastScheduledEvent.Cancel();
 
      currentNode = DoGetPosition(); // the intermediate position that node has reached so far
-     nextNode = baseNode;
+     returnNode = getReturnEntry();
+     flyReturnLeg();
+}
+
+/* Flies to returnNode, or to the base once the root has been reached. */
+void UavMobilityModel::flyReturnLeg(){
+     void (ns3::UavMobilityModel::* next) ();
+     if (returnNode == GraphTopology::NONE){
+          nextNode = baseNode;
+          next = &UavMobilityModel::baseReached;
+     }
+     else {
+          GraphNode node = graph.getNode(returnNode);
+          nextNode = Vector(node.getX(),node.getY(),0);
+          next = &UavMobilityModel::returnNodeReached;
+     }
 
      cout << "current: (" << currentNode.x << "," << currentNode.y << ");"
           << "next: (" << nextNode.x << "," << nextNode.y << ")" << endl;
 
      travelDelay = Seconds (CalculateDistance (currentNode, nextNode) / GetSpeed());
      lastUpdate = Simulator::Now();
-     lastScheduledEvent = Simulator::Schedule(travelDelay, &UavMobilityModel::baseReached, this);
+     lastScheduledEvent = Simulator::Schedule(travelDelay, next, this);
+}
+
+void UavMobilityModel::returnNodeReached(){
+     currentNode = nextNode;
+     returnNode = graph.getReturnField().getNext(returnNode);
+     flyReturnLeg();
 }
 
 void UavMobilityModel::baseReached(){
@@ -140,6 +217,7 @@ void UavMobilityModel::switchBattery(){
 }
 
 void UavMobilityModel::onBatterySwitched(){
+     graph.setTerritoryPresence(true);
      start();
      go();
 }
@@ -341,45 +419,22 @@ UavMobilityModel::printTrajectory()
 void
 UavMobilityModel::printCoverage(float cellwidth,float celllength)
 {
-     int totalrelevantcount = 0,relevantcovered = 0, irrelevantcovered = 0;
-
-     vector<Region> cells = graph.decompose(cellwidth,celllength);
-     for(int i=0; i < (int) cells.size(); i++){
-          if(cells[i].getColor() == 1) {
-               totalrelevantcount++;
-          }
-     }
-
+     CoverageGrid cells = graph.decompose(cellwidth,celllength);
+     int totalrelevantcount = cells.count(1);
 
      for(int i=0; i < (int) trajectory.size(); i++){
-          for(int j=0; j < (int) cells.size(); j++){
-               if(cells[j].hasPoint(trajectory[i])) {
-                    if (cells[j].getColor() == 1)
-                         cells[j].mark(2);
-                    else if (cells[j].getColor() == 0)
-                         cells[j].mark(3);
-                    break;
-               }
-          }
+          cells.visit(trajectory[i]);
      }
 
-//     int count = 0;
-     for(int i=0; i < (int) cells.size(); i++){
-          if(cells[i].getColor() == 2) {
-               relevantcovered++;
-          }
-          else if (cells[i].getColor() == 3){
-               irrelevantcovered++;
-          }
-     }
+     int relevantcovered = cells.count(2);
+     int irrelevantcovered = cells.count(3);
 
      cout << "coverage:" << ( 100.0 * relevantcovered / totalrelevantcount )  << "%" << endl;
      cout << "deviation:" << ( 100.0 * irrelevantcovered / (relevantcovered+irrelevantcovered) )  << "%" << endl;
 
-     for(int i=0; i < (int) cells.size(); i++){
-          if(cells[i].getColor() == 1) {
-               cells[i].print();
-          }
+     vector<Region> uncovered = cells.getCells(1);
+     for(int i=0; i < (int) uncovered.size(); i++){
+          uncovered[i].print();
      }
 
 }
@@ -61,12 +61,18 @@ private:
   Vector monitoringDestination;
   double ascendSpeed;
   double descendSpeed;
+  bool routedReturn;
+  uint32_t returnNode;  // next node of a routed return, NONE on the way from the root to the base
 
   vector<Vector> trajectory;
 
 
   void monitorTraffic();
   void checkReturningToBase();
+  double getBaseDistance();
+  uint32_t getReturnEntry();
+  void flyReturnLeg();
+  void returnNodeReached();
   void ascend(void (ns3::UavMobilityModel::* next) ());
   void ascend(double alt,void (ns3::UavMobilityModel::* next) ());
   void descend(void (ns3::UavMobilityModel::* next) ());
@@ -104,6 +110,7 @@ public:
   void stop();
   void setMode(Mode m);
   void setMonitoringDestination(Vector& dest);
+  void setRoutedReturn(bool routed);
   Ptr<UavEnergyModel> getEnergyModel();
   virtual void accept(GraphNode* node);
   string getEdgesVisitCount();
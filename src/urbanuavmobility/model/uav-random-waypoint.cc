@@ -37,7 +37,6 @@
 #include "ns3/pointer.h"
 #include "ns3/string.h"
 #include "ns3/position-allocator.h"
-#include "ns3/rng-seed-manager.h"
 
 
 namespace ns3 {
@@ -76,7 +75,6 @@ UavRandomWaypointMobilityModel::UavRandomWaypointMobilityModel(){
 
 UavRandomWaypointMobilityModel::UavRandomWaypointMobilityModel(string graphFile,  Ptr<UavEnergyModel> energyModel)
 {
-     RngSeedManager::SetSeed(time(NULL));
      graph.load((char*)graphFile.c_str());
      this->energyModel = energyModel;
      energyModel->SetEnergyDepletionCallback(MakeCallback(&UavRandomWaypointMobilityModel::halt,this));
@@ -174,6 +172,17 @@ UavRandomWaypointMobilityModel::DoGetVelocity (void) const
   return m_helper.GetVelocity ();
 }
 
+int64_t
+UavRandomWaypointMobilityModel::DoAssignStreams (int64_t stream)
+{
+  int64_t positionStreamsAllocated;
+  m_speed->SetStream (stream);
+  m_pause->SetStream (stream + 1);
+  NS_ASSERT_MSG (m_position, "No position allocator added before using this model");
+  positionStreamsAllocated = m_position->AssignStreams (stream + 2);
+  return (2 + positionStreamsAllocated);
+}
+
 void
 UavRandomWaypointMobilityModel::printTrajectory()
 {
@@ -196,45 +205,22 @@ UavRandomWaypointMobilityModel::printTrajectory()
 void
 UavRandomWaypointMobilityModel::printCoverage(float cellwidth,float celllength)
 {
-     int totalrelevantcount = 0,relevantcovered = 0, irrelevantcovered = 0;
-
-     vector<Region> cells = graph.decompose(cellwidth,celllength);
-     for(int i=0; i < (int) cells.size(); i++){
-          if(cells[i].getColor() == 1) {
-               totalrelevantcount++;
-          }
-     }
-
+     CoverageGrid cells = graph.decompose(cellwidth,celllength);
+     int totalrelevantcount = cells.count(1);
 
      for(int i=0; i < (int) trajectory.size(); i++){
-          for(int j=0; j < (int) cells.size(); j++){
-               if(cells[j].hasPoint(trajectory[i])) {
-                    if (cells[j].getColor() == 1)
-                         cells[j].mark(2);
-                    else if (cells[j].getColor() == 0)
-                         cells[j].mark(3);
-                    break;
-               }
-          }
+          cells.visit(trajectory[i]);
      }
 
-//     int count = 0;
-     for(int i=0; i < (int) cells.size(); i++){
-          if(cells[i].getColor() == 2) {
-               relevantcovered++;
-          }
-          else if (cells[i].getColor() == 3){
-               irrelevantcovered++;
-          }
-     }
+     int relevantcovered = cells.count(2);
+     int irrelevantcovered = cells.count(3);
 
      cout << "coverage:" << ( 100.0 * relevantcovered / totalrelevantcount )  << "%" << endl;
      cout << "deviation:" << ( 100.0 * irrelevantcovered / (relevantcovered+irrelevantcovered) )  << "%" << endl;
 
-     for(int i=0; i < (int) cells.size(); i++){
-          if(cells[i].getColor() == 1) {
-               cells[i].print();
-          }
+     vector<Region> uncovered = cells.getCells(1);
+     for(int i=0; i < (int) uncovered.size(); i++){
+          uncovered[i].print();
      }
 
 }
@@ -61,7 +61,7 @@ UavSrcmMobilityModel::UavSrcmMobilityModel(string graphFile,Ptr<UavEnergyModel>
 {
 
      graph.load((char*)graphFile.c_str());
-     base = Vector(graph.getRoot()->getX(),graph.getRoot()->getY(),0);
+     base = Vector(graph.getRoot().getX(),graph.getRoot().getY(),0);
      current = base;
      this->range = range;
      this->speed = speed;
@@ -71,9 +71,20 @@ UavSrcmMobilityModel::UavSrcmMobilityModel(string graphFile,Ptr<UavEnergyModel>
      energyModel->SetEnergyDepletionCallback(MakeCallback(&UavSrcmMobilityModel::halt,this));
      energyModel->SetLowBatteryThreshold(0);
      energyModel->move(speed,speed);
+     radiusVariable = CreateObject<UniformRandomVariable>();
 
      recordTrajectory();
-     linear();
+}
+
+/*
+ * The first circle is started here rather than in the constructor so that
+ * its radius comes from the stream set by AssignStreams.
+ */
+void
+UavSrcmMobilityModel::DoInitialize (void)
+{
+  linear();
+  MobilityModel::DoInitialize ();
 }
 
 void
@@ -81,7 +92,7 @@ UavSrcmMobilityModel::linear(){
 
      theta = 0;
 
-     this->radius = (rand() % (int) range);
+     this->radius = radiusVariable->GetInteger(0,(uint32_t) range - 1);
      next.x = base.x + radius;
      
      travelDelay = Seconds (CalculateDistance (current, next) / speed);
@@ -163,6 +174,13 @@ UavSrcmMobilityModel::DoGetVelocity (void) const
   return Vector();
 }
 
+int64_t
+UavSrcmMobilityModel::DoAssignStreams (int64_t stream)
+{
+  radiusVariable->SetStream (stream);
+  return 1;
+}
+
 void
 UavSrcmMobilityModel::printTrajectory()
 {
@@ -185,45 +203,22 @@ UavSrcmMobilityModel::printTrajectory()
 void
 UavSrcmMobilityModel::printCoverage(float cellwidth,float celllength)
 {
-     int totalrelevantcount = 0,relevantcovered = 0, irrelevantcovered = 0;
-
-     vector<Region> cells = graph.decompose(cellwidth,celllength);
-     for(int i=0; i < (int) cells.size(); i++){
-          if(cells[i].getColor() == 1) {
-               totalrelevantcount++;
-          }
-     }
-
+     CoverageGrid cells = graph.decompose(cellwidth,celllength);
+     int totalrelevantcount = cells.count(1);
 
      for(int i=0; i < (int) trajectory.size(); i++){
-          for(int j=0; j < (int) cells.size(); j++){
-               if(cells[j].hasPoint(trajectory[i])) {
-                    if (cells[j].getColor() == 1)
-                         cells[j].mark(2);
-                    else if (cells[j].getColor() == 0)
-                         cells[j].mark(3);
-                    break;
-               }
-          }
+          cells.visit(trajectory[i]);
      }
 
-//     int count = 0;
-     for(int i=0; i < (int) cells.size(); i++){
-          if(cells[i].getColor() == 2) {
-               relevantcovered++;
-          }
-          else if (cells[i].getColor() == 3){
-               irrelevantcovered++;
-          }
-     }
+     int relevantcovered = cells.count(2);
+     int irrelevantcovered = cells.count(3);
 
      cout << "coverage:" << ( 100.0 * relevantcovered / totalrelevantcount )  << "%" << endl;
      cout << "deviation:" << ( 100.0 * irrelevantcovered / (relevantcovered+irrelevantcovered) )  << "%" << endl;
 
-     for(int i=0; i < (int) cells.size(); i++){
-          if(cells[i].getColor() == 1) {
-               cells[i].print();
-          }
+     vector<Region> uncovered = cells.getCells(1);
+     for(int i=0; i < (int) uncovered.size(); i++){
+          uncovered[i].print();
      }
 
 }
@@ -28,6 +28,7 @@
 #include "ns3/random-waypoint-mobility-model.h"
 #include "ns3/uav-energy-model.h"
 #include "ns3/event-id.h"
+#include "ns3/random-variable-stream.h"
 #include <libxml/parser.h>
 #include <iostream>
 #include <map>
@@ -66,6 +67,7 @@ protected:
 
   double range;
   double radius;
+  Ptr<UniformRandomVariable> radiusVariable;
   double speed;
   int theta;
 
@@ -81,6 +83,8 @@ protected:
   virtual Vector DoGetPosition (void) const;
   virtual void DoSetPosition (const Vector &position);
   virtual Vector DoGetVelocity (void) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+  virtual void DoInitialize (void);
 
   void recordTrajectory();
 
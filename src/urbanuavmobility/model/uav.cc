@@ -53,7 +53,8 @@ Uav::GetTypeId (void)
 }
 
 Uav::Uav(){
-
+     jitter = CreateObject<UniformRandomVariable>();
+     broadcasting = true;
 }
 
 void Uav::setup(Ptr<Channel> channel,string ip){
@@ -153,7 +154,9 @@ void Uav::launch(string baseIp){
      Ptr<UavMobilityModel> model = GetObject<UavMobilityModel>();
      if(model != NULL){
           model->go();
-          Simulator::Schedule(Seconds(broadcastFrequency), &Uav::sendEdgesInfo, this );
+          if (broadcasting){
+               Simulator::Schedule(Seconds(broadcastFrequency), &Uav::sendEdgesInfo, this );
+          }
      }
 
 /*
@@ -198,12 +201,27 @@ void Uav::setBroadcastFrequency(int f){
      broadcastFrequency = f;
 }
 
+/* Must be set before launch(). */
+void Uav::setBroadcasting(bool b){
+     broadcasting = b;
+}
+
+/*
+ * Fixes the stream of the broadcast jitter; the streams of the mobility
+ * model are assigned through MobilityModel::AssignStreams. Returns the
+ * number of streams used.
+ */
+int64_t Uav::AssignStreams(int64_t stream){
+     jitter->SetStream(stream);
+     return 1;
+}
+
 void Uav::sendEdgesInfo(){
      Ptr<UavMobilityModel> model = GetObject<UavMobilityModel>();
      if (model != NULL){
           app->setEdges(model->getEdgesVisitCount());
 
-          Simulator::Schedule (Seconds(rand()%2), &UavApplication::BroadcastPacket, app);
+          Simulator::Schedule (Seconds(jitter->GetInteger(0,1)), &UavApplication::BroadcastPacket, app);
           Simulator::Schedule (Seconds(broadcastFrequency), &Uav::sendEdgesInfo, this);
      }
 }
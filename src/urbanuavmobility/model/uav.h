@@ -23,6 +23,7 @@
 #include "ns3/node.h"
 #include "uav-mobility-model.h"
 #include "ns3/network-module.h"
+#include "ns3/random-variable-stream.h"
 #include "uav-application.h"
 #include <string>
 
@@ -40,6 +41,8 @@ class Uav : public Node {
 private:
      Ptr<UavApplication> app;
      int broadcastFrequency;
+     bool broadcasting;     // edges broadcasts, off when visits are shared in process
+     Ptr<UniformRandomVariable> jitter; // delay of each edges broadcast
 
 public:
      static TypeId GetTypeId (void);
@@ -55,6 +58,8 @@ public:
      void sendEdgesInfo();
      void handleEdgesInfo(string edges);
      void setBroadcastFrequency(int);
+     void setBroadcasting(bool);
+     int64_t AssignStreams(int64_t stream);
 
 	virtual ~Uav();
 };
@@ -1,55 +1,2318 @@
 /* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 Computer Science Department, FAST-NU, Lahore.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Farooq Ahmed <farooq.ahmad@nu.edu.pk>
+ */
 
-// Include a header file from your module to test.
-#include "ns3/urbanuavmobility.h"
-
-// An essential include is test.h
+#include "ns3/urbanuavmobility-module.h"
+#include "ns3/simulator.h"
+#include "ns3/system-path.h"
 #include "ns3/test.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <sys/stat.h>
+#include <utime.h>
 
 // Do not put your test classes in namespace ns3.  You may find it useful
 // to use the using directive to access the ns3 namespace directly
 using namespace ns3;
 
-// This is an example TestCase.
-class UrbanuavmobilityTestCase1 : public TestCase
+// Graph files are relative to the top level directory, where test.py runs
+// the suite, as they are for the programs in scratch/
+static const char* COLOGNE_GRAPH = "data/cologne-center-graph.xml";
+static const char* COLOGNE_SUBGRAPHS = "data/cologne-center-subgraphs-lfs-3-80/";
+
+/*
+ * Length of a node path in meters, or -1 if two consecutive nodes are not
+ * joined by an open edge.
+ */
+static double
+GetPathLength (const GraphTopology& topology, const std::vector<uint32_t>& path)
+{
+  double length = 0;
+  for (uint32_t i = 0; i + 1 < path.size (); i++)
+    {
+      uint32_t edge = topology.findEdge (path[i], path[i + 1]);
+      if (edge == GraphTopology::NONE || !topology.isOpen (edge))
+        {
+          return -1;
+        }
+      double dx = topology.getX (path[i + 1]) - topology.getX (path[i]);
+      double dy = topology.getY (path[i + 1]) - topology.getY (path[i]);
+      length += std::sqrt (dx * dx + dy * dy);
+    }
+  return length;
+}
+
+/*
+ * Adds a chord from the source of edge to a node two streets away, if one
+ * is not joined to it yet.
+ */
+static void
+AddChord (Ptr<GraphData> data, uint32_t edge)
+{
+  const GraphTopology& topology = data->getTopology ();
+  uint32_t from = topology.getEdgeSource (edge);
+  uint32_t middle = topology.getEdgeTarget (edge);
+  for (uint32_t e = topology.getFirstEdge (middle); e < topology.getLastEdge (middle); e++)
+    {
+      uint32_t to = topology.getEdgeTarget (e);
+      if (to != from && topology.findEdge (from, to) == GraphTopology::NONE)
+        {
+          data->addEdge (from, to);
+          return;
+        }
+    }
+}
+
+/* Copies a file, returns false if it cannot be read or written. */
+static bool
+CopyFile (const std::string& from, const std::string& to)
+{
+  FILE* in = fopen (from.c_str (), "rb");
+  FILE* out = in != 0 ? fopen (to.c_str (), "wb") : 0;
+  char buffer[4096];
+  size_t read;
+  while (out != 0 && (read = fread (buffer, 1, sizeof (buffer), in)) > 0)
+    {
+      fwrite (buffer, 1, read, out);
+    }
+  if (in != 0)
+    {
+      fclose (in);
+    }
+  return out != 0 && fclose (out) == 0;
+}
+
+/*
+ * Loads the Cologne graph and checks the compact topology: the counts the
+ * old node map gave, id lookups both ways, the reverse edge index and a
+ * round trip through the binary graph format.
+ */
+class GraphTopologyTestCase : public TestCase
+{
+public:
+  GraphTopologyTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GraphTopologyTestCase::GraphTopologyTestCase ()
+  : TestCase ("Compact topology of the Cologne graph")
+{
+}
+
+void
+GraphTopologyTestCase::DoRun (void)
+{
+  Ptr<GraphData> data = GraphData::load (COLOGNE_GRAPH);
+  NS_TEST_ASSERT_MSG_NE (data, 0, "cannot load " << COLOGNE_GRAPH);
+  const GraphTopology& topology = data->getTopology ();
+
+  // the 360 edges to nodes missing from the file are skipped
+  NS_TEST_ASSERT_MSG_EQ (topology.getNodeCount (), 7415, "wrong node count");
+  NS_TEST_ASSERT_MSG_EQ (topology.getEdgeCount (), 20088, "wrong edge count");
+  NS_TEST_ASSERT_MSG_EQ (topology.getFirstEdge (0), 0, "rows must start at 0");
+  NS_TEST_ASSERT_MSG_EQ (topology.getLastEdge (topology.getNodeCount () - 1), topology.getEdgeCount (), "rows must end at the edge count");
+
+  for (uint32_t n = 0; n < topology.getNodeCount (); n++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (topology.find (topology.getId (n)), n, "find does not invert getId for node " << n);
+      for (uint32_t e = topology.getFirstEdge (n); e < topology.getLastEdge (n); e++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (topology.getEdgeSource (e), n, "edge " << e << " is not in the row of its source");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (topology.find ("no such node"), GraphTopology::NONE, "unknown id found");
+
+  for (uint32_t e = 0; e < topology.getEdgeCount (); e++)
+    {
+      uint32_t source = topology.getEdgeSource (e);
+      uint32_t target = topology.getEdgeTarget (e);
+      uint32_t reverse = topology.getReverseEdge (e);
+      NS_TEST_ASSERT_MSG_EQ (reverse, topology.findEdge (target, source), "wrong reverse of edge " << e);
+      if (reverse != GraphTopology::NONE)
+        {
+          NS_TEST_ASSERT_MSG_EQ (topology.getReverseEdge (reverse), e, "reverse of edge " << e << " is not symmetric");
+          NS_TEST_ASSERT_MSG_EQ (topology.getEdgeSource (reverse), target, "reverse of edge " << e << " starts elsewhere");
+          NS_TEST_ASSERT_MSG_EQ (topology.getEdgeTarget (reverse), source, "reverse of edge " << e << " ends elsewhere");
+        }
+    }
+
+  std::string file = CreateTempDirFilename ("cologne-center-graph.xml.bin");
+  NS_TEST_ASSERT_MSG_EQ (topology.save (file.c_str ()), true, "cannot save " << file);
+  GraphTopology mapped;
+  NS_TEST_ASSERT_MSG_EQ (mapped.open (file.c_str ()), true, "cannot map " << file);
+  NS_TEST_ASSERT_MSG_EQ (mapped.isMapped (), true, "binary graph not mapped");
+  NS_TEST_ASSERT_MSG_EQ (mapped.getNodeCount (), topology.getNodeCount (), "node count changed");
+  NS_TEST_ASSERT_MSG_EQ (mapped.getEdgeCount (), topology.getEdgeCount (), "edge count changed");
+  NS_TEST_ASSERT_MSG_EQ (mapped.getBase (), topology.getBase (), "base changed");
+  for (uint32_t n = 0; n < topology.getNodeCount (); n++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (mapped.getId (n), topology.getId (n), "id of node " << n << " changed");
+      NS_TEST_ASSERT_MSG_EQ (mapped.getX (n), topology.getX (n), "x of node " << n << " changed");
+      NS_TEST_ASSERT_MSG_EQ (mapped.getY (n), topology.getY (n), "y of node " << n << " changed");
+      NS_TEST_ASSERT_MSG_EQ (mapped.getFirstEdge (n), topology.getFirstEdge (n), "row of node " << n << " changed");
+      NS_TEST_ASSERT_MSG_EQ (mapped.find (topology.getId (n)), n, "id order of node " << n << " changed");
+    }
+  for (uint32_t e = 0; e < topology.getEdgeCount (); e++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (mapped.getEdgeSource (e), topology.getEdgeSource (e), "source of edge " << e << " changed");
+      NS_TEST_ASSERT_MSG_EQ (mapped.getEdgeTarget (e), topology.getEdgeTarget (e), "target of edge " << e << " changed");
+      NS_TEST_ASSERT_MSG_EQ (mapped.getReverseEdge (e), topology.getReverseEdge (e), "reverse of edge " << e << " changed");
+    }
+}
+
+/*
+ * Binary graph files whose arrays disagree with their header are rejected
+ * by GraphTopology::open, so GraphData parses the xml file instead.
+ */
+class GraphFileTestCase : public TestCase
+{
+public:
+  GraphFileTestCase ();
+
+private:
+  virtual void DoRun (void);
+  bool OpenCorrupted (const std::vector<char>& bytes, const uint32_t* array, uint32_t index, uint32_t value);
+};
+
+GraphFileTestCase::GraphFileTestCase ()
+  : TestCase ("Corrupt binary graph files are rejected")
+{
+}
+
+/*
+ * Writes the file with one element of the array, found by its contents,
+ * replaced by value, and tries to map it.
+ */
+bool
+GraphFileTestCase::OpenCorrupted (const std::vector<char>& bytes, const uint32_t* array, uint32_t index, uint32_t value)
+{
+  std::vector<char> corrupted (bytes);
+  for (size_t position = 0; position + 4 * sizeof (uint32_t) <= corrupted.size (); position += sizeof (uint32_t))
+    {
+      if (memcmp (&corrupted[position], array, 4 * sizeof (uint32_t)) == 0)
+        {
+          memcpy (&corrupted[position + index * sizeof (uint32_t)], &value, sizeof (uint32_t));
+          break;
+        }
+    }
+
+  std::string file = CreateTempDirFilename ("corrupted.bin");
+  FILE* out = fopen (file.c_str (), "wb");
+  fwrite (&corrupted[0], 1, corrupted.size (), out);
+  fclose (out);
+  GraphTopology topology;
+  return topology.open (file.c_str ());
+}
+
+void
+GraphFileTestCase::DoRun (void)
+{
+  // a - b - c, both ways
+  GraphTopology topology;
+  topology.addNode ("a", 0, 0);
+  topology.addNode ("b", 10, 0);
+  topology.addNode ("c", 20, 0);
+  topology.addEdge ("a", "b");
+  topology.addEdge ("b", "a");
+  topology.addEdge ("b", "c");
+  topology.addEdge ("c", "b");
+  topology.finalize ();
+
+  std::string file = CreateTempDirFilename ("path.bin");
+  NS_TEST_ASSERT_MSG_EQ (topology.save (file.c_str ()), true, "cannot save " << file);
+  std::vector<char> bytes;
+  FILE* in = fopen (file.c_str (), "rb");
+  NS_TEST_ASSERT_MSG_NE (in, 0, "cannot read " << file);
+  char buffer[256];
+  size_t read;
+  while ((read = fread (buffer, 1, sizeof (buffer), in)) > 0)
+    {
+      bytes.insert (bytes.end (), buffer, buffer + read);
+    }
+  fclose (in);
+
+  const uint32_t offsets[4] = {0, 1, 3, 4};
+  const uint32_t targets[4] = {1, 0, 2, 1};
+  const uint32_t sources[4] = {0, 1, 1, 2};
+  const uint32_t reverse[4] = {1, 0, 3, 2};
+  NS_TEST_ASSERT_MSG_EQ (OpenCorrupted (bytes, offsets, 0, 0), true, "an intact file is rejected");
+  NS_TEST_ASSERT_MSG_EQ (OpenCorrupted (bytes, offsets, 1, 4), false, "decreasing rows accepted");
+  NS_TEST_ASSERT_MSG_EQ (OpenCorrupted (bytes, targets, 2, 3), false, "target beyond the nodes accepted");
+  NS_TEST_ASSERT_MSG_EQ (OpenCorrupted (bytes, sources, 3, 7), false, "source beyond the nodes accepted");
+  NS_TEST_ASSERT_MSG_EQ (OpenCorrupted (bytes, reverse, 1, 4), false, "reverse beyond the edges accepted");
+
+  bytes.resize (bytes.size () - 1);
+  NS_TEST_ASSERT_MSG_EQ (OpenCorrupted (bytes, offsets, 0, 0), false, "truncated file accepted");
+}
+
+/*
+ * Nearest node queries of a Graph answered by the node grid against a scan
+ * of every node: the nearest node with the root winning ties, the k
+ * nearest and the nodes within a radius, for points inside and around the
+ * Cologne graph and on its nodes.
+ */
+class NearestNodeTestCase : public TestCase
+{
+public:
+  NearestNodeTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NearestNodeTestCase::NearestNodeTestCase ()
+  : TestCase ("Nearest node queries match a scan of every node")
+{
+}
+
+void
+NearestNodeTestCase::DoRun (void)
+{
+  Graph graph ("random");
+  graph.load ((char*) COLOGNE_GRAPH);
+  const GraphTopology& topology = graph.getTopology ();
+  uint32_t n = topology.getNodeCount ();
+  NS_TEST_ASSERT_MSG_GT (n, 0, "cannot load " << COLOGNE_GRAPH);
+
+  double minX = topology.getX (0), maxX = minX, minY = topology.getY (0), maxY = minY;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      minX = std::min (minX, topology.getX (i));
+      maxX = std::max (maxX, topology.getX (i));
+      minY = std::min (minY, topology.getY (i));
+      maxY = std::max (maxY, topology.getY (i));
+    }
+
+  // nodes sharing their position with one of lower handle, for ties
+  std::vector<std::pair<std::pair<double, double>, uint32_t> > positions;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      positions.push_back (std::make_pair (std::make_pair (topology.getX (i), topology.getY (i)), i));
+    }
+  std::sort (positions.begin (), positions.end ());
+  std::vector<uint32_t> shared;
+  for (uint32_t i = 1; i < n; i++)
+    {
+      if (positions[i].first == positions[i - 1].first)
+        {
+          shared.push_back (positions[i].second);
+        }
+    }
+  NS_TEST_ASSERT_MSG_GT (shared.size (), 0, "no nodes share a position");
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (3);
+  std::vector<std::pair<double, uint32_t> > nodes (n);
+  for (int q = 0; q < 2000; q++)
+    {
+      // every fourth query on a node, some beyond the graph, and every
+      // tenth on a shared position, half the time with the root there
+      double x = random->GetValue (minX - 200, maxX + 200);
+      double y = random->GetValue (minY - 200, maxY + 200);
+      if (q % 4 == 0)
+        {
+          uint32_t node = random->GetInteger (0, n - 1);
+          x = topology.getX (node);
+          y = topology.getY (node);
+        }
+      if (q % 10 == 0)
+        {
+          uint32_t node = shared[random->GetInteger (0, shared.size () - 1)];
+          graph.setRoot (graph.getNode (q % 20 == 0 ? node : random->GetInteger (0, n - 1)));
+          x = topology.getX (node);
+          y = topology.getY (node);
+        }
+
+      for (uint32_t i = 0; i < n; i++)
+        {
+          double dx = topology.getX (i) - x;
+          double dy = topology.getY (i) - y;
+          nodes[i] = std::make_pair (dx * dx + dy * dy, i);
+        }
+      std::sort (nodes.begin (), nodes.end ());
+
+      uint32_t root = graph.getRoot ().getIndex ();
+      uint32_t nearest = nodes[0].second;
+      // the root wins a tie, other ties go to the lowest handle
+      for (uint32_t i = 0; i < n && nodes[i].first == nodes[0].first; i++)
+        {
+          nearest = nodes[i].second == root ? root : nearest;
+        }
+      NS_TEST_ASSERT_MSG_EQ (graph.findNearest (x, y).getIndex (), nearest, "nearest node to (" << x << "," << y << ")");
+
+      int k = random->GetInteger (1, 12);
+      std::vector<GraphNode> found = graph.findNearest (x, y, k);
+      NS_TEST_ASSERT_MSG_EQ (found.size (), (size_t) k, k << " nearest nodes to (" << x << "," << y << ")");
+      for (int i = 0; i < k; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (found[i].getIndex (), nodes[i].second, "nearest node " << i << " of " << k << " to (" << x << "," << y << ")");
+        }
+
+      double radius = random->GetValue (0, 300);
+      std::vector<uint32_t> within;
+      for (uint32_t i = 0; i < n && nodes[i].first <= radius * radius; i++)
+        {
+          within.push_back (nodes[i].second);
+        }
+      std::sort (within.begin (), within.end ());
+      found = graph.findWithin (x, y, radius);
+      NS_TEST_ASSERT_MSG_EQ (found.size (), within.size (), "nodes within " << radius << " m of (" << x << "," << y << ")");
+      for (uint32_t i = 0; i < within.size (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (found[i].getIndex (), within[i], "node " << i << " within " << radius << " m of (" << x << "," << y << ")");
+        }
+    }
+}
+
+/* Whether p1 p2 crosses any edge, tested edge by edge as the old node map did. */
+static bool
+CrossesAnyEdge (const GraphTopology& topology, Vector p1, Vector p2)
+{
+  for (uint32_t e = 0; e < topology.getEdgeCount (); e++)
+    {
+      uint32_t from = topology.getEdgeSource (e);
+      uint32_t to = topology.getEdgeTarget (e);
+      Vector q1 (topology.getX (from), topology.getY (from), 0);
+      Vector q2 (topology.getX (to), topology.getY (to), 0);
+      if (Util::linesegmentsIntersect (p1, p2, q1, q2))
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+/*
+ * Segment queries of the edge grid against the edge by edge test: random
+ * segments, segments within the metre of padding around street ends,
+ * segments on and ending at cell borders, and the same after streets are
+ * inserted.
+ */
+class EdgeGridTestCase : public TestCase
+{
+public:
+  EdgeGridTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void CheckSegments (Ptr<GraphData> data, int count);
+
+  Ptr<UniformRandomVariable> m_random;
+};
+
+EdgeGridTestCase::EdgeGridTestCase ()
+  : TestCase ("Edge grid segment queries match the edge by edge test")
+{
+}
+
+void
+EdgeGridTestCase::CheckSegments (Ptr<GraphData> data, int count)
+{
+  const GraphTopology& topology = data->getTopology ();
+  const EdgeGrid& grid = data->getEdgeGrid ();
+  double minX = topology.getX (0), maxX = minX, minY = topology.getY (0), maxY = minY;
+  for (uint32_t i = 0; i < topology.getNodeCount (); i++)
+    {
+      minX = std::min (minX, topology.getX (i));
+      maxX = std::max (maxX, topology.getX (i));
+      minY = std::min (minY, topology.getY (i));
+      maxY = std::max (maxY, topology.getY (i));
+    }
+  double cellSize = grid.getCellSize ();
+
+  // edges ending within the padding of a cell border
+  std::vector<uint32_t> borderEdges;
+  for (uint32_t e = 0; e < topology.getEdgeCount (); e++)
+    {
+      double x = std::fmod (topology.getX (topology.getEdgeTarget (e)) - minX, cellSize);
+      double y = std::fmod (topology.getY (topology.getEdgeTarget (e)) - minY, cellSize);
+      if (std::min (x, cellSize - x) < 1 || std::min (y, cellSize - y) < 1)
+        {
+          borderEdges.push_back (e);
+        }
+    }
+  NS_TEST_ASSERT_MSG_GT (borderEdges.size (), 0, "no street ends next to a cell border");
+
+  int crossing = 0;
+  for (int q = 0; q < count; q++)
+    {
+      Vector p1 (m_random->GetValue (minX - 100, maxX + 100), m_random->GetValue (minY - 100, maxY + 100), 0);
+      double angle = m_random->GetValue (0, 2 * M_PI);
+      double length = m_random->GetValue (0, 400);
+      Vector p2 (p1.x + length * std::cos (angle), p1.y + length * std::sin (angle), 0);
+      uint32_t edge = m_random->GetInteger (0, topology.getEdgeCount () - 1);
+      uint32_t end = m_random->GetValue () < 0.5 ? topology.getEdgeSource (edge) : topology.getEdgeTarget (edge);
+      switch (q % 4)
+        {
+        case 1:
+          // short segments around a street end, in and beyond the padding
+          p1 = Vector (topology.getX (end) + m_random->GetValue (-2, 2), topology.getY (end) + m_random->GetValue (-2, 2), 0);
+          p2 = Vector (p1.x + m_random->GetValue (-2, 2), p1.y + m_random->GetValue (-2, 2), 0);
+          if (q % 8 == 1)
+            {
+              // across the line of a street just past its end near a cell
+              // border, which the rounded orientations take for a crossing
+              edge = borderEdges[m_random->GetInteger (0, borderEdges.size () - 1)];
+              Vector from (topology.getX (topology.getEdgeSource (edge)), topology.getY (topology.getEdgeSource (edge)), 0);
+              Vector to (topology.getX (topology.getEdgeTarget (edge)), topology.getY (topology.getEdgeTarget (edge)), 0);
+              double streetLength = std::max (CalculateDistance (from, to), 1.0);
+              double dx = (to.x - from.x) / streetLength;
+              double dy = (to.y - from.y) / streetLength;
+              double along = m_random->GetValue (0, 1);
+              double across = m_random->GetValue (-0.5, 0.5) / streetLength;
+              double span = m_random->GetValue (-1, 1);
+              p1 = Vector (to.x + along * dx - across * dy, to.y + along * dy + across * dx, 0);
+              p2 = Vector (p1.x - span * dy, p1.y + span * dx, 0);
+            }
+          break;
+        case 2:
+          // along a cell border, or ending on one
+          {
+            double x = minX + m_random->GetInteger (0, (maxX - minX) / cellSize + 1) * cellSize;
+            double y = minY + m_random->GetInteger (0, (maxY - minY) / cellSize + 1) * cellSize;
+            int border = m_random->GetInteger (0, 2);
+            if (border == 0)
+              {
+                p1.x = p2.x = x;
+              }
+            else if (border == 1)
+              {
+                p1.y = p2.y = y;
+              }
+            else
+              {
+                p2 = Vector (x, y, 0);
+              }
+          }
+          break;
+        case 3:
+          // from a street end, or a point on it
+          p1 = Vector (topology.getX (end), topology.getY (end), 0);
+          p2 = m_random->GetValue () < 0.2 ? p1 : p2;
+          break;
+        }
+
+      bool expected = CrossesAnyEdge (topology, p1, p2);
+      crossing += expected;
+      NS_TEST_ASSERT_MSG_EQ (grid.intersects (p1, p2), expected, "segment (" << p1.x << "," << p1.y << ")-(" << p2.x << "," << p2.y << ")");
+    }
+  NS_TEST_ASSERT_MSG_GT (crossing, count / 4, "too few segments cross a street");
+  NS_TEST_ASSERT_MSG_LT (crossing, count * 3 / 4, "too few segments miss every street");
+}
+
+void
+EdgeGridTestCase::DoRun (void)
+{
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (4);
+
+  // a copy of the Cologne graph, which can be changed
+  Ptr<GraphData> cologne = GraphData::load (COLOGNE_GRAPH);
+  NS_TEST_ASSERT_MSG_NE (cologne, 0, "cannot load " << COLOGNE_GRAPH);
+  std::vector<uint32_t> nodes;
+  for (uint32_t n = 0; n < cologne->getTopology ().getNodeCount (); n++)
+    {
+      nodes.push_back (n);
+    }
+  Ptr<GraphData> data = cologne->subgraph (nodes);
+  CheckSegments (data, 2000);
+
+  // streets added between the stored ones shift their handles
+  for (int i = 0; i < 50; i++)
+    {
+      AddChord (data, m_random->GetInteger (0, data->getTopology ().getEdgeCount () - 1));
+    }
+  NS_TEST_ASSERT_MSG_GT (data->getChangeCount (), 0, "no streets added");
+  CheckSegments (data, 2000);
+}
+
+/*
+ * Subgraphs of a copy of the Cologne graph: what a node set, a rectangle
+ * and the same rectangle as a polygon induce, and ids that stay readable
+ * once the subgraph is all that is left of its parent.
+ */
+class SubgraphTestCase : public TestCase
+{
+public:
+  SubgraphTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void CheckInduced (Ptr<GraphData> parent, Ptr<GraphData> subgraph);
+};
+
+SubgraphTestCase::SubgraphTestCase ()
+  : TestCase ("Subgraphs induce the edges of their nodes")
+{
+}
+
+/* Every edge of the parent between nodes of the subgraph is in it, with its reverse and state. */
+void
+SubgraphTestCase::CheckInduced (Ptr<GraphData> parent, Ptr<GraphData> subgraph)
+{
+  const GraphTopology& outer = parent->getTopology ();
+  const GraphTopology& inner = subgraph->getTopology ();
+  std::vector<uint32_t> nodes (outer.getNodeCount (), GraphTopology::NONE);
+  for (uint32_t i = 0; i < inner.getNodeCount (); i++)
+    {
+      uint32_t node = subgraph->getParentNode (i);
+      NS_TEST_ASSERT_MSG_EQ (inner.getId (i), outer.getId (node), "id of node " << i);
+      NS_TEST_ASSERT_MSG_EQ (inner.find (inner.getId (i)), i, "node " << i << " not found by its id");
+      NS_TEST_ASSERT_MSG_EQ (inner.getX (i), outer.getX (node), "position of node " << i);
+      NS_TEST_ASSERT_MSG_EQ (inner.getY (i), outer.getY (node), "position of node " << i);
+      nodes[node] = i;
+    }
+  // the parent's base if it is in, otherwise the lowest id as for a file without one
+  uint32_t base = nodes[outer.getBase ()];
+  bool lowest = base == GraphTopology::NONE;
+  for (uint32_t i = 0; i < inner.getNodeCount () && lowest; i++)
+    {
+      base = base == GraphTopology::NONE || inner.getId (i) < inner.getId (base) ? i : base;
+    }
+  NS_TEST_ASSERT_MSG_EQ (inner.getBase (), base, "base of the subgraph");
+
+  uint32_t induced = 0;
+  for (uint32_t e = 0; e < outer.getEdgeCount (); e++)
+    {
+      uint32_t from = nodes[outer.getEdgeSource (e)];
+      uint32_t to = nodes[outer.getEdgeTarget (e)];
+      if (from == GraphTopology::NONE || to == GraphTopology::NONE)
+        {
+          continue;
+        }
+      induced++;
+      uint32_t edge = inner.findEdge (from, to);
+      NS_TEST_ASSERT_MSG_NE (edge, GraphTopology::NONE, outer.getId (outer.getEdgeSource (e)) << "->" << outer.getId (outer.getEdgeTarget (e)) << " missing");
+      NS_TEST_ASSERT_MSG_EQ (inner.isOpen (edge), outer.isOpen (e), "state of edge " << edge);
+      uint32_t reverse = outer.getReverseEdge (e);
+      uint32_t expected = reverse == GraphTopology::NONE ? GraphTopology::NONE : inner.findEdge (to, from);
+      NS_TEST_ASSERT_MSG_EQ (inner.getReverseEdge (edge), expected, "reverse of edge " << edge);
+    }
+  NS_TEST_ASSERT_MSG_EQ (inner.getEdgeCount (), induced, "edges not induced by the nodes");
+}
+
+void
+SubgraphTestCase::DoRun (void)
+{
+  // a copy of the file, loaded and cached on its own
+  std::string file = CreateTempDirFilename ("cologne-center-graph.xml");
+  NS_TEST_ASSERT_MSG_EQ (CopyFile (COLOGNE_GRAPH, file), true, "cannot copy " << COLOGNE_GRAPH);
+  Ptr<GraphData> parent = GraphData::load (file);
+  NS_TEST_ASSERT_MSG_NE (parent, 0, "cannot load " << file);
+  const GraphTopology& topology = parent->getTopology ();
+  Region area = parent->spanningArea ();
+  double minX = std::min (area.getTopLeft ().x, area.getBottomRight ().x);
+  double maxX = std::max (area.getTopLeft ().x, area.getBottomRight ().x);
+  double minY = std::min (area.getTopLeft ().y, area.getBottomRight ().y);
+  double maxY = std::max (area.getTopLeft ().y, area.getBottomRight ().y);
+
+  // nothing beyond the graph
+  Ptr<GraphData> empty = parent->subgraph (Region (maxX + 10, maxY + 10, maxX + 100, maxY + 100));
+  NS_TEST_ASSERT_MSG_EQ (empty->getTopology ().getNodeCount (), 0, "nodes beyond the graph");
+  NS_TEST_ASSERT_MSG_EQ (empty->getTopology ().getBase (), GraphTopology::NONE, "base of an empty subgraph");
+  NS_TEST_ASSERT_MSG_EQ (parent->subgraph (std::vector<uint32_t> ())->getTopology ().getBase (), GraphTopology::NONE, "base of no nodes");
+
+  // some closed streets to carry over
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (5);
+  for (int i = 0; i < 100; i++)
+    {
+      parent->closeEdge (random->GetInteger (0, topology.getEdgeCount () - 1));
+    }
+
+  std::vector<uint32_t> nodes;
+  for (uint32_t n = 0; n < topology.getNodeCount (); n++)
+    {
+      if (random->GetValue () < 0.3)
+        {
+          nodes.push_back (n);
+        }
+    }
+  nodes.push_back (topology.getBase ());
+  CheckInduced (parent, parent->subgraph (nodes));
+
+  Ptr<GraphData> kept;
+  std::vector<std::string> ids;
+  for (int i = 0; i < 20; i++)
+    {
+      float x1 = random->GetValue (minX, maxX);
+      float x2 = random->GetValue (minX, maxX);
+      float y1 = random->GetValue (minY, maxY);
+      float y2 = random->GetValue (minY, maxY);
+      Ptr<GraphData> rectangle = parent->subgraph (Region (x1, y1, x2, y2));
+      std::vector<Vector> polygon;
+      polygon.push_back (Vector (x1, y1, 0));
+      polygon.push_back (Vector (x2, y1, 0));
+      polygon.push_back (Vector (x2, y2, 0));
+      polygon.push_back (Vector (x1, y2, 0));
+      Ptr<GraphData> outline = parent->subgraph (polygon);
+      CheckInduced (parent, rectangle);
+      NS_TEST_ASSERT_MSG_EQ (outline->getTopology ().getNodeCount (), rectangle->getTopology ().getNodeCount (), "polygon and rectangle " << i << " differ");
+      for (uint32_t n = 0; n < rectangle->getTopology ().getNodeCount (); n++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (outline->getParentNode (n), rectangle->getParentNode (n), "node " << n << " of polygon and rectangle " << i);
+        }
+      NS_TEST_ASSERT_MSG_EQ (outline->getTopology ().getEdgeCount (), rectangle->getTopology ().getEdgeCount (), "polygon and rectangle " << i << " differ");
+
+      if (kept == 0 || rectangle->getTopology ().getNodeCount () > kept->getTopology ().getNodeCount ())
+        {
+          kept = rectangle;
+        }
+    }
+  NS_TEST_ASSERT_MSG_GT (kept->getTopology ().getNodeCount (), 0, "all rectangles empty");
+  for (uint32_t n = 0; n < kept->getTopology ().getNodeCount (); n++)
+    {
+      ids.push_back (topology.getId (kept->getParentNode (n)));
+    }
+
+  // the closed streets took the parent out of the cache, so the subgraph
+  // now holds the only reference to it and its string table
+  NS_TEST_ASSERT_MSG_NE (GraphData::load (file), parent, "changed graph still cached");
+  parent = 0;
+  // allocations that would reuse a freed string table
+  std::vector<std::string> garbage (1000, std::string (64, 'x'));
+  for (uint32_t n = 0; n < ids.size (); n++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (kept->getTopology ().getId (n), ids[n], "id of node " << n << " after the parent is dropped");
+      NS_TEST_ASSERT_MSG_EQ (kept->getTopology ().find (ids[n]), n, "node " << n << " not found after the parent is dropped");
+    }
+}
+
+/*
+ * Trajectory samples off the road count as deviation whether they fall in
+ * the grid or beyond the road network it spans.
+ */
+class CoverageGridTestCase : public TestCase
+{
+public:
+  CoverageGridTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+CoverageGridTestCase::CoverageGridTestCase ()
+  : TestCase ("Coverage grid counts visits inside and outside its area")
+{
+}
+
+void
+CoverageGridTestCase::DoRun (void)
+{
+  // 10 x 5 cells of 10 m, with a road along the first row
+  CoverageGrid cells (Region (100, 200, 195, 245), 10, 10);
+  NS_TEST_ASSERT_MSG_EQ (cells.getCellCount (), 50, "wrong cell count");
+  cells.markRoad (100, 205, 195, 205);
+  NS_TEST_ASSERT_MSG_EQ (cells.count (1), 10, "wrong road cell count");
+
+  cells.visit (Vector (105, 205, 0));  // road
+  cells.visit (Vector (106, 206, 0));  // same road cell
+  cells.visit (Vector (105, 225, 0));  // off the road
+  cells.visit (Vector (50, 205, 0));   // beyond the area
+  cells.visit (Vector (52, 207, 0));   // same cell beyond the area
+  cells.visit (Vector (300, 400, 0));  // another one
+  NS_TEST_ASSERT_MSG_EQ (cells.count (2), 1, "wrong visited road count");
+  NS_TEST_ASSERT_MSG_EQ (cells.count (3), 3, "visits off the road or outside the area not counted");
+  NS_TEST_ASSERT_MSG_EQ (cells.count (1), 9, "wrong unvisited road count");
+  NS_TEST_ASSERT_MSG_EQ (cells.getCells (3).size (), 3, "cells visited off the road not listed");
+}
+
+/*
+ * Three neighbouring territories of a partition of the Cologne graph lend
+ * edges near their shared nodes while away, never past the busiest home
+ * territory, and take every edge back on return.
+ */
+class TerritoryMapTestCase : public TestCase
+{
+public:
+  TerritoryMapTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void CheckLent (Ptr<TerritoryMap> map, uint32_t territory, int depth, double largestLoad);
+  void CheckHome (Ptr<TerritoryMap> map);
+};
+
+TerritoryMapTestCase::TerritoryMapTestCase ()
+  : TestCase ("Territories lend edges near their neighbours and reclaim them")
+{
+}
+
+/*
+ * Every edge away from its owner belongs to the absent territory and
+ * starts or ends within depth hops, over its home edges, of a node it
+ * shares with a present territory.
+ */
+void
+TerritoryMapTestCase::CheckLent (Ptr<TerritoryMap> map, uint32_t territory, int depth, double largestLoad)
+{
+  const GraphTopology& topology = map->getData ()->getTopology ();
+  std::vector<int> hops (topology.getNodeCount (), -1);
+  std::vector<uint32_t> frontier;
+  for (uint32_t e = 0; e < topology.getEdgeCount (); e++)
+    {
+      uint32_t node = topology.getEdgeSource (e);
+      uint32_t owner = map->getHome (e);
+      if (owner != GraphTopology::NONE && owner != territory && map->isPresent (owner) && hops[node] < 0)
+        {
+          hops[node] = 0;
+          frontier.push_back (node);
+        }
+    }
+  for (uint32_t i = 0; i < frontier.size (); i++)
+    {
+      uint32_t node = frontier[i];
+      for (uint32_t e = topology.getFirstEdge (node); e < topology.getLastEdge (node); e++)
+        {
+          uint32_t next = topology.getEdgeTarget (e);
+          bool home = map->getHome (e) == territory ||
+            (topology.getReverseEdge (e) != GraphTopology::NONE && map->getHome (topology.getReverseEdge (e)) == territory);
+          if (home && hops[next] < 0)
+            {
+              hops[next] = hops[node] + 1;
+              frontier.push_back (next);
+            }
+        }
+    }
+
+  uint32_t lent = 0;
+  for (uint32_t e = 0; e < topology.getEdgeCount (); e++)
+    {
+      if (map->getOwner (e) == map->getHome (e))
+        {
+          continue;
+        }
+      lent++;
+      NS_TEST_ASSERT_MSG_EQ (map->getHome (e), territory, "edge " << e << " lent by a present territory");
+      NS_TEST_ASSERT_MSG_EQ (map->isPresent (map->getOwner (e)), true, "edge " << e << " lent to an absent territory");
+      int source = hops[topology.getEdgeSource (e)];
+      int target = hops[topology.getEdgeTarget (e)];
+      bool near = (source >= 0 && source < depth) || (target >= 0 && target < depth);
+      NS_TEST_ASSERT_MSG_EQ (near, true, "edge " << e << " lent beyond " << depth << " hops");
+    }
+  NS_TEST_ASSERT_MSG_GT (lent, 0, "territory " << territory << " lent nothing");
+
+  for (uint32_t t = 0; t < map->getTerritoryCount (); t++)
+    {
+      if (map->isPresent (t))
+        {
+          NS_TEST_ASSERT_MSG_LT_OR_EQ (map->getLoad (t), largestLoad + 1e-6, "territory " << t << " borrowed past the largest home load");
+        }
+    }
+}
+
+void
+TerritoryMapTestCase::CheckHome (Ptr<TerritoryMap> map)
+{
+  const GraphTopology& topology = map->getData ()->getTopology ();
+  for (uint32_t e = 0; e < topology.getEdgeCount (); e++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (map->getOwner (e), map->getHome (e), "edge " << e << " not returned home");
+    }
+}
+
+void
+TerritoryMapTestCase::DoRun (void)
+{
+  Ptr<GraphData> data = GraphData::load (COLOGNE_GRAPH);
+  NS_TEST_ASSERT_MSG_NE (data, 0, "cannot load " << COLOGNE_GRAPH);
+  Ptr<TerritoryMap> map = Create<TerritoryMap> (data);
+  // two small territories next to each other and to a large one, so
+  // every one has a present neighbour with room to borrow
+  const char* territories[3] = {"g221.xml", "g64.xml", "g66.xml"};
+  for (int i = 0; i < 3; i++)
+    {
+      std::string file = std::string (COLOGNE_SUBGRAPHS) + territories[i];
+      Ptr<GraphData> subgraph = GraphData::load (file);
+      NS_TEST_ASSERT_MSG_NE (subgraph, 0, "cannot load " << file);
+      NS_TEST_ASSERT_MSG_EQ (map->addTerritory (subgraph), (uint32_t) i, "territories numbered out of order");
+      NS_TEST_ASSERT_MSG_GT (map->getEdgeCount (i), 0, file << " matches no edge of the full graph");
+    }
+
+  double largestLoad = 0;
+  std::vector<double> homeLoads;
+  for (uint32_t t = 0; t < map->getTerritoryCount (); t++)
+    {
+      homeLoads.push_back (map->getLoad (t));
+      largestLoad = std::max (largestLoad, map->getLoad (t));
+    }
+
+  int depth = 2;
+  map->setLendingDepth (depth);
+  for (uint32_t t = 0; t < map->getTerritoryCount (); t++)
+    {
+      map->setPresent (t, false);
+      CheckLent (map, t, depth, largestLoad);
+      map->setPresent (t, true);
+      CheckHome (map);
+    }
+
+  // borrowed edges go home before their borrower leaves in turn
+  map->setPresent (1, false);
+  map->setPresent (0, false);
+  map->setPresent (1, true);
+  CheckLent (map, 0, depth, largestLoad);
+  map->setPresent (0, true);
+  CheckHome (map);
+  for (uint32_t t = 0; t < map->getTerritoryCount (); t++)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL (map->getLoad (t), homeLoads[t], 1e-6, "load of territory " << t << " changed");
+    }
+}
+
+/*
+ * Two neighbouring territories leave one after the other: the edges the
+ * second had borrowed from the first go on to the present neighbours of
+ * the first instead of waiting for it.
+ */
+class TerritoryHandoverTestCase : public TestCase
+{
+public:
+  TerritoryHandoverTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void CheckAway (Ptr<TerritoryMap> map);
+};
+
+TerritoryHandoverTestCase::TerritoryHandoverTestCase ()
+  : TestCase ("Edges borrowed from an absent territory are lent on")
+{
+}
+
+/* Every edge away from home belongs to an absent territory and is owned by a present one. */
+void
+TerritoryHandoverTestCase::CheckAway (Ptr<TerritoryMap> map)
+{
+  const GraphTopology& topology = map->getData ()->getTopology ();
+  for (uint32_t e = 0; e < topology.getEdgeCount (); e++)
+    {
+      if (map->getOwner (e) != map->getHome (e))
+        {
+          NS_TEST_ASSERT_MSG_EQ (map->isPresent (map->getHome (e)), false, "edge " << e << " lent by a present territory");
+          NS_TEST_ASSERT_MSG_EQ (map->isPresent (map->getOwner (e)), true, "edge " << e << " lent to an absent territory");
+        }
+    }
+}
+
+void
+TerritoryHandoverTestCase::DoRun (void)
+{
+  Ptr<GraphData> data = GraphData::load (COLOGNE_GRAPH);
+  NS_TEST_ASSERT_MSG_NE (data, 0, "cannot load " << COLOGNE_GRAPH);
+  const GraphTopology& topology = data->getTopology ();
+  // the whole partition, so neighbours have room to borrow under the
+  // largest territory
+  Ptr<TerritoryMap> map = Create<TerritoryMap> (data);
+  for (uint32_t i = 0; i < 290; i++)
+    {
+      std::ostringstream file;
+      file << COLOGNE_SUBGRAPHS << "g" << i << ".xml";
+      Ptr<GraphData> subgraph = GraphData::load (file.str ());
+      NS_TEST_ASSERT_MSG_NE (subgraph, 0, "cannot load " << file.str ());
+      map->addTerritory (subgraph);
+    }
+  map->setLendingDepth (2);
+
+  // the neighbour that borrowed most from the first to leave leaves next
+  uint32_t first = 4;
+  map->setPresent (first, false);
+  CheckAway (map);
+  std::vector<uint32_t> borrowedCounts (map->getTerritoryCount (), 0);
+  for (uint32_t e = 0; e < topology.getEdgeCount (); e++)
+    {
+      if (map->getHome (e) == first && map->getOwner (e) != first)
+        {
+          borrowedCounts[map->getOwner (e)]++;
+        }
+    }
+  uint32_t second = std::max_element (borrowedCounts.begin (), borrowedCounts.end ()) - borrowedCounts.begin ();
+  NS_TEST_ASSERT_MSG_GT (borrowedCounts[second], 0, "territory " << first << " lent nothing");
+  std::vector<uint32_t> borrowed;
+  for (uint32_t e = 0; e < topology.getEdgeCount (); e++)
+    {
+      if (map->getHome (e) == first && map->getOwner (e) == second)
+        {
+          borrowed.push_back (e);
+        }
+    }
+
+  map->setPresent (second, false);
+  CheckAway (map);
+  uint32_t lentOn = 0;
+  for (uint32_t i = 0; i < borrowed.size (); i++)
+    {
+      lentOn += map->getOwner (borrowed[i]) != first ? 1 : 0;
+    }
+  NS_TEST_ASSERT_MSG_GT (lentOn, 0, "edges borrowed from " << first << " went back to it while it is away");
+
+  // the first back takes its edges from whoever holds them
+  map->setPresent (first, true);
+  CheckAway (map);
+  map->setPresent (second, true);
+  for (uint32_t e = 0; e < topology.getEdgeCount (); e++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (map->getOwner (e), map->getHome (e), "edge " << e << " not returned home");
+    }
+}
+
+/*
+ * Graphs sharing a visit blackboard, one of them collecting rarely while
+ * the others publish well past the log size that triggers a trim: every
+ * Graph that collects holds the fleet-wide largest count of each edge.
+ */
+class VisitBlackboardTestCase : public TestCase
+{
+public:
+  VisitBlackboardTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VisitBlackboardTestCase::VisitBlackboardTestCase ()
+  : TestCase ("Visit blackboard keeps lagging Graphs up to date")
+{
+}
+
+void
+VisitBlackboardTestCase::DoRun (void)
+{
+  std::string file = std::string (COLOGNE_SUBGRAPHS) + "g5.xml";
+  Ptr<GraphData> data = GraphData::load (file);
+  NS_TEST_ASSERT_MSG_NE (data, 0, "cannot load " << file);
+  const GraphTopology& topology = data->getTopology ();
+  uint32_t m = topology.getEdgeCount ();
+
+  Ptr<VisitBlackboard> board = Create<VisitBlackboard> (data);
+  Graph first ("random");
+  Graph second ("random");
+  Graph lagging ("random");
+  Graph* graphs[3] = {&first, &second, &lagging};
+  // the counts each Graph should hold, and the largest published
+  std::vector<std::vector<int> > counts (3, std::vector<int> (m, 0));
+  std::vector<int> fleet (m, 0);
+  for (int g = 0; g < 3; g++)
+    {
+      graphs[g]->load (data);
+      NS_TEST_ASSERT_MSG_EQ (graphs[g]->shareVisits (board), true, "cannot share visits");
+    }
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (8);
+  // two entries a visit: the log passes its first trim size about five times
+  uint32_t steps = 5 * (m + 1024) / 2;
+  for (uint32_t i = 0; i < steps; i++)
+    {
+      // the third Graph visits and collects twenty times less often
+      int g = random->GetInteger (0, 20) < 20 ? random->GetInteger (0, 1) : 2;
+      uint32_t edge = random->GetInteger (0, m - 1);
+      if (random->GetValue () < 0.1)
+        {
+          graphs[g]->next (topology.getEdgeSource (edge));
+          for (uint32_t e = 0; e < m; e++)
+            {
+              counts[g][e] = std::max (counts[g][e], fleet[e]);
+            }
+          continue;
+        }
+
+      graphs[g]->markEdge (topology.getEdgeSource (edge), topology.getEdgeTarget (edge), i);
+      uint32_t street[2] = {edge, topology.getReverseEdge (edge)};
+      for (int j = 0; j < 2 && street[j] != GraphTopology::NONE; j++)
+        {
+          counts[g][street[j]]++;
+          fleet[street[j]] = std::max (fleet[street[j]], counts[g][street[j]]);
+        }
+      NS_TEST_ASSERT_MSG_EQ (graphs[g]->getEdgeVisitCount (edge), counts[g][edge], "count of Graph " << g << " after " << i << " steps");
+    }
+
+  for (int g = 0; g < 3; g++)
+    {
+      graphs[g]->next (topology.getEdgeSource (0));
+      for (uint32_t e = 0; e < m; e++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (graphs[g]->getEdgeVisitCount (e), fleet[e], "Graph " << g << " behind on edge " << e);
+          NS_TEST_ASSERT_MSG_EQ (board->getCount (e), fleet[e], "board behind on edge " << e);
+        }
+    }
+}
+
+/*
+ * The indexed heap of GlobalLeastVisitedSelection against a plain list of
+ * keys, and Graphs using the selection on a territory: they fly a shortest
+ * path to the street visited longest ago, and turn to the next one when
+ * another UAV visits it first.
+ */
+class GlobalLeastVisitedTestCase : public TestCase
+{
+public:
+  GlobalLeastVisitedTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void CheckQueue (Ptr<UniformRandomVariable> random);
+  double Walk (Graph& graph, const GraphTopology& topology, uint32_t& node, double& time, uint32_t street);
+  double GetDistance (const GraphTopology& topology, uint32_t node, uint32_t street);
+};
+
+GlobalLeastVisitedTestCase::GlobalLeastVisitedTestCase ()
+  : TestCase ("Global least visited selection heads for the most idle street")
+{
+}
+
+/* Updates and insertions keep the top of the queue at the smallest key, lowest handle first. */
+void
+GlobalLeastVisitedTestCase::CheckQueue (Ptr<UniformRandomVariable> random)
+{
+  EdgeQueue queue;
+  std::vector<double> keys (50, 0);
+  queue.build (keys.size (), 0);
+  for (int i = 0; i < 2000; i++)
+    {
+      // few distinct keys, so ties are common
+      double key = random->GetInteger (0, 9);
+      if (random->GetValue () < 0.8)
+        {
+          uint32_t edge = random->GetInteger (0, keys.size () - 1);
+          queue.update (edge, key);
+          keys[edge] = key;
+        }
+      else
+        {
+          uint32_t edge = random->GetInteger (0, keys.size ());
+          queue.insert (edge, key);
+          keys.insert (keys.begin () + edge, key);
+        }
+
+      uint32_t top = std::min_element (keys.begin (), keys.end ()) - keys.begin ();
+      NS_TEST_ASSERT_MSG_EQ (queue.top (), top, "top of the queue after " << i << " changes");
+      NS_TEST_ASSERT_MSG_EQ (queue.topKey (), keys[top], "top key after " << i << " changes");
+      for (uint32_t e = 0; e < keys.size (); e++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (queue.getKey (e), keys[e], "key of edge " << e << " after " << i << " changes");
+        }
+    }
+}
+
+/*
+ * Steps the Graph from node, marking every edge as GraphMobilityModel
+ * does, until it crosses street either way. Returns the length flown
+ * before the crossing, or -1 if it left the open edges or never crossed.
+ */
+double
+GlobalLeastVisitedTestCase::Walk (Graph& graph, const GraphTopology& topology, uint32_t& node, double& time, uint32_t street)
+{
+  double length = 0;
+  for (uint32_t i = 0; i < topology.getEdgeCount (); i++)
+    {
+      uint32_t next = graph.next (node);
+      uint32_t edge = topology.findEdge (node, next);
+      if (edge == GraphTopology::NONE || !topology.isOpen (edge))
+        {
+          return -1;
+        }
+      time += 10;
+      graph.markEdge (node, next, time);
+      node = next;
+      if (edge == street || edge == topology.getReverseEdge (street))
+        {
+          return length;
+        }
+      double dx = topology.getX (next) - topology.getX (topology.getEdgeSource (edge));
+      double dy = topology.getY (next) - topology.getY (topology.getEdgeSource (edge));
+      length += std::sqrt (dx * dx + dy * dy);
+    }
+  return -1;
+}
+
+/* Length of the shortest path from node to either end a street can be crossed from. */
+double
+GlobalLeastVisitedTestCase::GetDistance (const GraphTopology& topology, uint32_t node, uint32_t street)
+{
+  Router router;
+  std::vector<uint32_t> path;
+  double distance = router.route (topology, node, topology.getEdgeSource (street), path);
+  uint32_t reverse = topology.getReverseEdge (street);
+  if (reverse != GraphTopology::NONE)
+    {
+      distance = std::min (distance, router.route (topology, node, topology.getEdgeSource (reverse), path));
+    }
+  return distance;
+}
+
+void
+GlobalLeastVisitedTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (7);
+  CheckQueue (random);
+
+  std::string file = std::string (COLOGNE_SUBGRAPHS) + "g5.xml";
+  Ptr<GraphData> data = GraphData::load (file);
+  NS_TEST_ASSERT_MSG_NE (data, 0, "cannot load " << file);
+  const GraphTopology& topology = data->getTopology ();
+  std::vector<uint32_t> streets;
+  for (uint32_t e = 0; e < topology.getEdgeCount (); e++)
+    {
+      if (topology.getReverseEdge (e) == GraphTopology::NONE || topology.getReverseEdge (e) > e)
+        {
+          streets.push_back (e);
+        }
+    }
+
+  // the street visited longest ago, the one after it far away, and a
+  // third one the UAV turns to when the second is visited by another
+  Graph walker ("globalleastvisited");
+  Graph other ("globalleastvisited");
+  walker.load (data);
+  other.load (data);
+  uint32_t root = walker.getRoot ().getIndex ();
+  uint32_t oldest[3];
+  oldest[0] = streets[random->GetInteger (0, streets.size () - 1)];
+  oldest[1] = oldest[0];
+  for (uint32_t i = 0; i < streets.size (); i++)
+    {
+      double distance = GetDistance (topology, topology.getEdgeTarget (oldest[0]), streets[i]);
+      if (!std::isinf (distance) && distance > GetDistance (topology, topology.getEdgeTarget (oldest[0]), oldest[1]))
+        {
+          oldest[1] = streets[i];
+        }
+    }
+  do
+    {
+      oldest[2] = streets[random->GetInteger (0, streets.size () - 1)];
+    }
+  while (oldest[2] == oldest[0] || oldest[2] == oldest[1] || std::isinf (GetDistance (topology, root, oldest[2])));
+
+  Ptr<VisitBlackboard> board = Create<VisitBlackboard> (data);
+  NS_TEST_ASSERT_MSG_EQ (walker.shareVisits (board), true, "cannot share visits");
+  NS_TEST_ASSERT_MSG_EQ (other.shareVisits (board), true, "cannot share visits");
+  for (uint32_t i = 0; i < streets.size (); i++)
+    {
+      uint32_t street = streets[i];
+      double time = 10 + i;
+      for (int j = 0; j < 3; j++)
+        {
+          time = street == oldest[j] ? j + 1 : time;
+        }
+      other.markEdge (topology.getEdgeSource (street), topology.getEdgeTarget (street), time);
+    }
+
+  uint32_t node = root;
+  double time = 1000;
+  double distance = GetDistance (topology, node, oldest[0]);
+  double length = Walk (walker, topology, node, time, oldest[0]);
+  NS_TEST_ASSERT_MSG_EQ_TOL (length, distance, 1e-6, "oldest street not reached along a shortest path");
+
+  // one step towards the second, which the other UAV then visits
+  uint32_t next = walker.next (node);
+  uint32_t edge = topology.findEdge (node, next);
+  NS_TEST_ASSERT_MSG_NE (edge, GraphTopology::NONE, "walked off the streets");
+  NS_TEST_ASSERT_MSG_EQ (edge == oldest[1] || edge == topology.getReverseEdge (oldest[1]), false, "second street next to the first");
+  walker.markEdge (node, next, time += 10);
+  node = next;
+  other.markEdge (topology.getEdgeSource (oldest[1]), topology.getEdgeTarget (oldest[1]), time);
+
+  distance = GetDistance (topology, node, oldest[2]);
+  length = Walk (walker, topology, node, time, oldest[2]);
+  NS_TEST_ASSERT_MSG_EQ_TOL (length, distance, 1e-6, "no new route after the other UAV's visit");
+}
+
+/*
+ * The scores a LookaheadSelection keeps between decisions, dropped in
+ * part on every visit, closure and addition, match those of a selection
+ * reset after the change, on a territory and on the whole Cologne graph.
+ */
+class LookaheadSelectionTestCase : public TestCase
+{
+public:
+  LookaheadSelectionTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void CheckGraph (Ptr<GraphData> data, int depth);
+  void FollowChanges (Ptr<GraphData> data, LookaheadSelection& selection);
+  void CheckScores (Ptr<GraphData> data, LookaheadSelection& selection, int depth);
+
+  std::vector<EdgeStats> m_stats;
+  uint32_t m_changesSeen;
+  Ptr<UniformRandomVariable> m_random;
+};
+
+LookaheadSelectionTestCase::LookaheadSelectionTestCase ()
+  : TestCase ("Lookahead scores kept between decisions match fresh ones")
+{
+}
+
+/*
+ * Follows the changes of the data as Graph does: the selection indexes the
+ * topology as it is now, so logged handles move up with later additions.
+ */
+void
+LookaheadSelectionTestCase::FollowChanges (Ptr<GraphData> data, LookaheadSelection& selection)
+{
+  std::vector<uint32_t> changed;
+  std::vector<uint32_t> added;
+  for (; m_changesSeen < data->getChangeCount (); m_changesSeen++)
+    {
+      const GraphChange& change = data->getChange (m_changesSeen);
+      if (change.type != EDGE_ADDED)
+        {
+          changed.push_back (change.edge);
+          continue;
+        }
+      m_stats.insert (m_stats.begin () + change.edge, EdgeStats ());
+      for (uint32_t i = 0; i < changed.size (); i++)
+        {
+          changed[i] += changed[i] >= change.edge ? 1 : 0;
+        }
+      for (uint32_t i = 0; i < added.size (); i++)
+        {
+          added[i] += added[i] >= change.edge ? 1 : 0;
+        }
+      added.push_back (change.edge);
+    }
+  std::sort (added.begin (), added.end ());
+  selection.insert (added);
+  for (uint32_t i = 0; i < changed.size (); i++)
+    {
+      selection.update (changed[i], m_stats[changed[i]]);
+    }
+}
+
+/* Decides at random nodes with both selections and compares the scores of every open edge. */
+void
+LookaheadSelectionTestCase::CheckScores (Ptr<GraphData> data, LookaheadSelection& selection, int depth)
+{
+  const GraphTopology& topology = data->getTopology ();
+  LookaheadSelection fresh;
+  fresh.reset (topology, depth);
+  for (uint32_t e = 0; e < m_stats.size (); e++)
+    {
+      if (m_stats[e].visits > 0)
+        {
+          fresh.update (e, m_stats[e]);
+        }
+    }
+
+  for (int i = 0; i < 100; i++)
+    {
+      uint32_t node = m_random->GetInteger (0, topology.getNodeCount () - 1);
+      if (topology.getOpenDegree (node) == 0)
+        {
+          continue;
+        }
+      selection.select (topology, m_stats, *m_random, node);
+      fresh.select (topology, m_stats, *m_random, node);
+      for (uint32_t e = topology.getFirstEdge (node); e < topology.getLastEdge (node); e++)
+        {
+          if (topology.isOpen (e))
+            {
+              NS_TEST_ASSERT_MSG_EQ_TOL (selection.getScore (e), fresh.getScore (e), 1e-6, "stale score of edge " << e << " at depth " << depth);
+            }
+        }
+    }
+}
+
+void
+LookaheadSelectionTestCase::CheckGraph (Ptr<GraphData> data, int depth)
+{
+  const GraphTopology& topology = data->getTopology ();
+  m_stats.assign (topology.getEdgeCount (), EdgeStats ());
+  m_changesSeen = data->getChangeCount ();
+  LookaheadSelection selection;
+  selection.reset (topology, depth);
+  CheckScores (data, selection, depth);
+
+  double time = 0;
+  for (int round = 0; round < 20; round++)
+    {
+      // visits along a walk of the selection itself, then one change
+      uint32_t node = m_random->GetInteger (0, topology.getNodeCount () - 1);
+      for (int i = 0; i < 50 && topology.getOpenDegree (node) > 0; i++)
+        {
+          uint32_t next = selection.select (topology, m_stats, *m_random, node);
+          uint32_t edge = topology.findEdge (node, next);
+          time += 10;
+          m_stats[edge].count++;
+          m_stats[edge].visits++;
+          m_stats[edge].lastVisit = time;
+          selection.update (edge, m_stats[edge]);
+          node = next;
+        }
+      CheckScores (data, selection, depth);
+
+      uint32_t edge = m_random->GetInteger (0, topology.getEdgeCount () - 1);
+      switch (round % 3)
+        {
+        case 0:
+          data->closeEdge (edge);
+          break;
+        case 1:
+          AddChord (data, edge);
+          break;
+        default:
+          data->openEdge (edge);
+          for (int i = 0; i < 3; i++)
+            {
+              data->openEdge (m_random->GetInteger (0, topology.getEdgeCount () - 1));
+            }
+        }
+      FollowChanges (data, selection);
+      CheckScores (data, selection, depth);
+    }
+
+  NS_TEST_ASSERT_MSG_GT (selection.getDecisions (), 0, "decisions not counted");
+  NS_TEST_ASSERT_MSG_GT (selection.getAverageLatency (), 0, "latency not timed");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (selection.getWorstLatency (), selection.getAverageLatency (), "worst latency below the average");
+}
+
+void
+LookaheadSelectionTestCase::DoRun (void)
+{
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (6);
+
+  // copies, so the changes stay out of the other tests
+  std::string file = std::string (COLOGNE_SUBGRAPHS) + "g5.xml";
+  const char* files[2] = {file.c_str (), COLOGNE_GRAPH};
+  int depths[2] = {4, 6};
+  for (int f = 0; f < 2; f++)
+    {
+      Ptr<GraphData> loaded = GraphData::load (files[f]);
+      NS_TEST_ASSERT_MSG_NE (loaded, 0, "cannot load " << files[f]);
+      std::vector<uint32_t> nodes;
+      for (uint32_t n = 0; n < loaded->getTopology ().getNodeCount (); n++)
+        {
+          nodes.push_back (n);
+        }
+      for (int d = 0; d < 2; d++)
+        {
+          CheckGraph (loaded->subgraph (nodes), depths[d]);
+        }
+    }
+}
+
+/*
+ * Routes over a contraction hierarchy of the Cologne graph match A* on
+ * random node pairs, and their unpacked shortcuts are real edges.
+ */
+class ContractionHierarchyTestCase : public TestCase
+{
+public:
+  ContractionHierarchyTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+ContractionHierarchyTestCase::ContractionHierarchyTestCase ()
+  : TestCase ("Contraction hierarchy routes match A*")
+{
+}
+
+void
+ContractionHierarchyTestCase::DoRun (void)
+{
+  Ptr<GraphData> data = GraphData::load (COLOGNE_GRAPH);
+  NS_TEST_ASSERT_MSG_NE (data, 0, "cannot load " << COLOGNE_GRAPH);
+  const GraphTopology& topology = data->getTopology ();
+  ContractionHierarchy hierarchy;
+  hierarchy.build (topology);
+  NS_TEST_ASSERT_MSG_EQ (hierarchy.isBuilt (), true, "hierarchy not built");
+  NS_TEST_ASSERT_MSG_EQ (hierarchy.getNodeCount (), topology.getNodeCount (), "hierarchy of another graph");
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+  Router router;
+  std::vector<uint32_t> path;
+  std::vector<uint32_t> expected;
+  uint32_t reachable = 0;
+  for (int i = 0; i < 1000; i++)
+    {
+      uint32_t from = random->GetInteger (0, topology.getNodeCount () - 1);
+      uint32_t to = random->GetInteger (0, topology.getNodeCount () - 1);
+      double distance = router.route (hierarchy, from, to, path);
+      double shortest = router.route (topology, from, to, expected);
+      if (std::isinf (shortest))
+        {
+          NS_TEST_ASSERT_MSG_EQ (std::isinf (distance), true, "hierarchy reaches " << to << " from " << from);
+          NS_TEST_ASSERT_MSG_EQ (path.empty (), true, "path to an unreachable node");
+          continue;
+        }
+
+      reachable++;
+      NS_TEST_ASSERT_MSG_EQ_TOL (distance, shortest, 1e-6 * shortest + 1e-9, "route from " << from << " to " << to);
+      NS_TEST_ASSERT_MSG_EQ (path.front (), from, "path does not start at " << from);
+      NS_TEST_ASSERT_MSG_EQ (path.back (), to, "path does not end at " << to);
+      double length = GetPathLength (topology, path);
+      NS_TEST_ASSERT_MSG_GT_OR_EQ (length, 0, "unpacked path from " << from << " to " << to << " leaves the edges");
+      NS_TEST_ASSERT_MSG_EQ_TOL (length, distance, 1e-6 * distance + 1e-9, "unpacked path from " << from << " to " << to << " has another length");
+    }
+  NS_TEST_ASSERT_MSG_GT (reachable, 500, "too few reachable pairs to compare");
+}
+
+/*
+ * Patrol tours of a small graph and of a territory of the Cologne graph
+ * are closed walks covering every street reachable from the base, before
+ * and after streets close, open and are added, and survive a round trip
+ * through the tour file.
+ */
+class PatrolTourTestCase : public TestCase
 {
 public:
-  UrbanuavmobilityTestCase1 ();
-  virtual ~UrbanuavmobilityTestCase1 ();
+  PatrolTourTestCase ();
 
 private:
   virtual void DoRun (void);
+  void CheckTour (const GraphTopology& topology, const PatrolTour& tour);
+  void CheckFile (const GraphTopology& topology, const PatrolTour& tour);
+  void CheckChanges (Ptr<GraphData> data);
 };
 
-// Add some help text to this case to describe what it is intended to test
-UrbanuavmobilityTestCase1::UrbanuavmobilityTestCase1 ()
-  : TestCase ("Urbanuavmobility test case (does nothing)")
+PatrolTourTestCase::PatrolTourTestCase ()
+  : TestCase ("Patrol tours cover every street and follow changes")
+{
+}
+
+/*
+ * The tour is a closed walk over open edges, flown either way, that
+ * covers exactly the open streets connected to the base.
+ */
+void
+PatrolTourTestCase::CheckTour (const GraphTopology& topology, const PatrolTour& tour)
 {
+  std::vector<uint32_t> walk;
+  for (uint32_t i = 0; i < tour.getSize (); i++)
+    {
+      walk.push_back (tour.getNode (i));
+    }
+  walk.push_back (walk.empty () ? topology.getBase () : walk.front ());
+
+  std::vector<bool> flown (topology.getEdgeCount (), false);
+  double length = 0;
+  for (uint32_t i = 0; i + 1 < walk.size (); i++)
+    {
+      std::vector<uint32_t> step;
+      step.push_back (walk[i]);
+      step.push_back (walk[i + 1]);
+      double forward = GetPathLength (topology, step);
+      std::swap (step[0], step[1]);
+      double backward = GetPathLength (topology, step);
+      NS_TEST_ASSERT_MSG_EQ (forward >= 0 || backward >= 0, true, "step " << i << " of the tour is not an open street");
+      length += std::max (forward, backward);
+      uint32_t edge = topology.findEdge (walk[i], walk[i + 1]);
+      uint32_t reverse = topology.findEdge (walk[i + 1], walk[i]);
+      if (edge != GraphTopology::NONE)
+        {
+          flown[edge] = true;
+        }
+      if (reverse != GraphTopology::NONE)
+        {
+          flown[reverse] = true;
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ_TOL (tour.getLength (), length, 1e-6 * length + 1e-9, "wrong tour length");
+
+  // open streets connected to the base, either way
+  std::vector<bool> reached (topology.getNodeCount (), false);
+  std::vector<uint32_t> frontier (1, topology.getBase ());
+  reached[topology.getBase ()] = true;
+  for (uint32_t i = 0; i < frontier.size (); i++)
+    {
+      uint32_t node = frontier[i];
+      for (uint32_t e = topology.getFirstEdge (node); e < topology.getLastEdge (node); e++)
+        {
+          uint32_t next = topology.getEdgeTarget (e);
+          if (topology.isOpen (e) && !reached[next])
+            {
+              reached[next] = true;
+              frontier.push_back (next);
+            }
+        }
+      for (uint32_t n = 0; n < topology.getNodeCount (); n++)
+        {
+          uint32_t e = topology.findEdge (n, node);
+          if (e != GraphTopology::NONE && topology.isOpen (e) && !reached[n])
+            {
+              reached[n] = true;
+              frontier.push_back (n);
+            }
+        }
+    }
+  for (uint32_t e = 0; e < topology.getEdgeCount (); e++)
+    {
+      bool reachable = topology.isOpen (e) && reached[topology.getEdgeSource (e)];
+      NS_TEST_ASSERT_MSG_EQ (flown[e] || !reachable, true, "street of edge " << e << " not toured");
+      NS_TEST_ASSERT_MSG_EQ (reachable || !flown[e] || (topology.getReverseEdge (e) != GraphTopology::NONE && topology.isOpen (topology.getReverseEdge (e))), true,
+                             "edge " << e << " toured but not reachable");
+    }
 }
 
-// This destructor does nothing but we include it as a reminder that
-// the test case should clean up after itself
-UrbanuavmobilityTestCase1::~UrbanuavmobilityTestCase1 ()
+/* Saving and loading the tour gives back the same node sequence. */
+void
+PatrolTourTestCase::CheckFile (const GraphTopology& topology, const PatrolTour& tour)
 {
+  std::string file = CreateTempDirFilename ("saved.tour");
+  NS_TEST_ASSERT_MSG_EQ (tour.save (file, topology), true, "cannot save " << file);
+  PatrolTour loaded;
+  NS_TEST_ASSERT_MSG_EQ (loaded.load (file, topology), true, "cannot load " << file);
+  NS_TEST_ASSERT_MSG_EQ (loaded.getSize (), tour.getSize (), "tour size changed");
+  for (uint32_t i = 0; i < tour.getSize (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (loaded.getNode (i), tour.getNode (i), "node " << i << " of the tour changed");
+    }
+  NS_TEST_ASSERT_MSG_EQ_TOL (loaded.getLength (), tour.getLength (), 1e-6 * tour.getLength (), "tour length changed");
 }
 
-//
-// This method is the pure virtual method from class TestCase that every
-// TestCase must implement
-//
+/* Closes, opens and adds streets at random, checking the tour after each. */
 void
-UrbanuavmobilityTestCase1::DoRun (void)
+PatrolTourTestCase::CheckChanges (Ptr<GraphData> data)
+{
+  const GraphTopology& topology = data->getTopology ();
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (2);
+  for (int i = 0; i < 60; i++)
+    {
+      uint32_t edge = random->GetInteger (0, topology.getEdgeCount () - 1);
+      int change = random->GetInteger (0, 2);
+      if (change == 0)
+        {
+          data->closeEdge (edge);
+        }
+      else if (change == 1)
+        {
+          data->openEdge (edge);
+        }
+      else
+        {
+          AddChord (data, edge);
+        }
+      CheckTour (topology, data->getTour ());
+    }
+}
+
+void
+PatrolTourTestCase::DoRun (void)
+{
+  // a square with one diagonal, and a street apart from it
+  std::string file = CreateTempDirFilename ("square.xml");
+  FILE* out = fopen (file.c_str (), "w");
+  NS_TEST_ASSERT_MSG_NE (out, 0, "cannot write " << file);
+  fputs ("<graph>\n<nodes>\n"
+         "<node id='a' x='0' y='0' type='base' />\n"
+         "<node id='b' x='10' y='0' type='node' />\n"
+         "<node id='c' x='10' y='10' type='node' />\n"
+         "<node id='d' x='0' y='10' type='node' />\n"
+         "<node id='e' x='100' y='0' type='node' />\n"
+         "<node id='f' x='110' y='0' type='node' />\n"
+         "</nodes>\n<edges>\n"
+         "<edge from='a' to='b' />\n<edge from='b' to='a' />\n"
+         "<edge from='b' to='c' />\n<edge from='c' to='b' />\n"
+         "<edge from='c' to='d' />\n<edge from='d' to='c' />\n"
+         "<edge from='d' to='a' />\n<edge from='a' to='d' />\n"
+         "<edge from='a' to='c' />\n<edge from='c' to='a' />\n"
+         "<edge from='e' to='f' />\n<edge from='f' to='e' />\n"
+         "</edges>\n</graph>\n", out);
+  fclose (out);
+
+  Ptr<GraphData> square = GraphData::load (file);
+  NS_TEST_ASSERT_MSG_NE (square, 0, "cannot load " << file);
+  const GraphTopology& topology = square->getTopology ();
+  const PatrolTour& tour = square->getTour ();
+  CheckTour (topology, tour);
+  // the diagonal joins the two odd nodes and is flown twice
+  NS_TEST_ASSERT_MSG_EQ_TOL (tour.getLength (), 40 + 2 * std::sqrt (200.0), 1e-9, "tour of the square is not the shortest");
+  CheckFile (topology, tour);
+
+  uint32_t a = topology.find ("a");
+  uint32_t b = topology.find ("b");
+  uint32_t c = topology.find ("c");
+  uint32_t d = topology.find ("d");
+  uint32_t e = topology.find ("e");
+  NS_TEST_ASSERT_MSG_EQ (GraphData::load (file), square, "square not cached");
+  square->closeEdge (topology.findEdge (a, c));
+  // the changed square leaves the cache, loading the file again gives it unchanged
+  Ptr<GraphData> reloaded = GraphData::load (file);
+  NS_TEST_ASSERT_MSG_NE (reloaded, square, "changed square still cached");
+  NS_TEST_ASSERT_MSG_EQ (reloaded->getChangeCount (), 0, "reloaded square changed");
+  NS_TEST_ASSERT_MSG_EQ (reloaded->getTopology ().getClosedCount (), 0, "reloaded square has closed edges");
+  NS_TEST_ASSERT_MSG_EQ (GraphData::load (file), reloaded, "reloaded square not cached");
+  CheckTour (topology, square->getTour ());
+  // both crossings of the diagonal become detours round two sides
+  NS_TEST_ASSERT_MSG_EQ_TOL (square->getTour ().getLength (), 80, 1e-9, "the diagonal is not flown around");
+  square->closeEdge (topology.findEdge (b, a));
+  CheckTour (topology, square->getTour ());
+  square->openEdge (topology.findEdge (a, b));
+  CheckTour (topology, square->getTour ());
+  square->addEdge (b, d);
+  CheckTour (topology, square->getTour ());
+  // joins the street apart, which the tour must now cover
+  square->addEdge (c, e);
+  CheckTour (topology, square->getTour ());
+  NS_TEST_ASSERT_MSG_NE (square->getTour ().getPosition (e), GraphTopology::NONE, "joined street not toured");
+  CheckFile (topology, square->getTour ());
+
+  // a copy of a territory, which writes no tour file next to the graph
+  std::string territoryFile = std::string (COLOGNE_SUBGRAPHS) + "g1.xml";
+  Ptr<GraphData> territory = GraphData::load (territoryFile);
+  NS_TEST_ASSERT_MSG_NE (territory, 0, "cannot load " << territoryFile);
+  std::vector<uint32_t> nodes;
+  for (uint32_t n = 0; n < territory->getTopology ().getNodeCount (); n++)
+    {
+      nodes.push_back (n);
+    }
+  Ptr<GraphData> copy = territory->subgraph (nodes);
+  CheckTour (copy->getTopology (), copy->getTour ());
+  CheckFile (copy->getTopology (), copy->getTour ());
+  CheckChanges (copy);
+  CheckFile (copy->getTopology (), copy->getTour ());
+}
+
+/*
+ * The stationary distribution of a random walk and the hitting times of
+ * the idleness estimator on graphs where both are known exactly.
+ */
+class IdlenessEstimatorTestCase : public TestCase
+{
+public:
+  IdlenessEstimatorTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+IdlenessEstimatorTestCase::IdlenessEstimatorTestCase ()
+  : TestCase ("Idleness estimator on a house graph and a cycle")
 {
-  // A wide variety of test macros are available in src/core/test.h
-  NS_TEST_ASSERT_MSG_EQ (true, true, "true doesn't equal true for some reason");
-  // Use this one for floating point comparisons
-  NS_TEST_ASSERT_MSG_EQ_TOL (0.01, 0.01, 0.001, "Numbers are not equal within tolerance");
 }
 
-// The TestSuite class names the TestSuite, identifies what type of TestSuite,
-// and enables the TestCases to be run.  Typically, only the constructor for
-// this class must be defined
-//
+void
+IdlenessEstimatorTestCase::DoRun (void)
+{
+  double duration = 3600;
+  IdlenessEstimator estimator (10, 2, duration);
+
+  // a square with a roof, every street both ways, and a one way street
+  // into it from s: the walk from s ends up in the house, where it stays
+  // at each node in proportion to its degree
+  GraphTopology house;
+  const char* ids[6] = {"a", "b", "c", "d", "e", "s"};
+  for (int i = 0; i < 6; i++)
+    {
+      house.addNode (ids[i], i, i % 2);
+    }
+  const char* streets[6][2] = {{"a", "b"}, {"b", "c"}, {"c", "d"}, {"d", "a"}, {"c", "e"}, {"d", "e"}};
+  for (int i = 0; i < 6; i++)
+    {
+      house.addEdge (streets[i][0], streets[i][1]);
+      house.addEdge (streets[i][1], streets[i][0]);
+    }
+  house.addEdge ("s", "a");
+  house.finalize ();
+
+  std::vector<double> nodes;
+  uint32_t iterations = estimator.findStationary (house, house.find ("s"), nodes);
+  NS_TEST_ASSERT_MSG_GT (iterations, 1, "the walk from s is already stationary");
+  NS_TEST_ASSERT_MSG_EQ_TOL (nodes[house.find ("s")], 0, 1e-9, "the walk comes back to s");
+  for (int i = 0; i < 5; i++)
+    {
+      uint32_t node = house.find (ids[i]);
+      NS_TEST_ASSERT_MSG_EQ_TOL (nodes[node], house.getDegree (node) / 12.0, 1e-9, "node " << ids[i] << " not visited in proportion to its degree");
+    }
+
+  // on a cycle of n nodes the stationary walk next flies a given street
+  // after (n + 1)(n + 2) / 6 steps on average, counting that step
+  GraphTopology cycle;
+  uint32_t n = 10;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      std::ostringstream id;
+      id << i;
+      cycle.addNode (id.str (), std::cos (2 * M_PI * i / n), std::sin (2 * M_PI * i / n));
+    }
+  for (uint32_t i = 0; i < n; i++)
+    {
+      std::ostringstream from, to;
+      from << i;
+      to << (i + 1) % n;
+      cycle.addEdge (from.str (), to.str ());
+      cycle.addEdge (to.str (), from.str ());
+    }
+  cycle.finalize ();
+
+  std::vector<double> edges (cycle.getEdgeCount (), 1.0 / cycle.getEdgeCount ());
+  double hitting = (n + 1) * (n + 2) / 6.0;
+  double stepTime = 5;
+  double excursion = hitting * stepTime;
+  double longest = excursion * (std::log (duration / excursion) + 0.5772156649);
+  NS_TEST_ASSERT_MSG_EQ_TOL (estimator.getWorstExcursion (cycle, edges, stepTime), longest, 1e-6 * longest, "wrong hitting time of a street of the cycle");
+}
+
+/*
+ * Patrols without the simulator: arrival times and idleness on a triangle
+ * flown one way round, worked out from the timeline of
+ * GraphMobilityModel, and the same results from any number of threads.
+ */
+class PatrolEvaluatorTestCase : public TestCase
+{
+public:
+  PatrolEvaluatorTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PatrolEvaluatorTestCase::PatrolEvaluatorTestCase ()
+  : TestCase ("Patrol evaluator follows the mobility model timeline")
+{
+}
+
+/* Graph::stats() without the decision latencies, which are timings. */
+static std::string
+WithoutLatencies (std::string stats)
+{
+  size_t start;
+  while ((start = stats.find ("decision latency:")) != std::string::npos)
+    {
+      stats.erase (start, stats.find ("us;", start) + 3 - start);
+    }
+  return stats;
+}
+
+/* Value of a field of Graph::stats(), or -1 if it is not there. */
+static double
+GetStat (const std::string& stats, const std::string& name)
+{
+  size_t start = stats.find (name + ":");
+  return start != std::string::npos ? std::atof (stats.c_str () + start + name.size () + 1) : -1;
+}
+
+void
+PatrolEvaluatorTestCase::DoRun (void)
+{
+  // one way streets of 30, 40 and 50 m, so every node has one way on
+  std::string file = CreateTempDirFilename ("triangle.xml");
+  FILE* out = fopen (file.c_str (), "w");
+  NS_TEST_ASSERT_MSG_NE (out, 0, "cannot write " << file);
+  fputs ("<graph>\n<nodes>\n"
+         "<node id='a' x='0' y='0' type='base' />\n"
+         "<node id='b' x='30' y='0' type='node' />\n"
+         "<node id='c' x='30' y='40' type='node' />\n"
+         "</nodes>\n<edges>\n"
+         "<edge from='a' to='b' />\n<edge from='b' to='c' />\n<edge from='c' to='a' />\n"
+         "</edges>\n</graph>\n", out);
+  fclose (out);
+
+  // at 10 m/s with 2 s pauses, starting with one at a: a lap takes 18 s
+  // and the streets are reached at 5, 11 and 18 s, then 23, 29, 36, 41,
+  // 47, 54 and 59 s; the next arrival, at 65 s, is after the end
+  Graph graph ("random");
+  graph.load ((char*) file.c_str ());
+  PatrolEvaluator::patrol (graph, 10, 2, 60);
+  NS_TEST_ASSERT_MSG_EQ (graph.getEdgeVisitCount ("a", "b"), 4, "visits of a->b");
+  NS_TEST_ASSERT_MSG_EQ (graph.getEdgeVisitCount ("b", "c"), 3, "visits of b->c");
+  NS_TEST_ASSERT_MSG_EQ (graph.getEdgeVisitCount ("c", "a"), 3, "visits of c->a");
+  std::string stats = graph.stats ();
+  NS_TEST_ASSERT_MSG_NE (stats.find ("edge coverage timings:(a->b,5),(b->c,11),(c->a,18),;"), std::string::npos, "first arrivals in " << stats);
+  // the gaps of an edge add up to its last visit: (59 + 47 + 54) / 10
+  NS_TEST_ASSERT_MSG_EQ_TOL (GetStat (stats, "average idleness"), 16, 1e-9, "average idleness");
+  NS_TEST_ASSERT_MSG_EQ_TOL (GetStat (stats, "worst idleness"), 18, 1e-9, "worst idleness");
+
+  // an arrival at the end of the patrol still counts, one after it not
+  Graph ending ("random");
+  ending.load ((char*) file.c_str ());
+  PatrolEvaluator::patrol (ending, 10, 2, 59);
+  NS_TEST_ASSERT_MSG_EQ (ending.getEdgeVisitCount ("a", "b"), 4, "arrival at the end not counted");
+  Graph before ("random");
+  before.load ((char*) file.c_str ());
+  PatrolEvaluator::patrol (before, 10, 2, 58.5);
+  NS_TEST_ASSERT_MSG_EQ (before.getEdgeVisitCount ("a", "b"), 3, "arrival after the end counted");
+  // printed to six digits
+  NS_TEST_ASSERT_MSG_EQ_TOL (GetStat (before.stats (), "average idleness"), (41 + 47 + 54) / 9.0, 1e-4, "average idleness before the end");
+
+  // more runs than a batch of three threads, and a graph that is missing;
+  // the territories are copied since tours are written next to the graph
+  std::vector<std::string> copies;
+  for (int i = 0; i < 4; i++)
+    {
+      std::ostringstream name;
+      name << "g" << i << ".xml";
+      copies.push_back (CreateTempDirFilename (name.str ()));
+      NS_TEST_ASSERT_MSG_EQ (CopyFile (COLOGNE_SUBGRAPHS + name.str (), copies.back ()), true, "cannot copy " << name.str ());
+    }
+  const char* strategies[5] = {"random", "leastvisited", "globalleastvisited", "lookahead3", "tour"};
+  std::vector<PatrolRun> runs;
+  for (int i = 0; i < 15; i++)
+    {
+      PatrolRun run;
+      run.graphFile = copies[i % 4];
+      run.strategy = strategies[i % 5];
+      run.stream = i;
+      runs.push_back (run);
+    }
+  PatrolRun missing = runs[0];
+  missing.graphFile = CreateTempDirFilename ("missing.xml");
+  runs.push_back (missing);
+  std::vector<PatrolRun> threaded = runs;
+
+  PatrolEvaluator evaluator (10, 2, 3600);
+  evaluator.setThreads (1);
+  evaluator.evaluate (runs);
+  evaluator.setThreads (3);
+  evaluator.evaluate (threaded);
+  for (uint32_t i = 0; i < runs.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (WithoutLatencies (threaded[i].result), WithoutLatencies (runs[i].result), "run " << i << " differs on three threads");
+    }
+  NS_TEST_ASSERT_MSG_NE (runs[0].result, "", "run on " << runs[0].graphFile << " gave no result");
+  NS_TEST_ASSERT_MSG_EQ (runs.back ().result, "", "missing graph gave a result");
+}
+
+/*
+ * The graph cache on a copy of a territory: hits for an unchanged file,
+ * misses once its modification time or size changes, and a clean copy
+ * once the cached graph is changed.
+ */
+class GraphCacheTestCase : public TestCase
+{
+public:
+  GraphCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void CheckStats (double hits, double misses, const std::string& when);
+};
+
+GraphCacheTestCase::GraphCacheTestCase ()
+  : TestCase ("Graph cache follows file changes and graph changes")
+{
+}
+
+void
+GraphCacheTestCase::CheckStats (double hits, double misses, const std::string& when)
+{
+  std::string stats = GraphData::getCacheStats ();
+  NS_TEST_ASSERT_MSG_EQ (GetStat (stats, "graph cache hits"), hits, "hits " << when << " in " << stats);
+  NS_TEST_ASSERT_MSG_EQ (GetStat (stats, "misses"), misses, "misses " << when << " in " << stats);
+}
+
+void
+GraphCacheTestCase::DoRun (void)
+{
+  std::string file = CreateTempDirFilename ("cached.xml");
+  NS_TEST_ASSERT_MSG_EQ (CopyFile (std::string (COLOGNE_SUBGRAPHS) + "g5.xml", file), true, "cannot copy g5.xml");
+  GraphData::clearCache ();
+  CheckStats (0, 0, "after clearing");
+
+  Ptr<GraphData> loaded = GraphData::load (file);
+  NS_TEST_ASSERT_MSG_NE (loaded, 0, "cannot load " << file);
+  NS_TEST_ASSERT_MSG_EQ (GraphData::load (file), loaded, "unchanged file loaded again");
+  CheckStats (1, 1, "for an unchanged file");
+
+  // touched, then grown by a line with the time put back
+  struct stat info;
+  NS_TEST_ASSERT_MSG_EQ (stat (file.c_str (), &info), 0, "cannot stat " << file);
+  struct utimbuf times;
+  times.actime = info.st_atime;
+  times.modtime = info.st_mtime + 10;
+  NS_TEST_ASSERT_MSG_EQ (utime (file.c_str (), &times), 0, "cannot touch " << file);
+  Ptr<GraphData> touched = GraphData::load (file);
+  NS_TEST_ASSERT_MSG_NE (touched, 0, "cannot load " << file << " after touching it");
+  NS_TEST_ASSERT_MSG_NE (touched, loaded, "touched file not loaded again");
+  NS_TEST_ASSERT_MSG_EQ (GraphData::load (file), touched, "touched file loaded twice");
+  CheckStats (2, 2, "for a touched file");
+
+  FILE* out = fopen (file.c_str (), "a");
+  NS_TEST_ASSERT_MSG_NE (out, 0, "cannot append to " << file);
+  fputs ("\n", out);
+  fclose (out);
+  NS_TEST_ASSERT_MSG_EQ (utime (file.c_str (), &times), 0, "cannot touch " << file);
+  Ptr<GraphData> grown = GraphData::load (file);
+  NS_TEST_ASSERT_MSG_NE (grown, 0, "cannot load " << file << " after growing it");
+  NS_TEST_ASSERT_MSG_NE (grown, touched, "grown file not loaded again");
+  CheckStats (2, 3, "for a grown file");
+
+  // a changed graph leaves the cache, its holders keep the change
+  grown->closeEdge (0);
+  Ptr<GraphData> clean = GraphData::load (file);
+  NS_TEST_ASSERT_MSG_NE (clean, grown, "changed graph still cached");
+  NS_TEST_ASSERT_MSG_EQ (clean->getChangeCount (), 0, "loaded graph changed");
+  NS_TEST_ASSERT_MSG_EQ (clean->getTopology ().getClosedCount (), 0, "loaded graph has closed edges");
+  NS_TEST_ASSERT_MSG_EQ (grown->getTopology ().isOpen (0), false, "change lost");
+  NS_TEST_ASSERT_MSG_EQ (GraphData::load (file), clean, "clean copy loaded twice");
+  CheckStats (3, 4, "after a change");
+  NS_TEST_ASSERT_MSG_EQ (GetStat (GraphData::getCacheStats (), "graphs"), 1, "cached graphs");
+}
+
+/* Root of the part of node in a union find forest, halving the path. */
+static uint32_t
+FindPart (std::vector<uint32_t>& parts, uint32_t node)
+{
+  while (parts[node] != node)
+    {
+      parts[node] = parts[parts[node]];
+      node = parts[node];
+    }
+  return node;
+}
+
+/*
+ * Partitions the Cologne graph into territories and checks what write()
+ * promises: connected, balanced territories covering every street of the
+ * largest connected part once, saved as subgraphs and a fleet file that
+ * load back.
+ */
+class GraphPartitionerTestCase : public TestCase
+{
+public:
+  GraphPartitionerTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GraphPartitionerTestCase::GraphPartitionerTestCase ()
+  : TestCase ("Graph partitioner gives connected, balanced territories")
+{
+}
+
+void
+GraphPartitionerTestCase::DoRun (void)
+{
+  Ptr<GraphData> data = GraphData::load (COLOGNE_GRAPH);
+  NS_TEST_ASSERT_MSG_NE (data, 0, "cannot load " << COLOGNE_GRAPH);
+  const GraphTopology& topology = data->getTopology ();
+  uint32_t k = 22;
+  double imbalance = 0.03;
+  GraphPartitioner partitioner (data, 10, 2);
+  partitioner.setImbalance (imbalance);
+  partitioner.assignStreams (1);
+  NS_TEST_ASSERT_MSG_EQ (partitioner.partition (k), true, "partition failed");
+  NS_TEST_ASSERT_MSG_EQ (partitioner.getPartCount (), k, "wrong territory count");
+
+  // the largest connected part, either way along the edges
+  std::vector<uint32_t> parts (topology.getNodeCount ());
+  for (uint32_t n = 0; n < topology.getNodeCount (); n++)
+    {
+      parts[n] = n;
+    }
+  for (uint32_t e = 0; e < topology.getEdgeCount (); e++)
+    {
+      parts[FindPart (parts, topology.getEdgeSource (e))] = FindPart (parts, topology.getEdgeTarget (e));
+    }
+  std::vector<uint32_t> sizes (topology.getNodeCount (), 0);
+  for (uint32_t n = 0; n < topology.getNodeCount (); n++)
+    {
+      sizes[FindPart (parts, n)]++;
+    }
+  uint32_t largest = std::max_element (sizes.begin (), sizes.end ()) - sizes.begin ();
+
+  std::vector<uint32_t> ownedEdges (k, 0);
+  for (uint32_t e = 0; e < topology.getEdgeCount (); e++)
+    {
+      uint32_t owner = partitioner.getOwner (e);
+      if (FindPart (parts, topology.getEdgeSource (e)) != largest)
+        {
+          NS_TEST_ASSERT_MSG_EQ (owner, GraphTopology::NONE, "edge " << e << " outside the largest part has an owner");
+          continue;
+        }
+      NS_TEST_ASSERT_MSG_LT (owner, k, "edge " << e << " has no owner");
+      uint32_t reverse = topology.getReverseEdge (e);
+      if (reverse != GraphTopology::NONE)
+        {
+          NS_TEST_ASSERT_MSG_EQ (partitioner.getOwner (reverse), owner, "the two edges of street " << e << " have different owners");
+        }
+      ownedEdges[owner]++;
+    }
+
+  // every territory connected over its own streets, either way
+  double total = 0;
+  double heaviest = 0;
+  for (uint32_t t = 0; t < k; t++)
+    {
+      for (uint32_t n = 0; n < topology.getNodeCount (); n++)
+        {
+          parts[n] = n;
+        }
+      for (uint32_t e = 0; e < topology.getEdgeCount (); e++)
+        {
+          if (partitioner.getOwner (e) == t)
+            {
+              parts[FindPart (parts, topology.getEdgeSource (e))] = FindPart (parts, topology.getEdgeTarget (e));
+            }
+        }
+      uint32_t base = FindPart (parts, partitioner.getBase (t));
+      for (uint32_t e = 0; e < topology.getEdgeCount (); e++)
+        {
+          if (partitioner.getOwner (e) == t)
+            {
+              NS_TEST_ASSERT_MSG_EQ (FindPart (parts, topology.getEdgeSource (e)), base, "territory " << t << " is not connected at edge " << e);
+            }
+        }
+      NS_TEST_ASSERT_MSG_GT (ownedEdges[t], 0, "territory " << t << " has no streets");
+      total += partitioner.getLoadTime (t);
+      heaviest = std::max (heaviest, partitioner.getLoadTime (t));
+    }
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (heaviest / (total / k), 1 + imbalance + 1e-9, "territories out of balance");
+
+  std::string directory = CreateTempDirFilename ("partition");
+  SystemPath::MakeDirectories (directory);
+  NS_TEST_ASSERT_MSG_EQ (partitioner.write (directory, false), true, "cannot write " << directory);
+  for (uint32_t t = 0; t < k; t++)
+    {
+      std::ostringstream file;
+      file << directory << "/g" << t << ".xml";
+      Ptr<GraphData> territory = GraphData::load (file.str ());
+      NS_TEST_ASSERT_MSG_NE (territory, 0, "cannot load " << file.str ());
+      NS_TEST_ASSERT_MSG_EQ (territory->getTopology ().getEdgeCount (), ownedEdges[t], file.str () << " has other edges");
+      uint32_t base = territory->getTopology ().getBase ();
+      NS_TEST_ASSERT_MSG_NE (base, GraphTopology::NONE, file.str () << " has no base");
+      NS_TEST_ASSERT_MSG_EQ (territory->getTopology ().getId (base), topology.getId (partitioner.getBase (t)), file.str () << " has another base");
+    }
+
+  FleetHelper fleet;
+  fleet.SetSharedVisits (true);
+  fleet.SetTerritories (COLOGNE_GRAPH, 1);
+  NS_TEST_ASSERT_MSG_EQ (fleet.Install (directory + "/fleet.xml"), true, "cannot install the fleet");
+  NS_TEST_ASSERT_MSG_EQ (fleet.GetUavs ().size (), k, "wrong UAV count");
+  NS_TEST_ASSERT_MSG_EQ (fleet.GetBases ().size (), k, "wrong base count");
+  NS_TEST_ASSERT_MSG_EQ (fleet.GetTerritories ()->getTerritoryCount (), k, "wrong territory count");
+  for (uint32_t t = 0; t < k; t++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (fleet.GetTerritories ()->getEdgeCount (t), ownedEdges[t], "territory " << t << " of the fleet has other edges");
+    }
+  Simulator::Destroy ();
+}
+
+/*
+ * Streets closed, opened and added on a copy of the Cologne graph: the
+ * distance fields kept up to date match fields built again, and the visit
+ * statistics of Graphs, the counts of their blackboard and the owners of
+ * a territory map stay with the same streets as the handles move. Routes
+ * use A* from an addition until the hierarchy is rebuilt.
+ */
+class GraphChangesTestCase : public TestCase
+{
+public:
+  GraphChangesTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void CheckFields (Ptr<GraphData> data, const std::vector<uint32_t>& targets);
+  void CheckRoutes (Ptr<GraphData> data, Graph& graph, Ptr<UniformRandomVariable> random);
+
+  // per edge of the graph before the changes, by the ids of its nodes
+  std::vector<std::string> m_from;
+  std::vector<std::string> m_to;
+  std::vector<int> m_counts;
+  std::vector<int> m_boardCounts;
+  std::vector<uint32_t> m_owners;
+  std::vector<uint32_t> m_homes;
+};
+
+GraphChangesTestCase::GraphChangesTestCase ()
+  : TestCase ("Graph changes follow into distances, visits and territories")
+{
+}
+
+void
+GraphChangesTestCase::CheckFields (Ptr<GraphData> data, const std::vector<uint32_t>& targets)
+{
+  const GraphTopology& topology = data->getTopology ();
+  for (uint32_t i = 0; i < targets.size (); i++)
+    {
+      const DistanceField& field = data->getDistanceField (targets[i]);
+      DistanceField built;
+      built.build (topology, targets[i]);
+      for (uint32_t n = 0; n < topology.getNodeCount (); n++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (field.isReachable (n), built.isReachable (n), "reachability of " << n << " from " << targets[i]);
+          if (built.isReachable (n))
+            {
+              NS_TEST_ASSERT_MSG_EQ_TOL (field.getDistance (n), built.getDistance (n), 1e-6, "distance from " << n << " to " << targets[i]);
+            }
+        }
+    }
+}
+
+/* Routes of the Graph are as short as A* over the topology. */
+void
+GraphChangesTestCase::CheckRoutes (Ptr<GraphData> data, Graph& graph, Ptr<UniformRandomVariable> random)
+{
+  const GraphTopology& topology = data->getTopology ();
+  Router router;
+  std::vector<uint32_t> path;
+  std::vector<uint32_t> expected;
+  for (int i = 0; i < 50; i++)
+    {
+      uint32_t from = random->GetInteger (0, topology.getNodeCount () - 1);
+      uint32_t to = random->GetInteger (0, topology.getNodeCount () - 1);
+      double distance = router.route (topology, from, to, expected);
+      double length = graph.route (from, to, path);
+      if (std::isinf (distance))
+        {
+          NS_TEST_ASSERT_MSG_EQ (std::isinf (length), true, "route from " << from << " to " << to << " through closed streets");
+          continue;
+        }
+      NS_TEST_ASSERT_MSG_EQ_TOL (length, distance, 1e-6, "route from " << from << " to " << to << " is not the shortest");
+      NS_TEST_ASSERT_MSG_EQ_TOL (GetPathLength (topology, path), distance, 1e-6, "path from " << from << " to " << to << " broken");
+    }
+}
+
+void
+GraphChangesTestCase::DoRun (void)
+{
+  // a copy, so the changes stay out of the other tests
+  Ptr<GraphData> cologne = GraphData::load (COLOGNE_GRAPH);
+  NS_TEST_ASSERT_MSG_NE (cologne, 0, "cannot load " << COLOGNE_GRAPH);
+  std::vector<uint32_t> nodes;
+  for (uint32_t n = 0; n < cologne->getTopology ().getNodeCount (); n++)
+    {
+      nodes.push_back (n);
+    }
+  Ptr<GraphData> data = cologne->subgraph (nodes);
+  const GraphTopology& topology = data->getTopology ();
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (3);
+  std::vector<uint32_t> targets;
+  targets.push_back (topology.getBase ());
+  for (int i = 0; i < 3; i++)
+    {
+      targets.push_back (random->GetInteger (0, topology.getNodeCount () - 1));
+    }
+  CheckFields (data, targets);
+
+  Ptr<VisitBlackboard> board = Create<VisitBlackboard> (data);
+  Ptr<TerritoryMap> map = Create<TerritoryMap> (data);
+  const char* territories[3] = {"g221.xml", "g64.xml", "g66.xml"};
+  for (int i = 0; i < 3; i++)
+    {
+      std::string file = std::string (COLOGNE_SUBGRAPHS) + territories[i];
+      Ptr<GraphData> subgraph = GraphData::load (file);
+      NS_TEST_ASSERT_MSG_NE (subgraph, 0, "cannot load " << file);
+      map->addTerritory (subgraph);
+    }
+  // an absent territory, so some streets are lent away from home
+  map->setLendingDepth (2);
+  map->setPresent (1, false);
+
+  Graph lookahead ("lookahead");
+  Graph global ("globalleastvisited");
+  lookahead.load (data);
+  global.load (data);
+  lookahead.assignStreams (4);
+  global.assignStreams (5);
+  NS_TEST_ASSERT_MSG_EQ (lookahead.shareVisits (board), true, "cannot share visits");
+  NS_TEST_ASSERT_MSG_EQ (global.shareVisits (board), true, "cannot share visits");
+  lookahead.prepareRoutes ();
+  for (uint32_t e = 0; e < topology.getEdgeCount (); e++)
+    {
+      std::string from = topology.getId (topology.getEdgeSource (e));
+      std::string to = topology.getId (topology.getEdgeTarget (e));
+      if (e % 3 == 0)
+        {
+          lookahead.markEdge (from, to, e, e % 7 + 1);
+        }
+      if (e % 5 == 0)
+        {
+          global.markEdge (topology.getEdgeSource (e), topology.getEdgeTarget (e), e);
+        }
+    }
+  for (uint32_t e = 0; e < topology.getEdgeCount (); e++)
+    {
+      m_from.push_back (topology.getId (topology.getEdgeSource (e)));
+      m_to.push_back (topology.getId (topology.getEdgeTarget (e)));
+      m_counts.push_back (lookahead.getEdgeVisitCount (m_from[e], m_to[e]));
+      m_boardCounts.push_back (board->getCount (e));
+      m_owners.push_back (map->getOwner (e));
+      m_homes.push_back (map->getHome (e));
+    }
+
+  for (int round = 0; round < 2; round++)
+    {
+      // several additions before the Graphs next look at the data
+      for (int i = 0; i < 30; i++)
+        {
+          uint32_t edge = random->GetInteger (0, topology.getEdgeCount () - 1);
+          int change = random->GetInteger (0, 2);
+          if (change == 0)
+            {
+              data->closeEdge (edge);
+            }
+          else if (change == 1)
+            {
+              data->openEdge (edge);
+            }
+          else
+            {
+              AddChord (data, edge);
+            }
+          CheckFields (data, targets);
+        }
+
+      board->update ();
+      map->update ();
+      for (uint32_t e = 0; e < m_from.size (); e++)
+        {
+          uint32_t edge = topology.findEdge (topology.find (m_from[e]), topology.find (m_to[e]));
+          NS_TEST_ASSERT_MSG_NE (edge, GraphTopology::NONE, "edge " << m_from[e] << "->" << m_to[e] << " lost");
+          NS_TEST_ASSERT_MSG_EQ (lookahead.getEdgeVisitCount (m_from[e], m_to[e]), m_counts[e], "visits of " << m_from[e] << "->" << m_to[e] << " moved");
+          NS_TEST_ASSERT_MSG_EQ (board->getCount (edge), m_boardCounts[e], "blackboard count of " << m_from[e] << "->" << m_to[e] << " moved");
+          NS_TEST_ASSERT_MSG_EQ (map->getOwner (edge), m_owners[e], "owner of " << m_from[e] << "->" << m_to[e] << " moved");
+          NS_TEST_ASSERT_MSG_EQ (map->getHome (edge), m_homes[e], "home of " << m_from[e] << "->" << m_to[e] << " moved");
+        }
+
+      NS_TEST_ASSERT_MSG_EQ (data->isHierarchyCurrent (), false, "hierarchy current after additions");
+      CheckRoutes (data, lookahead, random);
+      data->rebuildHierarchy ();
+      NS_TEST_ASSERT_MSG_EQ (data->isHierarchyCurrent (), true, "hierarchy not rebuilt");
+      CheckRoutes (data, lookahead, random);
+    }
+
+  // the strategies walk on over open streets only
+  Graph* graphs[2] = {&lookahead, &global};
+  for (int g = 0; g < 2; g++)
+    {
+      uint32_t node = graphs[g]->getRoot ().getIndex ();
+      for (int i = 0; i < 500; i++)
+        {
+          uint32_t next = graphs[g]->next (node);
+          if (next != node)
+            {
+              uint32_t edge = topology.findEdge (node, next);
+              NS_TEST_ASSERT_MSG_EQ (edge != GraphTopology::NONE && topology.isOpen (edge), true, "walked from " << node << " to " << next << " off the open streets");
+              graphs[g]->markEdge (node, next, 100000 + i);
+            }
+          node = next;
+        }
+    }
+}
+
 class UrbanuavmobilityTestSuite : public TestSuite
 {
 public:
@@ -59,10 +2322,25 @@ public:
 UrbanuavmobilityTestSuite::UrbanuavmobilityTestSuite ()
   : TestSuite ("urbanuavmobility", UNIT)
 {
-  // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
-  AddTestCase (new UrbanuavmobilityTestCase1, TestCase::QUICK);
+  AddTestCase (new GraphTopologyTestCase, TestCase::QUICK);
+  AddTestCase (new GraphFileTestCase, TestCase::QUICK);
+  AddTestCase (new NearestNodeTestCase, TestCase::QUICK);
+  AddTestCase (new EdgeGridTestCase, TestCase::QUICK);
+  AddTestCase (new SubgraphTestCase, TestCase::QUICK);
+  AddTestCase (new CoverageGridTestCase, TestCase::QUICK);
+  AddTestCase (new TerritoryMapTestCase, TestCase::QUICK);
+  AddTestCase (new TerritoryHandoverTestCase, TestCase::QUICK);
+  AddTestCase (new ContractionHierarchyTestCase, TestCase::QUICK);
+  AddTestCase (new PatrolTourTestCase, TestCase::QUICK);
+  AddTestCase (new IdlenessEstimatorTestCase, TestCase::QUICK);
+  AddTestCase (new PatrolEvaluatorTestCase, TestCase::QUICK);
+  AddTestCase (new GraphCacheTestCase, TestCase::QUICK);
+  AddTestCase (new GraphPartitionerTestCase, TestCase::QUICK);
+  AddTestCase (new GraphChangesTestCase, TestCase::QUICK);
+  AddTestCase (new VisitBlackboardTestCase, TestCase::QUICK);
+  AddTestCase (new GlobalLeastVisitedTestCase, TestCase::QUICK);
+  AddTestCase (new LookaheadSelectionTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
 static UrbanuavmobilityTestSuite urbanuavmobilityTestSuite;
-